@@ -182,10 +182,15 @@ def _check_mutex_args(parser, args, required=False):
             ", ".join(name for name, _ in args))
 
 
+# Binary task files written with --write-binary-task start with this magic.
+BINARY_TASK_MAGIC = b"\x7fFDTASK\0"
+
+
 def _looks_like_search_input(filename):
-    with open(filename) as input_file:
-        first_line = next(input_file, "").rstrip()
-    return first_line == "begin_version"
+    with open(filename, "rb") as input_file:
+        first_line = next(input_file, b"")
+    return (first_line.startswith(BINARY_TASK_MAGIC) or
+            first_line.rstrip() == b"begin_version")
 
 
 def _set_components_automatically(parser, args):
@@ -0,0 +1,200 @@
+#! /usr/bin/env python3
+
+"""
+Check that binary task files written with --write-binary-task describe the
+same task as the translator output they were written from, and that
+searching on them gives the same result.
+"""
+
+import os
+import re
+import struct
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+TASKS = [
+    "gripper/prob01.pddl",
+    # Tests that derived variables keep their default values.
+    "philosophers/p01-phil2.pddl",
+    "miconic-simpleadl/s1-0.pddl",
+]
+SEARCH = "astar(blind())"
+
+BINARY_MAGIC = b"\x7fFDTASK\0"
+
+
+def translate(task, sas_file):
+    subprocess.check_call([
+        sys.executable, FAST_DOWNWARD, "--sas-file", sas_file,
+        "--translate", os.path.join(BENCHMARKS_DIR, task)])
+
+
+def run_search(task_file, cwd, *options):
+    return subprocess.check_output(
+        [sys.executable, FAST_DOWNWARD, task_file, "--search-options"] +
+        list(options), cwd=cwd, universal_newlines=True)
+
+
+def get_search_result(output):
+    cost = re.search(r"Plan cost: (\d+)", output).group(1)
+    expansions = re.search(r"Expanded (\d+) state\(s\)\.", output).group(1)
+    return int(cost), int(expansions)
+
+
+def read_sas_task(filename):
+    with open(filename) as f:
+        lines = [line.rstrip("\n") for line in f]
+    lines.reverse()
+
+    def next_line():
+        return lines.pop()
+
+    def skip(magic):
+        line = next_line()
+        assert line == magic, (line, magic)
+
+    def read_int():
+        return int(next_line())
+
+    def read_facts(begin, end):
+        skip(begin)
+        facts = [tuple(map(int, next_line().split()))
+                 for _ in range(read_int())]
+        skip(end)
+        return facts
+
+    skip("begin_version")
+    next_line()
+    skip("end_version")
+    skip("begin_metric")
+    next_line()
+    skip("end_metric")
+
+    variables = []
+    for _ in range(read_int()):
+        skip("begin_variable")
+        name = next_line()
+        axiom_layer = read_int()
+        fact_names = [next_line() for _ in range(read_int())]
+        skip("end_variable")
+        variables.append((name, axiom_layer, fact_names))
+
+    for _ in range(read_int()):
+        skip("begin_mutex_group")
+        for _ in range(read_int()):
+            next_line()
+        skip("end_mutex_group")
+
+    skip("begin_state")
+    initial_state = [read_int() for _ in variables]
+    skip("end_state")
+    goals = read_facts("begin_goal", "end_goal")
+    hard_goals = read_facts("begin_hard_goal", "end_hard_goal")
+    soft_goals = read_facts("begin_soft_goal", "end_soft_goal")
+    assert read_int() == 0, "relaxed task definitions are not compared"
+
+    operators = []
+    for _ in range(read_int()):
+        skip("begin_operator")
+        name = next_line()
+        for _ in range(read_int()):
+            next_line()
+        for _ in range(read_int()):
+            next_line()
+        cost = read_int()
+        skip("end_operator")
+        operators.append((name, cost))
+
+    num_axioms = read_int()
+    return (variables, initial_state, goals, hard_goals, soft_goals,
+            operators, num_axioms)
+
+
+def read_binary_task(filename):
+    with open(filename, "rb") as f:
+        data = f.read()
+    assert data.startswith(BINARY_MAGIC)
+    pos = len(BINARY_MAGIC)
+
+    def read_int():
+        nonlocal pos
+        value, = struct.unpack_from("i", data, pos)
+        pos += 4
+        return value
+
+    def read_string():
+        nonlocal pos
+        length = read_int()
+        string = data[pos:pos + length].decode()
+        pos += (length + 3) // 4 * 4
+        return string
+
+    def read_numbers():
+        return [read_int() for _ in range(read_int())]
+
+    def read_facts():
+        return [(read_int(), read_int()) for _ in range(read_int())]
+
+    read_int()  # byte order mark
+    read_int()  # version
+
+    variables = []
+    for _ in range(read_int()):
+        name = read_string()
+        axiom_layer = read_int()
+        fact_names = [read_string() for _ in range(read_int())]
+        variables.append((name, axiom_layer, fact_names))
+
+    for _, _, fact_names in variables:
+        for _ in fact_names:
+            read_facts()
+
+    initial_state = read_numbers()
+    goals = read_facts()
+    hard_goals = read_facts()
+    soft_goals = read_facts()
+    assert read_int() == 0, "relaxed task definitions are not compared"
+
+    operators = []
+    for _ in range(read_int()):
+        name = read_string()
+        cost = read_int()
+        read_facts()
+        for _ in range(read_int()):
+            read_int()
+            read_int()
+            read_facts()
+        operators.append((name, cost))
+
+    num_axioms = read_int()
+    return (variables, initial_state, goals, hard_goals, soft_goals,
+            operators, num_axioms)
+
+
+@pytest.mark.parametrize("task", TASKS)
+def test_binary_task_round_trip(task, tmp_path):
+    sas_file = str(tmp_path / "output.sas")
+    binary_file = str(tmp_path / "task.bin")
+    rewritten_binary_file = str(tmp_path / "task2.bin")
+    translate(task, sas_file)
+    run_search(sas_file, str(tmp_path), "--write-binary-task", binary_file)
+    run_search(binary_file, str(tmp_path),
+               "--write-binary-task", rewritten_binary_file)
+
+    # The initial state must be stored before evaluating the axioms.
+    assert read_binary_task(binary_file) == read_sas_task(sas_file)
+    with open(binary_file, "rb") as f1, open(rewritten_binary_file, "rb") as f2:
+        assert f1.read() == f2.read()
+
+    sas_result = get_search_result(
+        run_search(sas_file, str(tmp_path), "--search", SEARCH))
+    binary_result = get_search_result(
+        run_search(binary_file, str(tmp_path), "--search", SEARCH))
+    assert sas_result == binary_result
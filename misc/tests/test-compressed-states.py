@@ -0,0 +1,61 @@
+#! /usr/bin/env python3
+
+"""
+Check that storing registered states with compress_states=true gives the
+same search results as the uncompressed state storage.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+TASKS = [
+    "gripper/prob01.pddl",
+    # Tests that derived variables are restored correctly.
+    "philosophers/p01-phil2.pddl",
+    "miconic-simpleadl/s1-0.pddl",
+]
+SEARCHES = [
+    "astar(blind(){})",
+    "lazy_greedy([ff()]{})",
+    "astar(add(){})",
+]
+
+
+def translate(task, sas_file):
+    subprocess.check_call([
+        sys.executable, FAST_DOWNWARD, "--sas-file", sas_file,
+        "--translate", os.path.join(BENCHMARKS_DIR, task)])
+
+
+def run_search(sas_file, cwd, search):
+    output = subprocess.check_output(
+        [sys.executable, FAST_DOWNWARD, sas_file, "--search", search],
+        cwd=cwd, universal_newlines=True)
+    with open(os.path.join(cwd, "sas_plan")) as f:
+        plan = f.read()
+    counts = [int(re.search(pattern, output).group(1)) for pattern in [
+        r"Expanded (\d+) state\(s\)\.",
+        r"Generated (\d+) state\(s\)\.",
+        r"Number of registered states: (\d+)"]]
+    return plan, counts
+
+
+@pytest.mark.parametrize("task", TASKS)
+@pytest.mark.parametrize("search", SEARCHES)
+def test_compressed_states(task, search, tmp_path):
+    sas_file = str(tmp_path / "output.sas")
+    translate(task, sas_file)
+    cwd = str(tmp_path)
+    plain_result = run_search(sas_file, cwd, search.format(""))
+    compressed_result = run_search(
+        sas_file, cwd, search.format(", compress_states=true"))
+    assert compressed_result == plain_result
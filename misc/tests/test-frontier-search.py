@@ -0,0 +1,74 @@
+#! /usr/bin/env python3
+
+"""
+Check that gsastar computes the same MSGS with and without frontier search.
+"""
+
+import json
+import os
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+sys.path.insert(0, REPO)
+from driver import returncodes
+
+TASK = "gripper/prob01.pddl"
+SEARCH = ("gsastar(evals=[blind()], eval=ngs(blind()), bound={bound}, "
+          "frontier_search={frontier_search}, f={msgs_file}{extra})")
+
+# Search exit code if the search ends without a plan, e.g. in frontier mode.
+SEARCH_FINISHED = 13
+
+CASES = [
+    # Exhaustive search of all states below the bound.
+    (8, "", returncodes.SEARCH_UNSOLVED_INCOMPLETE),
+    # The search ends when a goal state is expanded.
+    (20, "", None),
+    (8, ", symmetries=structural_symmetries()",
+     returncodes.SEARCH_UNSOLVED_INCOMPLETE),
+]
+
+
+def translate(task, sas_file):
+    subprocess.check_call([
+        sys.executable, FAST_DOWNWARD, "--sas-file", sas_file,
+        "--translate", os.path.join(BENCHMARKS_DIR, task)])
+
+
+def compute_msgs(sas_file, cwd, bound, extra, frontier_search):
+    msgs_file = "msgs-{}.json".format(frontier_search)
+    search = SEARCH.format(
+        bound=bound, frontier_search=frontier_search, msgs_file=msgs_file,
+        extra=extra)
+    exitcode = subprocess.call(
+        [sys.executable, FAST_DOWNWARD, sas_file, "--search", search],
+        cwd=cwd)
+    with open(os.path.join(cwd, msgs_file)) as f:
+        msgs = json.load(f)
+    return exitcode, {
+        key: sorted(sorted(goal_subset) for goal_subset in goal_subsets)
+        for key, goal_subsets in msgs.items()}
+
+
+@pytest.mark.parametrize("bound, extra, exitcode", CASES)
+def test_frontier_search(bound, extra, exitcode, tmp_path):
+    sas_file = str(tmp_path / "output.sas")
+    translate(TASK, sas_file)
+    normal_exitcode, normal_msgs = compute_msgs(
+        sas_file, str(tmp_path), bound, extra, "false")
+    frontier_exitcode, frontier_msgs = compute_msgs(
+        sas_file, str(tmp_path), bound, extra, "true")
+    assert frontier_msgs == normal_msgs
+    if exitcode is None:
+        # Normal mode extracts a plan, frontier mode cannot.
+        assert normal_exitcode == returncodes.SUCCESS
+        assert frontier_exitcode == SEARCH_FINISHED
+    else:
+        assert normal_exitcode == frontier_exitcode == exitcode
@@ -0,0 +1,83 @@
+#! /usr/bin/env python3
+
+"""
+Check merge-and-shrink transition systems through the heuristics they
+induce. Label reductions, pruning and shrinking compact the transition
+buffers in place, so lost or duplicated transitions change the heuristic.
+Without size limits, bisimulation shrinking is exact and h(init) must be
+the optimal plan cost for tasks without conditional effects. With size
+limits, the heuristic must stay admissible and A* must still find an
+optimal plan.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+# Tasks and whether exact bisimulation yields the perfect heuristic. With
+# conditional effects, the atomic transition systems are nondeterministic.
+TASKS = [
+    ("gripper/prob01.pddl", True),
+    ("miconic/s1-0.pddl", True),
+    ("miconic-simpleadl/s1-0.pddl", False),
+]
+
+MERGE_STRATEGY = (
+    "merge_sccs(order_of_sccs=topological,"
+    "merge_selector=score_based_filtering("
+    "scoring_functions=[goal_relevance,dfp,total_order]))")
+EXACT_MAS = (
+    "merge_and_shrink(shrink_strategy=shrink_bisimulation(greedy=false),"
+    "merge_strategy={merge},"
+    "label_reduction=exact(before_shrinking=true,before_merging=true),"
+    "max_states=infinity,threshold_before_merge=1)".format(
+        merge=MERGE_STRATEGY))
+LIMITED_MAS = (
+    "merge_and_shrink(shrink_strategy=shrink_bisimulation(greedy=true),"
+    "merge_strategy={merge},"
+    "label_reduction=exact(before_shrinking=true,before_merging=false),"
+    "max_states=20,threshold_before_merge=1)".format(
+        merge=MERGE_STRATEGY))
+
+
+def translate(task, sas_file):
+    subprocess.check_call([
+        sys.executable, FAST_DOWNWARD, "--sas-file", sas_file,
+        "--translate", os.path.join(BENCHMARKS_DIR, task)])
+
+
+def run_astar(sas_file, cwd, evaluator):
+    output = subprocess.check_output(
+        [sys.executable, FAST_DOWNWARD, sas_file,
+         "--search", "astar({})".format(evaluator)],
+        cwd=cwd, universal_newlines=True)
+    cost = int(re.search(r"Plan cost: (\d+)", output).group(1))
+    match = re.search(r"Initial heuristic value for .*: (\d+)", output)
+    return cost, int(match.group(1))
+
+
+@pytest.mark.parametrize("task, perfect", TASKS)
+def test_merge_and_shrink_heuristic(task, perfect, tmp_path):
+    sas_file = str(tmp_path / "output.sas")
+    translate(task, sas_file)
+    cwd = str(tmp_path)
+    optimal_cost, _ = run_astar(sas_file, cwd, "blind()")
+
+    cost, initial_h = run_astar(sas_file, cwd, EXACT_MAS)
+    assert cost == optimal_cost
+    if perfect:
+        assert initial_h == optimal_cost
+    else:
+        assert initial_h <= optimal_cost
+
+    cost, initial_h = run_astar(sas_file, cwd, LIMITED_MAS)
+    assert cost == optimal_cost
+    assert initial_h <= optimal_cost
@@ -0,0 +1,94 @@
+#! /usr/bin/env python3
+
+"""
+Check that warm-starting the LPs of operatorcounting() does not change the
+search. The task is large enough that bases are evicted from the warm-start
+cache, and in the iterated search, the same heuristic is used with the state
+registries of several searches, whose state IDs overlap.
+"""
+
+import os
+import re
+import subprocess
+import sys
+
+import pytest
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO, "misc", "tests", "benchmarks")
+FAST_DOWNWARD = os.path.join(REPO, "fast-downward.py")
+
+# Must be larger than the warm-start cache (1024 entries).
+MIN_EVALUATIONS = 1024
+NUM_BALLS = 7
+
+HEURISTIC = ("operatorcounting([state_equation_constraints()], "
+             "use_warm_starts={use_warm_starts})")
+CONFIGS = [
+    ["--search", "astar(h)"],
+    ["--search", "iterated([astar(h), astar(h)], pass_bound=false, "
+     "continue_on_solve=true)"],
+]
+
+
+def write_gripper_problem(filename, num_balls):
+    balls = ["ball{}".format(i) for i in range(1, num_balls + 1)]
+    with open(filename, "w") as f:
+        f.write("(define (problem gripper-{})\n".format(num_balls))
+        f.write("  (:domain gripper-strips)\n")
+        f.write("  (:objects rooma roomb left right {})\n".format(
+            " ".join(balls)))
+        f.write("  (:init (room rooma) (room roomb) (at-robby rooma)\n")
+        f.write("         (free left) (free right)\n")
+        f.write("         (gripper left) (gripper right)\n")
+        for ball in balls:
+            f.write("         (ball {0}) (at {0} rooma)\n".format(ball))
+        f.write("  )\n")
+        f.write("  (:goal (and {})))\n".format(
+            " ".join("(at {} roomb)".format(ball) for ball in balls)))
+
+
+def translate(problem_file, sas_file):
+    subprocess.check_call([
+        sys.executable, FAST_DOWNWARD, "--sas-file", sas_file,
+        "--translate", os.path.join(BENCHMARKS_DIR, "gripper", "domain.pddl"),
+        problem_file])
+
+
+def run_search(sas_file, cwd, config, use_warm_starts):
+    heuristic = HEURISTIC.format(use_warm_starts=use_warm_starts)
+    process = subprocess.Popen(
+        [sys.executable, FAST_DOWNWARD, sas_file,
+         "--evaluator", "h={}".format(heuristic)] + config,
+        cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+        universal_newlines=True)
+    output, _ = process.communicate()
+    if "compiled without LP support" in output:
+        pytest.skip("planner was compiled without LP support")
+    assert process.returncode == 0, output
+    return output
+
+
+def get_search_result(output):
+    return (
+        [int(cost) for cost in re.findall(r"Plan cost: (\d+)", output)],
+        [int(h) for h in re.findall(
+            r"Initial heuristic value for .*: (\d+)", output)],
+        [int(n) for n in re.findall(r"Expanded (\d+) state\(s\)\.", output)],
+        [int(n) for n in re.findall(r"Evaluated (\d+) state\(s\)\.", output)])
+
+
+@pytest.mark.parametrize("config", CONFIGS)
+def test_warm_starts(config, tmp_path):
+    problem_file = str(tmp_path / "problem.pddl")
+    sas_file = str(tmp_path / "output.sas")
+    write_gripper_problem(problem_file, NUM_BALLS)
+    translate(problem_file, sas_file)
+    cwd = str(tmp_path)
+    result = get_search_result(run_search(sas_file, cwd, config, "false"))
+    warm_start_result = get_search_result(
+        run_search(sas_file, cwd, config, "true"))
+    assert warm_start_result == result
+    _, _, _, evaluations = result
+    assert evaluations[0] > MIN_EVALUATIONS
@@ -51,7 +51,9 @@ fast_downward_plugin(
         abstract_task
         axioms
         command_line
+        compressed_state_storage
         evaluation_context
+        evaluation_pipeline
         evaluation_result
         evaluator
         evaluator_cache
@@ -116,12 +118,14 @@ fast_downward_plugin(
         utils/markup
         utils/math
         utils/memory
+        utils/parallel
         utils/rng
         utils/rng_options
         utils/strings
         utils/system
         utils/system_unix
         utils/system_windows
+        utils/telemetry
         utils/timer
     CORE_PLUGIN
 )
@@ -360,6 +364,14 @@ fast_downward_plugin(
     DEPENDS STUBBORN_SETS_ACTION_CENTRIC
 )
 
+fast_downward_plugin(
+    NAME STUBBORN_SETS_GOAL_SUBSETS
+    HELP "Stubborn sets preserving all reachable goal subsets"
+    SOURCES
+        pruning/stubborn_sets_goal_subsets
+    DEPENDS STUBBORN_SETS_SIMPLE TASK_PROPERTIES
+)
+
 fast_downward_plugin(
     NAME STUBBORN_SETS_EC
     HELP "Stubborn set method that dominates expansion core"
@@ -450,6 +462,14 @@ fast_downward_plugin(
     DEPENDS G_EVALUATOR ORDERED_SET PREF_EVALUATOR SEARCH_COMMON SUCCESSOR_GENERATOR
 )
 
+fast_downward_plugin(
+    NAME HDA_SEARCH
+    HELP "Hash-distributed parallel best-first search"
+    SOURCES
+        search_engines/hda_search
+    DEPENDS SUCCESSOR_GENERATOR
+)
+
 fast_downward_plugin(
     NAME ITERATED_SEARCH
     HELP "Iterated search algorithm"
@@ -466,6 +486,15 @@ fast_downward_plugin(
     DEPENDENCY_ONLY
 )
 
+fast_downward_plugin(
+    NAME STRUCTURAL_SYMMETRIES
+    HELP "Structural symmetries and an embedded graph automorphism solver"
+    SOURCES
+        structural_symmetries/graph_automorphisms
+        structural_symmetries/group
+    DEPENDS TASK_PROPERTIES
+)
+
 fast_downward_plugin(
     NAME XAIP
     HELP "MUGS computation"
@@ -487,6 +516,7 @@ fast_downward_plugin(
         xaip/explicit_mugs_search/reachable_goal_subsets_max_heuristic
         xaip/explicit_mugs_search/reachable_goal_subsets_tracking
         xaip/explicit_mugs_search/new_goal_subset_heuristic
+        xaip/explicit_mugs_search/cost_partitioning_goal_subset_heuristic
         xaip/explicit_mugs_search/dfs_search
         xaip/explicit_mugs_search/goal_subset_astar
         xaip/explicit_mugs_search/msgs_evaluation_context
@@ -499,7 +529,7 @@ fast_downward_plugin(
         potentials/individual_goal_potential_heuristics
         potentials/potential_goals_heuristic
         xaip/utils/initial_state_heuristic
-    DEPENDS MAX_HEURISTIC
+    DEPENDS MAX_HEURISTIC STRUCTURAL_SYMMETRIES
 )
 
 fast_downward_plugin(
@@ -716,6 +746,7 @@ fast_downward_plugin(
         cegar/cartesian_set
         cegar/cegar
         cegar/cost_saturation
+        cegar/multi_abstraction_lookup
         cegar/refinement_hierarchy
         cegar/split_selector
         cegar/subtask_generators
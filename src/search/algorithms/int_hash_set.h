@@ -8,6 +8,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <iostream>
 #include <limits>
 #include <utility>
@@ -33,7 +34,10 @@ namespace int_hash_set {
   Limitations:
 
   We use 32-bit (signed and unsigned) integers instead of larger data
-  types for keys and hashes to save memory.
+  types for keys and hashes to save memory. If the planner is compiled
+  with USE_WIDE_STATE_IDS, keys, hashes and the capacity are 64-bit
+  integers instead (16 bytes per bucket) and the limits below do not
+  apply.
 
   Consequently, the range of valid keys is [0, 2^31 - 1]. This range
   could be extended to [0, 2^32 - 2] without using more memory by
@@ -69,17 +73,27 @@ namespace int_hash_set {
 
 */
 
+#ifdef USE_WIDE_STATE_IDS
+using KeyType = std::int64_t;
+using HashType = std::uint64_t;
+
+static_assert(sizeof(KeyType) == 8, "KeyType does not use 8 bytes");
+static_assert(sizeof(HashType) == 8, "HashType does not use 8 bytes");
+#else
 using KeyType = int;
 using HashType = unsigned int;
 
 static_assert(sizeof(KeyType) == 4, "KeyType does not use 4 bytes");
 static_assert(sizeof(HashType) == 4, "HashType does not use 4 bytes");
+#endif
+// Type for bucket indices and sizes.
+using IndexType = KeyType;
 
 template<typename Hasher, typename Equal>
 class IntHashSet {
     // Max distance from the ideal bucket to the actual bucket for each key.
     static const int MAX_DISTANCE = 32;
-    static const unsigned int MAX_BUCKETS = std::numeric_limits<unsigned int>::max();
+    static const HashType MAX_BUCKETS = std::numeric_limits<HashType>::max();
 
     struct Bucket {
         KeyType key;
@@ -105,16 +119,16 @@ class IntHashSet {
     Hasher hasher;
     Equal equal;
     std::vector<Bucket> buckets;
-    int num_entries;
+    IndexType num_entries;
     int num_resizes;
 
-    int capacity() const {
+    IndexType capacity() const {
         return buckets.size();
     }
 
-    void rehash(int new_capacity) {
+    void rehash(IndexType new_capacity) {
         assert(new_capacity >= 1);
-        int num_entries_before = num_entries;
+        IndexType num_entries_before = num_entries;
         std::vector<Bucket> old_buckets = std::move(buckets);
         assert(buckets.empty());
         num_entries = 0;
@@ -130,7 +144,7 @@ class IntHashSet {
     }
 
     void enlarge() {
-        unsigned int num_buckets = buckets.size();
+        HashType num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         if (num_buckets > MAX_BUCKETS / 2) {
@@ -145,9 +159,9 @@ class IntHashSet {
         rehash(num_buckets * 2);
     }
 
-    int get_bucket(HashType hash) const {
+    IndexType get_bucket(HashType hash) const {
         assert(!buckets.empty());
-        unsigned int num_buckets = buckets.size();
+        HashType num_buckets = buckets.size();
         // Verify that the number of buckets is a power of 2.
         assert((num_buckets & (num_buckets - 1)) == 0);
         /* We want to return hash % num_buckets. The following line does this
@@ -159,7 +173,7 @@ class IntHashSet {
       Return distance from index1 to index2, only moving right and wrapping
       from the last to the first bucket.
     */
-    int get_distance(int index1, int index2) const {
+    IndexType get_distance(IndexType index1, IndexType index2) const {
         assert(utils::in_bounds(index1, buckets));
         assert(utils::in_bounds(index2, buckets));
         if (index2 >= index1) {
@@ -169,7 +183,7 @@ class IntHashSet {
         }
     }
 
-    int find_next_free_bucket_index(int index) const {
+    IndexType find_next_free_bucket_index(IndexType index) const {
         assert(num_entries < capacity());
         assert(utils::in_bounds(index, buckets));
         while (buckets[index].full()) {
@@ -180,9 +194,9 @@ class IntHashSet {
 
     KeyType find_equal_key(KeyType key, HashType hash) const {
         assert(hasher(key) == hash);
-        int ideal_index = get_bucket(hash);
+        IndexType ideal_index = get_bucket(hash);
         for (int i = 0; i < MAX_DISTANCE; ++i) {
-            int index = get_bucket(ideal_index + i);
+            IndexType index = get_bucket(ideal_index + i);
             const Bucket &bucket = buckets[index];
             if (bucket.full() && bucket.hash == hash && equal(bucket.key, key)) {
                 return bucket.key;
@@ -222,10 +236,10 @@ class IntHashSet {
         assert(num_entries < capacity());
 
         // Compute ideal bucket.
-        int ideal_index = get_bucket(hash);
+        IndexType ideal_index = get_bucket(hash);
 
         // Find first free bucket left of the ideal bucket.
-        int free_index = find_next_free_bucket_index(ideal_index);
+        IndexType free_index = find_next_free_bucket_index(ideal_index);
 
         /*
           While the free bucket is too far from the ideal bucket, move the free
@@ -236,15 +250,16 @@ class IntHashSet {
         */
         while (get_distance(ideal_index, free_index) >= MAX_DISTANCE) {
             bool swapped = false;
-            int num_buckets = capacity();
-            int max_offset = std::min(MAX_DISTANCE, num_buckets) - 1;
+            IndexType num_buckets = capacity();
+            int max_offset = static_cast<int>(
+                std::min(static_cast<IndexType>(MAX_DISTANCE), num_buckets)) - 1;
             for (int offset = max_offset; offset >= 1; --offset) {
                 assert(offset < num_buckets);
-                int candidate_index = free_index + num_buckets - offset;
+                IndexType candidate_index = free_index + num_buckets - offset;
                 assert(candidate_index >= 0);
                 candidate_index = get_bucket(candidate_index);
                 HashType candidate_hash = buckets[candidate_index].hash;
-                int candidate_ideal_index = get_bucket(candidate_hash);
+                IndexType candidate_ideal_index = get_bucket(candidate_hash);
                 if (get_distance(candidate_ideal_index, free_index) < MAX_DISTANCE) {
                     // Candidate can be swapped.
                     std::swap(buckets[candidate_index], buckets[free_index]);
@@ -276,7 +291,7 @@ public:
           num_resizes(0) {
     }
 
-    int size() const {
+    IndexType size() const {
         return num_entries;
     }
 
@@ -292,10 +307,49 @@ public:
         return insert(key, hasher(key));
     }
 
+    /*
+      Like insert(key), but use a precomputed hash. The hash must be equal
+      to the hash computed by the hasher of this set.
+    */
+    std::pair<KeyType, bool> insert_with_hash(KeyType key, HashType hash) {
+        assert(key >= 0);
+        return insert(key, hash);
+    }
+
+    /*
+      Return a key with the given hash for which matches(key) is true, or
+      -1 if there is no such key. This allows looking up entries without
+      inserting a key for them first.
+    */
+    template<typename Matcher>
+    KeyType find(HashType hash, const Matcher &matches) const {
+        assert(!buckets.empty());
+        IndexType ideal_index = get_bucket(hash);
+        for (int i = 0; i < MAX_DISTANCE; ++i) {
+            const Bucket &bucket = buckets[get_bucket(ideal_index + i)];
+            if (bucket.full() && bucket.hash == hash && matches(bucket.key)) {
+                return bucket.key;
+            }
+        }
+        return Bucket::empty_bucket_key;
+    }
+
+    /*
+      Hint that a key with the given hash will be inserted or looked up
+      soon, so the corresponding buckets can be loaded into the cache.
+    */
+    void prefetch(HashType hash) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&buckets[get_bucket(hash)]);
+#else
+        utils::unused_variable(hash);
+#endif
+    }
+
     void dump(utils::LogProxy &log) const {
-        int num_buckets = capacity();
+        IndexType num_buckets = capacity();
         log << "[";
-        for (int i = 0; i < num_buckets; ++i) {
+        for (IndexType i = 0; i < num_buckets; ++i) {
             const Bucket &bucket = buckets[i];
             if (bucket.full()) {
                 log << bucket.key;
@@ -311,7 +365,7 @@ public:
 
     void print_statistics(utils::LogProxy &log) const {
         assert(!buckets.empty());
-        int num_buckets = capacity();
+        IndexType num_buckets = capacity();
         assert(num_buckets != 0);
         log << "Int hash set load factor: " << num_entries << "/"
             << num_buckets << " = "
@@ -325,7 +379,7 @@ template<typename Hasher, typename Equal>
 const int IntHashSet<Hasher, Equal>::MAX_DISTANCE;
 
 template<typename Hasher, typename Equal>
-const unsigned int IntHashSet<Hasher, Equal>::MAX_BUCKETS;
+const HashType IntHashSet<Hasher, Equal>::MAX_BUCKETS;
 }
 
 #endif
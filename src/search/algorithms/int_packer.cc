@@ -57,6 +57,10 @@ public:
         return (buffer[bin_index] & read_mask) >> shift;
     }
 
+    int get_bin_index() const {
+        return bin_index;
+    }
+
     void set(Bin *buffer, int value) const {
         assert(value >= 0 && value < range);
         Bin &bin = buffer[bin_index];
@@ -77,6 +81,10 @@ int IntPacker::get(const Bin *buffer, int var) const {
     return var_infos[var].get(buffer);
 }
 
+int IntPacker::get_bin_index(int var) const {
+    return var_infos[var].get_bin_index();
+}
+
 void IntPacker::set(Bin *buffer, int var, int value) const {
     var_infos[var].set(buffer, value);
 }
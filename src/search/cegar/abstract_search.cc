@@ -6,6 +6,7 @@
 
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -13,144 +14,202 @@ using namespace std;
 namespace cegar {
 AbstractSearch::AbstractSearch(
     const vector<int> &operator_costs)
-    : operator_costs(operator_costs),
-      search_info(1) {
+    : operator_costs(operator_costs) {
 }
 
-void AbstractSearch::reset(int num_states) {
-    open_queue.clear();
-    search_info.resize(num_states);
-    for (AbstractSearchInfo &info : search_info) {
-        info.reset();
-    }
-}
-
-unique_ptr<Solution> AbstractSearch::extract_solution(int init_id, int goal_id) const {
-    unique_ptr<Solution> solution = utils::make_unique_ptr<Solution>();
-    int current_id = goal_id;
-    while (current_id != init_id) {
-        const Transition &prev = search_info[current_id].get_incoming_transition();
-        solution->emplace_front(prev.op_id, current_id);
-        assert(prev.target_id != current_id);
-        current_id = prev.target_id;
-    }
-    return solution;
+int AbstractSearch::add_costs(int op_id, int distance) const {
+    assert(utils::in_bounds(op_id, operator_costs));
+    const int op_cost = operator_costs[op_id];
+    assert(op_cost >= 0);
+    if (op_cost == INF || distance == INF)
+        return INF;
+    return op_cost + distance;
 }
 
-void AbstractSearch::update_goal_distances(const Solution &solution) {
-    /*
-      Originally, we only updated the goal distances of states that are part of
-      the trace (see Seipp and Helmert, JAIR 2018). The code below generalizes
-      this idea and potentially updates the goal distances of all states.
-
-      Let C* be the cost of the trace and g(s) be the g value of states s when
-      A* finds the trace. Then for all states s with g(s) < INF (i.e., s has
-      been reached by the search), C*-g(s) is a lower bound on the goal
-      distance. This is the case since
-
-      g(s) >= g*(s) [1]
-
-      and
-
-          f*(s) >= C*         (optimality of A* with an admissible heuristic)
-      ==> g*(s) + h*(s) >= C* (definition of f values)
-      ==> g(s) + h*(s) >= C*  (using [1])
-      ==> h*(s) >= C* - g(s)  (arithmetic)
+void AbstractSearch::propagate_goal_distances(
+    const vector<Transitions> &incoming) {
+    while (!open_queue.empty()) {
+        pair<int, int> top_pair = open_queue.pop();
+        int old_g = top_pair.first;
+        int state_id = top_pair.second;
 
-      Together with our existing lower bound h*(s) >= h(s), i.e., the h values
-      from the last iteration, for each abstract state s with g(s) < INF, we
-      can set h(s) = max(h(s), C*-g(s)).
-    */
-    int solution_cost = 0;
-    for (const Transition &transition : solution) {
-        solution_cost += operator_costs[transition.op_id];
-    }
-    for (auto &info : search_info) {
-        if (info.get_g_value() < INF) {
-            int new_h = max(info.get_h_value(), solution_cost - info.get_g_value());
-            info.increase_h_value_to(new_h);
+        const int g = goal_distances[state_id];
+        assert(0 <= g && g < INF);
+        assert(g <= old_g);
+        if (g < old_g)
+            continue;
+        assert(utils::in_bounds(state_id, incoming));
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            if (!is_orphan[pred_id])
+                continue;
+            int pred_g = add_costs(transition.op_id, g);
+            if (pred_g < goal_distances[pred_id]) {
+                goal_distances[pred_id] = pred_g;
+                shortest_path[pred_id] = Transition(transition.op_id, state_id);
+                open_queue.push(pred_g, pred_id);
+            }
         }
     }
 }
 
-unique_ptr<Solution> AbstractSearch::find_solution(
-    const vector<Transitions> &transitions,
-    int init_id,
-    const Goals &goal_ids) {
-    reset(transitions.size());
-    search_info[init_id].decrease_g_value_to(0);
-    open_queue.push(search_info[init_id].get_h_value(), init_id);
-    int goal_id = astar_search(transitions, goal_ids);
+void AbstractSearch::compute_goal_distances(
+    const vector<Transitions> &incoming, const Goals &goal_ids) {
+    int num_states = incoming.size();
+    goal_distances.assign(num_states, INF);
+    shortest_path.assign(num_states, Transition(UNDEFINED, UNDEFINED));
+    // Without previous distances, all states are orphans.
+    is_orphan.assign(num_states, true);
     open_queue.clear();
-    bool has_found_solution = (goal_id != UNDEFINED);
-    if (has_found_solution) {
-        unique_ptr<Solution> solution = extract_solution(init_id, goal_id);
-        update_goal_distances(*solution);
-        return solution;
-    } else {
-        search_info[init_id].increase_h_value_to(INF);
+    for (int goal_id : goal_ids) {
+        goal_distances[goal_id] = 0;
+        open_queue.push(0, goal_id);
     }
-    return nullptr;
+    propagate_goal_distances(incoming);
+    is_orphan.assign(num_states, false);
 }
 
-int AbstractSearch::astar_search(
-    const vector<Transitions> &transitions, const Goals &goals) {
+void AbstractSearch::mark_orphans(
+    const vector<Transitions> &incoming,
+    const vector<Transitions> &outgoing,
+    const Goals &goal_ids) {
+    /*
+      Visit the states in the order of their old goal distances. All states
+      with smaller distances are final at this point. A state that has an
+      optimal transition to such a state keeps its distance and its subtree
+      in the shortest-path tree. We never reconnect a state via a 0-cost
+      transition to a non-goal state, since the target may lie in the
+      subtree of the state.
+    */
     while (!open_queue.empty()) {
         pair<int, int> top_pair = open_queue.pop();
-        int old_f = top_pair.first;
         int state_id = top_pair.second;
-
-        const int g = search_info[state_id].get_g_value();
-        assert(0 <= g && g < INF);
-        int new_f = g + search_info[state_id].get_h_value();
-        assert(new_f <= old_f);
-        if (new_f < old_f)
+        const int g = goal_distances[state_id];
+        assert(top_pair.first == g);
+        assert(!is_orphan[state_id]);
+        if (goal_ids.count(state_id)) {
+            assert(g == 0);
+            shortest_path[state_id] = Transition(UNDEFINED, UNDEFINED);
             continue;
-        if (goals.count(state_id)) {
-            return state_id;
         }
-        assert(utils::in_bounds(state_id, transitions));
-        for (const Transition &transition : transitions[state_id]) {
-            int op_id = transition.op_id;
+
+        bool reconnected = false;
+        for (const Transition &transition : outgoing[state_id]) {
             int succ_id = transition.target_id;
+            if (is_orphan[succ_id] ||
+                (operator_costs[transition.op_id] == 0 && !goal_ids.count(succ_id)))
+                continue;
+            if (add_costs(transition.op_id, goal_distances[succ_id]) == g) {
+                shortest_path[state_id] = transition;
+                reconnected = true;
+                break;
+            }
+        }
+        if (reconnected)
+            continue;
 
-            assert(utils::in_bounds(op_id, operator_costs));
-            const int op_cost = operator_costs[op_id];
-            assert(op_cost >= 0);
-            int succ_g = (op_cost == INF) ? INF : g + op_cost;
-            assert(succ_g >= 0);
+        is_orphan[state_id] = true;
+        orphans.push_back(state_id);
+        for (const Transition &transition : incoming[state_id]) {
+            int pred_id = transition.target_id;
+            if (shortest_path[pred_id] == Transition(transition.op_id, state_id)) {
+                open_queue.push(goal_distances[pred_id], pred_id);
+            }
+        }
+    }
+}
 
-            if (succ_g < search_info[succ_id].get_g_value()) {
-                search_info[succ_id].decrease_g_value_to(succ_g);
-                int h = search_info[succ_id].get_h_value();
-                if (h == INF)
-                    continue;
-                int f = succ_g + h;
-                assert(f >= 0);
-                assert(f != INF);
-                open_queue.push(f, succ_id);
-                search_info[succ_id].set_incoming_transition(Transition(op_id, state_id));
+void AbstractSearch::repair_orphans(
+    const vector<Transitions> &incoming,
+    const vector<Transitions> &outgoing) {
+    assert(open_queue.empty());
+    for (int state_id : orphans) {
+        int new_g = INF;
+        Transition new_path(UNDEFINED, UNDEFINED);
+        for (const Transition &transition : outgoing[state_id]) {
+            int succ_id = transition.target_id;
+            if (is_orphan[succ_id])
+                continue;
+            int succ_g = add_costs(transition.op_id, goal_distances[succ_id]);
+            if (succ_g < new_g) {
+                new_g = succ_g;
+                new_path = transition;
             }
         }
+        // Goal distances never decrease.
+        assert(new_g >= goal_distances[state_id]);
+        goal_distances[state_id] = new_g;
+        shortest_path[state_id] = new_path;
+        if (new_g != INF) {
+            open_queue.push(new_g, state_id);
+        }
+    }
+    propagate_goal_distances(incoming);
+    for (int state_id : orphans) {
+        is_orphan[state_id] = false;
     }
-    return UNDEFINED;
+    orphans.clear();
 }
 
-int AbstractSearch::get_h_value(int state_id) const {
-    assert(utils::in_bounds(state_id, search_info));
-    return search_info[state_id].get_h_value();
+void AbstractSearch::update_goal_distances(
+    const vector<Transitions> &incoming,
+    const vector<Transitions> &outgoing,
+    const Goals &goal_ids,
+    int v1_id,
+    int v2_id) {
+    int num_states = incoming.size();
+    assert(v2_id == num_states - 1);
+    assert(utils::in_bounds(v1_id, goal_distances));
+    // The children inherit the goal distance of the split state as a lower bound.
+    int old_g = goal_distances[v1_id];
+    goal_distances.resize(num_states, old_g);
+    shortest_path.resize(num_states, Transition(UNDEFINED, UNDEFINED));
+    is_orphan.resize(num_states, false);
+    if (old_g == INF) {
+        return;
+    }
+    shortest_path[v1_id] = Transition(UNDEFINED, UNDEFINED);
+
+    // Retarget shortest-path transitions that now only lead to v2.
+    for (const Transition &transition : incoming[v2_id]) {
+        int pred_id = transition.target_id;
+        Transition &path = shortest_path[pred_id];
+        if (path.op_id == transition.op_id && path.target_id == v1_id) {
+            const Transitions &pred_outgoing = outgoing[pred_id];
+            if (find(pred_outgoing.begin(), pred_outgoing.end(), path) ==
+                pred_outgoing.end()) {
+                path = Transition(transition.op_id, v2_id);
+            }
+        }
+    }
+
+    open_queue.clear();
+    open_queue.push(old_g, v1_id);
+    open_queue.push(old_g, v2_id);
+    mark_orphans(incoming, outgoing, goal_ids);
+    repair_orphans(incoming, outgoing);
 }
 
-void AbstractSearch::set_h_value(int state_id, int h) {
-    assert(utils::in_bounds(state_id, search_info));
-    search_info[state_id].increase_h_value_to(h);
+unique_ptr<Solution> AbstractSearch::find_solution(
+    int init_id, const Goals &goal_ids) const {
+    assert(utils::in_bounds(init_id, goal_distances));
+    if (goal_distances[init_id] == INF) {
+        return nullptr;
+    }
+    unique_ptr<Solution> solution = utils::make_unique_ptr<Solution>();
+    int current_id = init_id;
+    while (!goal_ids.count(current_id)) {
+        const Transition &transition = shortest_path[current_id];
+        assert(transition.op_id != UNDEFINED);
+        solution->push_back(transition);
+        current_id = transition.target_id;
+    }
+    return solution;
 }
 
-void AbstractSearch::copy_h_value_to_children(int v, int v1, int v2) {
-    int h = get_h_value(v);
-    search_info.resize(search_info.size() + 1);
-    set_h_value(v1, h);
-    set_h_value(v2, h);
+int AbstractSearch::get_h_value(int state_id) const {
+    assert(utils::in_bounds(state_id, goal_distances));
+    return goal_distances[state_id];
 }
 
 
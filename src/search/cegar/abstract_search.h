@@ -14,77 +14,62 @@ namespace cegar {
 using Solution = std::deque<Transition>;
 
 /*
-  Find abstract solutions using A*.
+  Maintain the goal distances of all abstract states together with a
+  shortest-path tree: for each abstract state that can reach a goal, we store
+  the first transition of a cheapest path to a goal. Abstract solutions are
+  read off this tree, so no search is needed to find them.
+
+  Splitting a state can only remove paths, so goal distances never decrease
+  and only states whose tree path leads through the split state may change
+  (Speck and Seipp, ICAPS 2022). After a split, we visit these states in the
+  order of their old goal distances and reconnect each one to a state with
+  final distance if it still has an optimal transition to it. The remaining
+  "orphans" are then repaired with a Dijkstra search restricted to them.
 */
 class AbstractSearch {
-    class AbstractSearchInfo {
-        int g;
-        int h;
-        Transition incoming_transition;
-public:
-        AbstractSearchInfo()
-            : h(0),
-              incoming_transition(UNDEFINED, UNDEFINED) {
-            reset();
-        }
-
-        void reset() {
-            g = std::numeric_limits<int>::max();
-            incoming_transition = Transition(UNDEFINED, UNDEFINED);
-        }
-
-        void decrease_g_value_to(int new_g) {
-            assert(new_g <= g);
-            g = new_g;
-        }
-
-        int get_g_value() const {
-            return g;
-        }
-
-        void increase_h_value_to(int new_h) {
-            assert(new_h >= h);
-            h = new_h;
-        }
-
-        int get_h_value() const {
-            return h;
-        }
-
-        void set_incoming_transition(const Transition &transition) {
-            incoming_transition = transition;
-        }
-
-        const Transition &get_incoming_transition() const {
-            assert(incoming_transition.op_id != UNDEFINED &&
-                   incoming_transition.target_id != UNDEFINED);
-            return incoming_transition;
-        }
-    };
-
     const std::vector<int> operator_costs;
 
+    std::vector<int> goal_distances;
+    // Transition on a shortest path to a goal (undefined for goals and dead ends).
+    std::vector<Transition> shortest_path;
+
     // Keep data structures around to avoid reallocating them.
     priority_queues::AdaptiveQueue<int> open_queue;
-    std::vector<AbstractSearchInfo> search_info;
-
-    void reset(int num_states);
-    void set_h_value(int state_id, int h);
-    std::unique_ptr<Solution> extract_solution(int init_id, int goal_id) const;
-    void update_goal_distances(const Solution &solution);
-    int astar_search(
-        const std::vector<Transitions> &transitions,
+    std::vector<bool> is_orphan;
+    std::vector<int> orphans;
+
+    int add_costs(int op_id, int distance) const;
+    // Run Dijkstra backwards from the queued states, updating only orphans.
+    void propagate_goal_distances(const std::vector<Transitions> &incoming);
+    void mark_orphans(
+        const std::vector<Transitions> &incoming,
+        const std::vector<Transitions> &outgoing,
         const Goals &goals);
+    void repair_orphans(
+        const std::vector<Transitions> &incoming,
+        const std::vector<Transitions> &outgoing);
 
 public:
     explicit AbstractSearch(const std::vector<int> &operator_costs);
 
-    std::unique_ptr<Solution> find_solution(
-        const std::vector<Transitions> &transitions,
-        int init_id,
-        const Goals &goal_ids);
+    // Compute goal distances from scratch.
+    void compute_goal_distances(
+        const std::vector<Transitions> &incoming, const Goals &goal_ids);
+
+    /*
+      Update goal distances after a state has been split into v1 and v2,
+      where v1 reuses the ID of the split state.
+    */
+    void update_goal_distances(
+        const std::vector<Transitions> &incoming,
+        const std::vector<Transitions> &outgoing,
+        const Goals &goal_ids,
+        int v1_id,
+        int v2_id);
+
+    // Return a cheapest abstract solution or nullptr if there is none.
+    std::unique_ptr<Solution> find_solution(int init_id, const Goals &goal_ids) const;
     int get_h_value(int state_id) const;
-    void copy_h_value_to_children(int v, int v1, int v2);
 };
 
 std::vector<int> compute_distances(
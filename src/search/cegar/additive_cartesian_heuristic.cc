@@ -34,6 +34,7 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
         opts.get<double>("max_time"),
         opts.get<bool>("use_general_costs"),
         opts.get<PickSplit>("pick"),
+        opts.get<int>("num_threads"),
         *rng,
         log);
     return cost_saturation.generate_heuristic_functions(
@@ -43,32 +44,21 @@ static vector<CartesianHeuristicFunction> generate_heuristic_functions(
 AdditiveCartesianHeuristic::AdditiveCartesianHeuristic(
     const options::Options &opts)
     : Heuristic(opts),
-      heuristic_functions(generate_heuristic_functions(opts, log)) {
+      heuristic_functions(generate_heuristic_functions(opts, log)),
+      lookup(heuristic_functions) {
 }
 
 int AdditiveCartesianHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    int sum_h = 0;
-    for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
-        assert(value >= 0);
-        if (value == INF)
-            return INF - 10;
-        sum_h += value;
-    }
+    int sum_h = lookup.get_sum(ancestor_state);
+    if (sum_h == INF)
+        return INF - 10;
     assert(sum_h >= 0);
     return sum_h;
 }
 
 std::vector<int> AdditiveCartesianHeuristic::get_heuristic_values(const State &state, std::vector<FactPair>){
     vector<int> costs;
-    // cout << "----------------------------" << endl;
-    for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
-        // cout << "h=" << value << endl;
-        assert(value >= 0);
-        costs.push_back(value);
-    }
+    lookup.get_values(state, costs);
     return costs;
 }
 
@@ -119,36 +109,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "subtasks",
         "subtask generators",
         "[landmarks(),goals()]");
-    parser.add_option<int>(
-        "max_states",
-        "maximum sum of abstract states over all abstractions",
-        "infinity",
-        Bounds("1", "infinity"));
-    parser.add_option<int>(
-        "max_transitions",
-        "maximum sum of real transitions (excluding self-loops) over "
-        " all abstractions",
-        "1M",
-        Bounds("0", "infinity"));
-    parser.add_option<double>(
-        "max_time",
-        "maximum time in seconds for building abstractions",
-        "infinity",
-        Bounds("0.0", "infinity"));
-    vector<string> pick_strategies;
-    pick_strategies.push_back("RANDOM");
-    pick_strategies.push_back("MIN_UNWANTED");
-    pick_strategies.push_back("MAX_UNWANTED");
-    pick_strategies.push_back("MIN_REFINED");
-    pick_strategies.push_back("MAX_REFINED");
-    pick_strategies.push_back("MIN_HADD");
-    pick_strategies.push_back("MAX_HADD");
-    parser.add_enum_option<PickSplit>(
-        "pick", pick_strategies, "split-selection strategy", "MAX_REFINED");
-    parser.add_option<bool>(
-        "use_general_costs",
-        "allow negative costs in cost partitioning",
-        "true");
+    add_cost_saturation_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     utils::add_rng_options(parser);
 
@@ -1,6 +1,8 @@
 #ifndef CEGAR_ADDITIVE_CARTESIAN_HEURISTIC_H
 #define CEGAR_ADDITIVE_CARTESIAN_HEURISTIC_H
 
+#include "multi_abstraction_lookup.h"
+
 #include "../heuristic.h"
 
 #include <vector>
@@ -16,6 +18,8 @@ class AdditiveCartesianHeuristic : public Heuristic {
     
 protected:
     const std::vector<CartesianHeuristicFunction> heuristic_functions;
+    // Fused lookup structure for all heuristic_functions.
+    MultiAbstractionLookup lookup;
     virtual int compute_heuristic(const State &ancestor_state) override;
 
 public:
@@ -26,6 +26,14 @@ public:
     CartesianHeuristicFunction(CartesianHeuristicFunction &&) = default;
 
     int get_value(const State &state) const;
+
+    const RefinementHierarchy &get_refinement_hierarchy() const {
+        return *refinement_hierarchy;
+    }
+
+    const std::vector<int> &get_h_values() const {
+        return h_values;
+    }
 };
 }
 
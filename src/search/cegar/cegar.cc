@@ -183,10 +183,15 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
     utils::Timer find_flaw_timer(false);
     utils::Timer refine_timer(false);
 
+    const TransitionSystem &transition_system = abstraction->get_transition_system();
+    find_trace_timer.resume();
+    abstract_search.compute_goal_distances(
+        transition_system.get_incoming_transitions(), abstraction->get_goals());
+    find_trace_timer.stop();
+
     while (may_keep_refining()) {
         find_trace_timer.resume();
         unique_ptr<Solution> solution = abstract_search.find_solution(
-            abstraction->get_transition_system().get_outgoing_transitions(),
             abstraction->get_initial_state().get_id(),
             abstraction->get_goals());
         find_trace_timer.stop();
@@ -209,15 +214,19 @@ void CEGAR::refinement_loop(utils::RandomNumberGenerator &rng) {
 
         refine_timer.resume();
         const AbstractState &abstract_state = flaw->current_abstract_state;
-        int state_id = abstract_state.get_id();
         vector<Split> splits = flaw->get_possible_splits();
         const Split &split = split_selector.pick_split(abstract_state, splits, rng);
         auto new_state_ids = abstraction->refine(abstract_state, split.var_id, split.values);
-        // Since h-values only increase we can assign the h-value to the children.
-        abstract_search.copy_h_value_to_children(
-            state_id, new_state_ids.first, new_state_ids.second);
         refine_timer.stop();
 
+        find_trace_timer.resume();
+        abstract_search.update_goal_distances(
+            transition_system.get_incoming_transitions(),
+            transition_system.get_outgoing_transitions(),
+            abstraction->get_goals(),
+            new_state_ids.first, new_state_ids.second);
+        find_trace_timer.stop();
+
         if (log.is_at_least_verbose() &&
             abstraction->get_num_states() % 1000 == 0) {
             log << abstraction->get_num_states() << "/" << max_states << " states, "
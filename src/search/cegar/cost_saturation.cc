@@ -9,14 +9,19 @@
 #include "transition_system.h"
 #include "utils.h"
 
+#include "../option_parser.h"
+
 #include "../task_utils/task_properties.h"
 #include "../tasks/modified_operator_costs_task.h"
 #include "../utils/countdown_timer.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
+#include "../utils/rng.h"
 
 #include <algorithm>
 #include <cassert>
+#include <limits>
 
 using namespace std;
 
@@ -88,6 +93,7 @@ CostSaturation::CostSaturation(
     double max_time,
     bool use_general_costs,
     PickSplit pick_split,
+    int num_threads,
     utils::RandomNumberGenerator &rng,
     utils::LogProxy &log)
     : subtask_generators(subtask_generators),
@@ -96,6 +102,7 @@ CostSaturation::CostSaturation(
       max_time(max_time),
       use_general_costs(use_general_costs),
       pick_split(pick_split),
+      num_threads(num_threads),
       rng(rng),
       log(log),
       num_abstractions(0),
@@ -191,6 +198,10 @@ void CostSaturation::build_abstractions(
     const vector<shared_ptr<AbstractTask>> &subtasks,
     const utils::CountdownTimer &timer,
     function<bool()> should_abort) {
+    if (num_threads > 1 && subtasks.size() > 1) {
+        build_abstractions_in_parallel(subtasks, timer, should_abort);
+        return;
+    }
     int rem_subtasks = subtasks.size();
     for (shared_ptr<AbstractTask> subtask : subtasks) {
         // subtask = get_remaining_costs_task(subtask);
@@ -240,6 +251,131 @@ void CostSaturation::build_abstractions(
     }
 }
 
+void CostSaturation::build_abstractions_in_parallel(
+    const vector<shared_ptr<AbstractTask>> &subtasks,
+    const utils::CountdownTimer &timer,
+    function<bool()> should_abort) {
+    /*
+      The subtasks are not cost-partitioned, so their abstractions can be
+      built independently. Each subtask gets the same share of the remaining
+      states, transitions and time. The time share does not depend on the
+      number of threads: it is the time the subtask would get if the
+      subtasks were processed one after another, so more threads finish
+      sooner instead of refining longer. We draw the random seeds for the
+      subtasks up front, so the abstractions do not depend on the
+      scheduling of the threads. The subtasks are processed in batches of
+      num_threads, and we stop after the first batch for which
+      should_abort() holds.
+    */
+    int num_subtasks = subtasks.size();
+    assert(num_states < max_states);
+    int max_states_per_subtask = max(1, (max_states - num_states) / num_subtasks);
+    int max_transitions_per_subtask = max(
+        1, (max_non_looping_transitions - num_non_looping_transitions) /
+        num_subtasks);
+    double max_time_per_subtask = timer.get_remaining_time() / num_subtasks;
+    vector<int> seeds;
+    seeds.reserve(num_subtasks);
+    for (int i = 0; i < num_subtasks; ++i) {
+        seeds.push_back(rng.random(numeric_limits<int>::max()));
+    }
+
+    vector<unique_ptr<Abstraction>> abstractions(num_subtasks);
+    vector<vector<int>> goal_distances(num_subtasks);
+    int num_built = 0;
+    while (num_built < num_subtasks) {
+        int batch_begin = num_built;
+        int batch_size = min(num_threads, num_subtasks - batch_begin);
+        utils::run_in_parallel(
+            batch_size, num_threads,
+            [&](int job) {
+                int i = batch_begin + job;
+                utils::RandomNumberGenerator subtask_rng(seeds[i]);
+                // LogProxy is not thread-safe.
+                utils::LogProxy silent_log = utils::get_silent_log();
+                CEGAR cegar(
+                    subtasks[i],
+                    max_states_per_subtask,
+                    max_transitions_per_subtask,
+                    max_time_per_subtask,
+                    pick_split,
+                    subtask_rng,
+                    silent_log);
+                abstractions[i] = cegar.extract_abstraction();
+                goal_distances[i] = compute_distances(
+                    abstractions[i]->get_transition_system().get_incoming_transitions(),
+                    task_properties::get_operator_costs(TaskProxy(*subtasks[i])),
+                    abstractions[i]->get_goals());
+            });
+
+        for (int i = batch_begin; i < batch_begin + batch_size; ++i) {
+            ++num_abstractions;
+            num_states += abstractions[i]->get_num_states();
+            num_non_looping_transitions +=
+                abstractions[i]->get_transition_system().get_num_non_loops();
+            heuristic_functions.emplace_back(
+                abstractions[i]->extract_refinement_hierarchy(),
+                move(goal_distances[i]));
+            abstractions[i] = nullptr;
+        }
+        num_built += batch_size;
+        if (should_abort())
+            break;
+    }
+    assert(num_states <= max_states);
+    if (log.is_at_least_normal()) {
+        log << "Built " << num_built << " of " << num_subtasks
+            << " abstractions on " << min(num_threads, num_subtasks)
+            << " threads." << endl;
+    }
+}
+
+void add_cost_saturation_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "max_states",
+        "maximum sum of abstract states over all abstractions",
+        "infinity",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_transitions",
+        "maximum sum of real transitions (excluding self-loops) over "
+        " all abstractions",
+        "1M",
+        Bounds("0", "infinity"));
+    parser.add_option<double>(
+        "max_time",
+        "maximum time in seconds for building abstractions",
+        "infinity",
+        Bounds("0.0", "infinity"));
+    vector<string> pick_strategies;
+    pick_strategies.push_back("RANDOM");
+    pick_strategies.push_back("MIN_UNWANTED");
+    pick_strategies.push_back("MAX_UNWANTED");
+    pick_strategies.push_back("MIN_REFINED");
+    pick_strategies.push_back("MAX_REFINED");
+    pick_strategies.push_back("MIN_HADD");
+    pick_strategies.push_back("MAX_HADD");
+    parser.add_enum_option<PickSplit>(
+        "pick", pick_strategies, "split-selection strategy", "MAX_REFINED");
+    parser.add_option<bool>(
+        "use_general_costs",
+        "allow negative costs in cost partitioning",
+        "true");
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for building the abstractions of the subtasks of "
+        "each subtask generator. With more than one thread, the subtasks "
+        "share the remaining states, transitions and time equally (each "
+        "subtask gets the time it would get if the subtasks were processed "
+        "one after another) and use their own random seeds, so the "
+        "abstractions do not depend on the number of threads unless a time "
+        "limit is hit, but may differ from the ones built with one thread. "
+        "The abort conditions (e.g., a dead-end initial state) are checked "
+        "after each batch of num_threads subtasks.",
+        "1",
+        Bounds("1", "infinity"));
+}
+
 void CostSaturation::print_statistics(utils::Duration init_time) const {
     if (log.is_at_least_normal()) {
         log << "Done initializing additive Cartesian heuristic" << endl;
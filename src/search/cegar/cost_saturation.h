@@ -7,6 +7,10 @@
 #include <memory>
 #include <vector>
 
+namespace options {
+class OptionParser;
+}
+
 namespace utils {
 class CountdownTimer;
 class Duration;
@@ -32,6 +36,7 @@ class CostSaturation {
     const double max_time;
     const bool use_general_costs;
     const PickSplit pick_split;
+    const int num_threads;
     utils::RandomNumberGenerator &rng;
     utils::LogProxy &log;
 
@@ -50,6 +55,10 @@ class CostSaturation {
         const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
         const utils::CountdownTimer &timer,
         std::function<bool()> should_abort);
+    void build_abstractions_in_parallel(
+        const std::vector<std::shared_ptr<AbstractTask>> &subtasks,
+        const utils::CountdownTimer &timer,
+        std::function<bool()> should_abort);
     void print_statistics(utils::Duration init_time) const;
 
 public:
@@ -60,12 +69,17 @@ public:
         double max_time,
         bool use_general_costs,
         PickSplit pick_split,
+        int num_threads,
         utils::RandomNumberGenerator &rng,
         utils::LogProxy &log);
 
     std::vector<CartesianHeuristicFunction> generate_heuristic_functions(
         const std::shared_ptr<AbstractTask> &task);
 };
+
+// Options of the cost saturation, shared by the Cartesian heuristics.
+extern void add_cost_saturation_options_to_parser(
+    options::OptionParser &parser);
 }
 
 #endif
@@ -0,0 +1,153 @@
+#include "multi_abstraction_lookup.h"
+
+#include "cartesian_heuristic_function.h"
+#include "refinement_hierarchy.h"
+#include "types.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/collections.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace cegar {
+MultiAbstractionLookup::MultiAbstractionLookup(
+    const vector<CartesianHeuristicFunction> &functions) {
+    static_assert(sizeof(FlatNode) == 16, "FlatNode should fill a quarter cache line");
+    size_t num_nodes = 0;
+    for (const CartesianHeuristicFunction &function : functions) {
+        num_nodes += function.get_refinement_hierarchy().get_nodes().size();
+    }
+    nodes.reserve(num_nodes);
+    abstractions.reserve(functions.size());
+
+    for (const CartesianHeuristicFunction &function : functions) {
+        const RefinementHierarchy &hierarchy = function.get_refinement_hierarchy();
+        const vector<int> &h_values = function.get_h_values();
+
+        AbstractionInfo info;
+        info.root = nodes.size();
+
+        auto task_it = find(tasks.begin(), tasks.end(), hierarchy.get_task());
+        info.task_index = task_it - tasks.begin();
+        if (task_it == tasks.end()) {
+            tasks.push_back(hierarchy.get_task());
+        }
+
+        vector<int> vars;
+        for (const Node &node : hierarchy.get_nodes()) {
+            FlatNode flat_node;
+            if (node.is_split()) {
+                flat_node.var = node.get_var();
+                flat_node.value = node.get_split_value();
+                flat_node.left_child = info.root + node.get_left_child();
+                flat_node.right_child = info.root + node.get_right_child();
+                vars.push_back(node.get_var());
+            } else {
+                int state_id = node.get_state_id();
+                assert(utils::in_bounds(state_id, h_values));
+                flat_node.var = UNDEFINED;
+                flat_node.value = h_values[state_id];
+                flat_node.left_child = UNDEFINED;
+                flat_node.right_child = UNDEFINED;
+            }
+            nodes.push_back(flat_node);
+        }
+        utils::sort_unique(vars);
+
+        info.vars_begin = split_vars.size();
+        info.num_vars = vars.size();
+        info.cached_value = UNDEFINED;
+        info.cache_is_valid = false;
+        split_vars.insert(split_vars.end(), vars.begin(), vars.end());
+        abstractions.push_back(info);
+    }
+    cached_keys.resize(split_vars.size());
+    converted_values.resize(tasks.size());
+    is_converted.resize(tasks.size(), false);
+}
+
+bool MultiAbstractionLookup::cache_hit(
+    const AbstractionInfo &info, const vector<int> &ancestor_values) const {
+    if (!info.cache_is_valid)
+        return false;
+    for (int i = info.vars_begin; i < info.vars_begin + info.num_vars; ++i) {
+        if (ancestor_values[split_vars[i]] != cached_keys[i])
+            return false;
+    }
+    return true;
+}
+
+int MultiAbstractionLookup::descend(int root, const vector<int> &values) const {
+    const FlatNode *node = &nodes[root];
+    while (node->var != UNDEFINED) {
+        int child = (values[node->var] == node->value) ?
+            node->right_child : node->left_child;
+        node = &nodes[child];
+    }
+    return node->value;
+}
+
+int MultiAbstractionLookup::compute_value(
+    int abstraction_id, const State &ancestor_state) {
+    AbstractionInfo &info = abstractions[abstraction_id];
+    const vector<int> &ancestor_values = ancestor_state.get_unpacked_values();
+    if (cache_hit(info, ancestor_values))
+        return info.cached_value;
+
+    int task_index = info.task_index;
+    if (!is_converted[task_index]) {
+        TaskProxy subtask_proxy(*tasks[task_index]);
+        State subtask_state = subtask_proxy.convert_ancestor_state(ancestor_state);
+        converted_values[task_index] = subtask_state.get_unpacked_values();
+        is_converted[task_index] = true;
+    }
+    info.cached_value = descend(info.root, converted_values[task_index]);
+    for (int i = info.vars_begin; i < info.vars_begin + info.num_vars; ++i) {
+        cached_keys[i] = ancestor_values[split_vars[i]];
+    }
+    info.cache_is_valid = true;
+    return info.cached_value;
+}
+
+void MultiAbstractionLookup::get_values(
+    const State &ancestor_state, vector<int> &values) {
+    ancestor_state.unpack();
+    values.resize(abstractions.size());
+    for (size_t i = 0; i < abstractions.size(); ++i) {
+        values[i] = compute_value(i, ancestor_state);
+    }
+    fill(is_converted.begin(), is_converted.end(), false);
+}
+
+int MultiAbstractionLookup::get_sum(const State &ancestor_state) {
+    ancestor_state.unpack();
+    int sum = 0;
+    for (size_t i = 0; i < abstractions.size(); ++i) {
+        int value = compute_value(i, ancestor_state);
+        assert(value >= 0);
+        if (value == INF) {
+            sum = INF;
+            break;
+        }
+        sum += value;
+    }
+    fill(is_converted.begin(), is_converted.end(), false);
+    return sum;
+}
+
+int MultiAbstractionLookup::get_max(const State &ancestor_state) {
+    ancestor_state.unpack();
+    int max_value = 0;
+    for (size_t i = 0; i < abstractions.size(); ++i) {
+        int value = compute_value(i, ancestor_state);
+        assert(value >= 0);
+        max_value = max(max_value, value);
+    }
+    fill(is_converted.begin(), is_converted.end(), false);
+    return max_value;
+}
+}
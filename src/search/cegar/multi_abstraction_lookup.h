@@ -0,0 +1,89 @@
+#ifndef CEGAR_MULTI_ABSTRACTION_LOOKUP_H
+#define CEGAR_MULTI_ABSTRACTION_LOOKUP_H
+
+#include <memory>
+#include <vector>
+
+class AbstractTask;
+class State;
+
+namespace cegar {
+class CartesianHeuristicFunction;
+
+/*
+  Look up the heuristic values of a collection of Cartesian abstractions
+  for a state in one pass.
+
+  The refinement hierarchies of all abstractions are copied into a single
+  contiguous array of 16-byte nodes whose leaves directly store the
+  heuristic value, so that each lookup is a short descent through one
+  array instead of a pointer-chasing walk followed by a second lookup in
+  the h-value table. A state is converted at most once per distinct
+  subtask.
+
+  Additionally, each abstraction remembers its last result together with
+  the values of the variables it splits on. If a state agrees with the
+  previous one on these variables (which is common for successors of the
+  same state), the descent is skipped entirely. This assumes that the
+  subtasks convert state values variable by variable, which holds for all
+  task transformations used by the CEGAR subtask generators.
+*/
+class MultiAbstractionLookup {
+    struct FlatNode {
+        // UNDEFINED for leaf nodes.
+        int var;
+        // Split value for inner nodes, heuristic value for leaf nodes.
+        int value;
+        int left_child;
+        int right_child;
+    };
+
+    struct AbstractionInfo {
+        int root;
+        int task_index;
+        // Position and number of split variables in split_vars.
+        int vars_begin;
+        int num_vars;
+        int cached_value;
+        bool cache_is_valid;
+    };
+
+    std::vector<FlatNode> nodes;
+    std::vector<AbstractionInfo> abstractions;
+    std::vector<std::shared_ptr<AbstractTask>> tasks;
+    std::vector<int> split_vars;
+    // Ancestor state values of split_vars belonging to the cached results.
+    std::vector<int> cached_keys;
+
+    // Scratch space for states converted to the subtasks.
+    std::vector<std::vector<int>> converted_values;
+    std::vector<bool> is_converted;
+
+    bool cache_hit(const AbstractionInfo &info,
+                   const std::vector<int> &ancestor_values) const;
+    int descend(int root, const std::vector<int> &values) const;
+    int compute_value(int abstraction_id, const State &ancestor_state);
+
+public:
+    explicit MultiAbstractionLookup(
+        const std::vector<CartesianHeuristicFunction> &functions);
+
+    /*
+      Store the heuristic value of each abstraction for the given state of
+      an ancestor task in values.
+    */
+    void get_values(const State &ancestor_state, std::vector<int> &values);
+
+    // Return the sum of all values or INF if one of them is INF.
+    int get_sum(const State &ancestor_state);
+
+    // Return the maximum of all values.
+    int get_max(const State &ancestor_state);
+
+    int get_num_abstractions() const {
+        return abstractions.size();
+    }
+};
+}
+
+#endif
@@ -48,6 +48,14 @@ public:
         int left_state_id, int right_state_id);
 
     int get_abstract_state_id(const State &state) const;
+
+    const std::shared_ptr<AbstractTask> &get_task() const {
+        return task;
+    }
+
+    const std::vector<Node> &get_nodes() const {
+        return nodes;
+    }
 };
 
 
@@ -90,6 +98,21 @@ public:
         return left_child;
     }
 
+    int get_split_value() const {
+        assert(is_split());
+        return value;
+    }
+
+    NodeID get_left_child() const {
+        assert(is_split());
+        return left_child;
+    }
+
+    NodeID get_right_child() const {
+        assert(is_split());
+        return right_child;
+    }
+
     int get_state_id() const {
         assert(!is_split());
         return state_id;
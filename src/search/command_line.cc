@@ -7,7 +7,10 @@
 #include "options/doc_printer.h"
 #include "options/predefinitions.h"
 #include "options/registries.h"
+#include "tasks/root_task.h"
+#include "utils/logging.h"
 #include "utils/strings.h"
+#include "utils/system.h"
 
 #include <algorithm>
 #include <vector>
@@ -44,6 +47,7 @@ static int parse_int_arg(const string &name, const string &value) {
 static shared_ptr<SearchEngine> parse_cmd_line_aux(
     const vector<string> &args, options::Registry &registry, bool dry_run) {
     string plan_filename = "sas_plan";
+    string binary_task_filename;
     int num_previously_generated_plans = 0;
     bool is_part_of_anytime_portfolio = false;
     options::Predefinitions predefinitions;
@@ -97,6 +101,11 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
                 throw ArgError("missing argument after --internal-plan-file");
             ++i;
             plan_filename = args[i];
+        } else if (arg == "--write-binary-task") {
+            if (is_last)
+                throw ArgError("missing argument after --write-binary-task");
+            ++i;
+            binary_task_filename = args[i];
         } else if (arg == "--internal-previous-portfolio-plans") {
             if (is_last)
                 throw ArgError("missing argument after --internal-previous-portfolio-plans");
@@ -118,6 +127,14 @@ static shared_ptr<SearchEngine> parse_cmd_line_aux(
         }
     }
 
+    if (!dry_run && !binary_task_filename.empty()) {
+        tasks::write_binary_root_task(binary_task_filename);
+        utils::g_log << "Wrote binary task file " << binary_task_filename << endl;
+        if (!engine) {
+            utils::exit_with(utils::ExitCode::SUCCESS);
+        }
+    }
+
     if (engine) {
         PlanManager &plan_manager = engine->get_plan_manager();
         plan_manager.set_plan_filename(plan_filename);
@@ -165,6 +182,10 @@ string usage(const string &progname) {
            "--evaluator EVALUATOR_PREDEFINITION\n"
            "    Predefines an evaluator that can afterwards be referenced\n"
            "    by the name that is specified in the definition.\n"
+           "--write-binary-task FILENAME\n"
+           "    Writes the task in a binary format to FILENAME. Binary task files\n"
+           "    are detected automatically when passed instead of OUTPUT and load\n"
+           "    much faster. Without --search, the planner exits afterwards.\n\n"
            "--internal-plan-file FILENAME\n"
            "    Plan will be output to a file called FILENAME\n\n"
            "--internal-previous-portfolio-plans COUNTER\n"
@@ -0,0 +1,169 @@
+#include "compressed_state_storage.h"
+
+#include "utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+static const StateIDValue NO_PARENT = -1;
+static const int NUM_ID_BINS =
+    sizeof(StateIDValue) / sizeof(int_packer::IntPacker::Bin);
+// Number of consecutive states whose record offsets share a base offset.
+static const StateIDValue OFFSET_BLOCK_SIZE = 64;
+
+CompressedStateStorage::CompressedStateStorage(
+    int num_bins, int max_chain_length, int cache_size)
+    : num_bins(num_bins),
+      max_chain_length(min(max_chain_length,
+                           static_cast<int>(numeric_limits<unsigned char>::max()))),
+      cache(cache_size, CacheEntry(-1, nullptr)),
+      num_cache_hits(0),
+      num_cache_misses(0) {
+    assert(cache_size >= 1);
+}
+
+void CompressedStateStorage::push_record_offset() {
+    StateIDValue id = relative_offsets.size();
+    size_t offset = records.size();
+    if (id % OFFSET_BLOCK_SIZE == 0) {
+        block_offsets.push_back(offset);
+    }
+    size_t relative_offset = offset - block_offsets[id / OFFSET_BLOCK_SIZE];
+    /* A block holds at most OFFSET_BLOCK_SIZE records of at most
+       NUM_ID_BINS + num_bins bins each, so this only fails for states
+       with tens of millions of bins. */
+    if (relative_offset > numeric_limits<uint32_t>::max()) {
+        cerr << "State too large for compressed state storage." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    relative_offsets.push_back(static_cast<uint32_t>(relative_offset));
+}
+
+size_t CompressedStateStorage::get_record_offset(StateIDValue id) const {
+    return block_offsets[id / OFFSET_BLOCK_SIZE] + relative_offsets[id];
+}
+
+const CompressedStateStorage::CacheEntry *CompressedStateStorage::find_in_cache(
+    StateIDValue id) const {
+    const CacheEntry &entry = cache[id % cache.size()];
+    if (entry.first == id) {
+        return &entry;
+    }
+    return nullptr;
+}
+
+void CompressedStateStorage::push_id(StateIDValue id) {
+    uint64_t bits = static_cast<uint64_t>(id);
+    for (int i = 0; i < NUM_ID_BINS; ++i) {
+        records.push_back(static_cast<Bin>(bits));
+        bits >>= 8 * sizeof(Bin);
+    }
+}
+
+StateIDValue CompressedStateStorage::read_id(size_t offset) const {
+    uint64_t bits = 0;
+    for (int i = NUM_ID_BINS - 1; i >= 0; --i) {
+        bits = (bits << (8 * sizeof(Bin))) | records[offset + i];
+    }
+    return static_cast<StateIDValue>(bits);
+}
+
+void CompressedStateStorage::push_checkpoint(const Bin *data) {
+    push_record_offset();
+    chain_lengths.push_back(0);
+    push_id(NO_PARENT);
+    for (int i = 0; i < num_bins; ++i) {
+        records.push_back(data[i]);
+    }
+}
+
+void CompressedStateStorage::push_back(const Bin *data, StateIDValue parent_id) {
+    if (parent_id < 0 || chain_lengths[parent_id] >= max_chain_length) {
+        push_checkpoint(data);
+        return;
+    }
+    shared_ptr<const Bin> parent_data = lookup(parent_id);
+    changes.clear();
+    for (int i = 0; i < num_bins; ++i) {
+        if (data[i] != parent_data.get()[i]) {
+            changes.emplace_back(i, data[i]);
+        }
+    }
+    // A delta record needs 1 + 2k bins more than its ID, a checkpoint n bins.
+    if (2 * static_cast<int>(changes.size()) + 1 >= num_bins) {
+        push_checkpoint(data);
+        return;
+    }
+    push_record_offset();
+    chain_lengths.push_back(chain_lengths[parent_id] + 1);
+    push_id(parent_id);
+    records.push_back(changes.size());
+    for (const pair<int, Bin> &change : changes) {
+        records.push_back(change.first);
+        records.push_back(change.second);
+    }
+}
+
+shared_ptr<const CompressedStateStorage::Bin> CompressedStateStorage::lookup(
+    StateIDValue id) const {
+    assert(id >= 0 && id < static_cast<StateIDValue>(size()));
+    const CacheEntry *cached = find_in_cache(id);
+    if (cached) {
+        ++num_cache_hits;
+        return cached->second;
+    }
+    ++num_cache_misses;
+
+    /* Collect the delta records from the given state up to the closest
+       checkpoint or cached ancestor. */
+    chain.clear();
+    StateIDValue current_id = id;
+    shared_ptr<vector<Bin>> values = make_shared<vector<Bin>>(num_bins);
+    while (true) {
+        const CacheEntry *cached_ancestor =
+            (current_id == id) ? nullptr : find_in_cache(current_id);
+        if (cached_ancestor) {
+            const Bin *ancestor_data = cached_ancestor->second.get();
+            copy(ancestor_data, ancestor_data + num_bins, values->begin());
+            break;
+        }
+        size_t offset = get_record_offset(current_id);
+        StateIDValue parent = read_id(offset);
+        if (parent == NO_PARENT) {
+            for (int i = 0; i < num_bins; ++i) {
+                (*values)[i] = records[offset + NUM_ID_BINS + i];
+            }
+            break;
+        }
+        chain.push_back(current_id);
+        current_id = parent;
+    }
+
+    // Apply the deltas starting with the oldest one.
+    for (auto it = chain.rbegin(); it != chain.rend(); ++it) {
+        size_t offset = get_record_offset(*it);
+        offset += NUM_ID_BINS;
+        int num_changes = records[offset];
+        for (int i = 0; i < num_changes; ++i) {
+            int bin_index = records[offset + 1 + 2 * i];
+            (*values)[bin_index] = records[offset + 2 + 2 * i];
+        }
+    }
+
+    // Share ownership of the vector but point directly to its data.
+    shared_ptr<const Bin> data(values, values->data());
+    cache[id % cache.size()] = CacheEntry(id, data);
+    return data;
+}
+
+size_t CompressedStateStorage::get_memory_in_bytes() const {
+    return records.size() * sizeof(Bin) +
+           block_offsets.size() * sizeof(size_t) +
+           relative_offsets.size() * sizeof(uint32_t) +
+           chain_lengths.size() * sizeof(unsigned char);
+}
@@ -0,0 +1,96 @@
+#ifndef COMPRESSED_STATE_STORAGE_H
+#define COMPRESSED_STATE_STORAGE_H
+
+#include "state_id.h"
+
+#include "algorithms/int_packer.h"
+#include "algorithms/segmented_vector.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+/*
+  Memory-efficient alternative to storing the packed data of each
+  registered state in a SegmentedArrayVector (see state_registry.h).
+
+  Each state is stored either as a full checkpoint or as a delta to its
+  parent state, i.e., the list of bins that differ from the parent. To
+  bound the cost of reconstructing a state, chains of deltas are cut off
+  by a checkpoint after at most max_chain_length deltas. States are
+  decompressed into shared buffers that are kept in a small direct-mapped
+  cache, so that repeated lookups of hot states (e.g., the state that is
+  currently expanded) are cheap.
+
+  Since search successors typically differ from their parent in only a
+  few bins, this uses a fraction of the memory for tasks with many bins
+  per state in exchange for extra CPU time on lookups.
+*/
+class CompressedStateStorage {
+    using Bin = int_packer::IntPacker::Bin;
+
+    const int num_bins;
+    const int max_chain_length;
+
+    /*
+      A checkpoint record is [NO_PARENT, bin_1, ..., bin_n], a delta record
+      is [parent_id, k, index_1, bin_1, ..., index_k, bin_k]. With wide
+      state IDs, NO_PARENT and parent_id occupy NUM_ID_BINS bins.
+    */
+    segmented_vector::SegmentedVector<Bin> records;
+    /*
+      The record of state id starts at position
+      block_offsets[id / OFFSET_BLOCK_SIZE] + relative_offsets[id] of
+      records. This needs 4 bytes per state (plus 8 bytes per block)
+      instead of 8 bytes for a full offset per state.
+    */
+    segmented_vector::SegmentedVector<size_t> block_offsets;
+    segmented_vector::SegmentedVector<std::uint32_t> relative_offsets;
+    segmented_vector::SegmentedVector<unsigned char> chain_lengths;
+
+    using CacheEntry = std::pair<StateIDValue, std::shared_ptr<const Bin>>;
+    mutable std::vector<CacheEntry> cache;
+    mutable std::vector<StateIDValue> chain;
+    mutable std::int64_t num_cache_hits;
+    mutable std::int64_t num_cache_misses;
+
+    // Scratch space for computing deltas.
+    std::vector<std::pair<int, Bin>> changes;
+
+    // Start the record of the next state at the end of records.
+    void push_record_offset();
+    std::size_t get_record_offset(StateIDValue id) const;
+    const CacheEntry *find_in_cache(StateIDValue id) const;
+    void push_id(StateIDValue id);
+    StateIDValue read_id(size_t offset) const;
+    void push_checkpoint(const Bin *data);
+public:
+    CompressedStateStorage(int num_bins, int max_chain_length, int cache_size);
+
+    /*
+      Store the given state data. If parent_id refers to a stored state,
+      the data is stored relative to the parent state if this saves memory.
+      Use parent_id = -1 for states without a parent.
+    */
+    void push_back(const Bin *data, StateIDValue parent_id);
+
+    // Return a buffer with the data of the state with the given ID.
+    std::shared_ptr<const Bin> lookup(StateIDValue id) const;
+
+    size_t size() const {
+        return relative_offsets.size();
+    }
+
+    size_t get_memory_in_bytes() const;
+
+    std::int64_t get_num_cache_hits() const {
+        return num_cache_hits;
+    }
+
+    std::int64_t get_num_cache_misses() const {
+        return num_cache_misses;
+    }
+};
+
+#endif
@@ -5,6 +5,7 @@
 namespace conflict_driven_learning {
 
 HeuristicRefiner::HeuristicRefiner()
+    : m_telemetry("heuristic_refinement")
 {
     m_refinement_timer.stop();
     m_refinement_timer.reset();
@@ -52,6 +53,7 @@ HeuristicRefiner::notify(
         m_initialized = true;
         initialize();
     }
+    utils::TelemetryTimer telemetry_timer(m_telemetry);
     m_refinement_timer.resume();
     bool res = refine_heuristic(bound, component, recognized_neighbors);
     m_refinement_timer.stop();
@@ -3,6 +3,7 @@
 
 #include "state_component.h"
 #include "../evaluator.h"
+#include "../utils/telemetry.h"
 #include "../utils/timer.h"
 
 #include <memory>
@@ -14,6 +15,7 @@ class HeuristicRefiner
 private:
     bool m_initialized;
     utils::Timer m_refinement_timer;
+    utils::TelemetryHandle m_telemetry;
 protected:
     virtual bool refine_heuristic(int bound,
                                   StateComponent& component,
@@ -4,6 +4,8 @@
 #include "evaluator.h"
 #include "search_statistics.h"
 
+#include "utils/telemetry.h"
+
 #include <cassert>
 
 using namespace std;
@@ -45,7 +47,10 @@ EvaluationContext::EvaluationContext(
 const EvaluationResult &EvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
-        result = evaluator->compute_result(*this);
+        {
+            utils::TelemetryTimer timer(evaluator->get_telemetry_handle());
+            result = evaluator->compute_result(*this);
+        }
         if (statistics &&
             evaluator->is_used_for_counting_evaluations() &&
             result.get_count_evaluation()) {
@@ -0,0 +1,104 @@
+#include "evaluation_pipeline.h"
+
+#include "option_parser.h"
+
+#include "utils/logging.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+static const int REORDERING_INTERVAL = 1000;
+
+double EvaluationPipeline::Stage::get_time_per_rejection() const {
+    // Try stages without measurements first.
+    if (num_calls == 0) {
+        return 0;
+    } else if (num_rejections == 0) {
+        return numeric_limits<double>::infinity();
+    }
+    return chrono::duration<double>(time).count() / num_rejections;
+}
+
+EvaluationPipeline::EvaluationPipeline(
+    const options::Options &opts, const utils::LogProxy &log)
+    : adaptive(opts.get<bool>("adaptive_evaluation_order")),
+      time_stages(adaptive || log.is_at_least_verbose()),
+      num_runs_until_reordering(REORDERING_INTERVAL),
+      num_reorderings(0) {
+}
+
+int EvaluationPipeline::add_stage(const string &name) {
+    int stage_id = stages.size();
+    stages.emplace_back(name);
+    order.push_back(stage_id);
+    return stage_id;
+}
+
+void EvaluationPipeline::reorder() {
+    /*
+      The expected time per rejection is (time / calls) / (rejections / calls),
+      i.e., the total time of the stage divided by its number of rejections.
+      Break ties in favor of the order in which the stages were added.
+    */
+    vector<double> time_per_rejection;
+    time_per_rejection.reserve(stages.size());
+    for (const Stage &stage : stages) {
+        time_per_rejection.push_back(stage.get_time_per_rejection());
+    }
+    vector<int> new_order(stages.size());
+    for (size_t i = 0; i < new_order.size(); ++i) {
+        new_order[i] = i;
+    }
+    stable_sort(new_order.begin(), new_order.end(),
+                [&](int lhs, int rhs) {
+                    return time_per_rejection[lhs] < time_per_rejection[rhs];
+                });
+    if (new_order != order) {
+        order.swap(new_order);
+        ++num_reorderings;
+    }
+}
+
+void EvaluationPipeline::finish_run() {
+    if (adaptive && --num_runs_until_reordering == 0) {
+        reorder();
+        num_runs_until_reordering = REORDERING_INTERVAL;
+    }
+}
+
+void EvaluationPipeline::print_statistics(utils::LogProxy &log) const {
+    if (stages.empty() || !log.is_at_least_verbose()) {
+        return;
+    }
+    // Stage times include the shared evaluator values each stage computed first.
+    for (const Stage &stage : stages) {
+        log << "Evaluation stage " << stage.name << ": "
+            << stage.num_rejections << "/" << stage.num_calls
+            << " states rejected in "
+            << chrono::duration<double>(stage.time).count() << "s" << endl;
+    }
+    if (adaptive) {
+        log << "Evaluation stage order:";
+        for (int stage_id : order) {
+            log << " " << stages[stage_id].name;
+        }
+        log << " (reordered " << num_reorderings << " times)" << endl;
+    }
+}
+
+void add_evaluation_pipeline_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<bool>(
+        "adaptive_evaluation_order",
+        "run the checks that can reject a newly generated state (e.g., "
+        "dead-end detection and state pruning) in the order of their measured "
+        "time per rejected state instead of a fixed order. Statistics about "
+        "all checks are reported in both cases if the verbosity is at least "
+        "verbose. The time of a check includes the evaluators it calls. "
+        "Evaluator values are cached per state, so if several checks use "
+        "the same evaluator object (e.g., a predefined evaluator), the first "
+        "check that runs is charged its full cost. Use separate evaluator "
+        "objects in the checks for meaningful timings and orders.",
+        "false");
+}
@@ -0,0 +1,113 @@
+#ifndef EVALUATION_PIPELINE_H
+#define EVALUATION_PIPELINE_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace utils {
+class LogProxy;
+}
+
+/*
+  Runs a sequence of filters on a newly generated state (e.g., dead-end
+  detection via the open list evaluators or state pruning) and stops at
+  the first filter that rejects the state. Filters are identified by the
+  stage IDs returned by add_stage.
+
+  Filters must not depend on each other, so that they can be run in any
+  order. If the order is adaptive, the stages are periodically sorted by
+  their measured time per rejected state (average time divided by the
+  rejection rate), which is the optimal order for independent filters.
+  Otherwise, the stages are run in the order they were added.
+
+  Stages are only timed if the order is adaptive or the log is at least
+  verbose, and statistics are only printed for verbose logs.
+
+  A stage is timed as a whole, including the evaluators it calls. If two
+  stages use the same evaluator object (e.g., a predefined heuristic that
+  is also wrapped by another evaluator), its value is cached in the
+  evaluation context, so the stage that runs first is charged the full
+  cost of the shared evaluator and later stages get it for free. The
+  stage timings and the adaptive order are therefore only meaningful for
+  stages that use separate evaluator objects.
+
+  Usage:
+
+    int rejecting_stage = pipeline.run([&](int stage) -> bool {
+        return stage == dead_end_stage ? is_dead_end(...) : prune(...);
+    });
+*/
+class EvaluationPipeline {
+    using Clock = std::chrono::steady_clock;
+
+    struct Stage {
+        std::string name;
+        int64_t num_calls;
+        int64_t num_rejections;
+        Clock::duration time;
+
+        explicit Stage(const std::string &name)
+            : name(name), num_calls(0), num_rejections(0), time(0) {
+        }
+
+        double get_time_per_rejection() const;
+    };
+
+    const bool adaptive;
+    const bool time_stages;
+    std::vector<Stage> stages;
+    std::vector<int> order;
+    int num_runs_until_reordering;
+    int num_reorderings;
+
+    void reorder();
+    void finish_run();
+public:
+    EvaluationPipeline(const options::Options &opts,
+                       const utils::LogProxy &log);
+
+    // Append a stage and return its ID.
+    int add_stage(const std::string &name);
+
+    /*
+      Call is_rejected_by(stage) for the stages in the current order until
+      it returns true. Return the ID of the rejecting stage or -1 if no
+      stage rejects the state.
+    */
+    template<typename Filter>
+    int run(const Filter &is_rejected_by) {
+        for (int stage_id : order) {
+            Stage &stage = stages[stage_id];
+            bool rejected;
+            if (time_stages) {
+                Clock::time_point start = Clock::now();
+                rejected = is_rejected_by(stage_id);
+                stage.time += Clock::now() - start;
+            } else {
+                rejected = is_rejected_by(stage_id);
+            }
+            ++stage.num_calls;
+            if (rejected) {
+                ++stage.num_rejections;
+                finish_run();
+                return stage_id;
+            }
+        }
+        finish_run();
+        return -1;
+    }
+
+    void print_statistics(utils::LogProxy &log) const;
+};
+
+extern void add_evaluation_pipeline_options_to_parser(
+    options::OptionParser &parser);
+
+#endif
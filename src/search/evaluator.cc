@@ -18,9 +18,14 @@ Evaluator::Evaluator(const options::Options &opts,
       use_for_reporting_minima(use_for_reporting_minima),
       use_for_boosting(use_for_boosting),
       use_for_counting_evaluations(use_for_counting_evaluations),
+      telemetry("evaluator " + description),
       log(utils::get_log_from_options(opts)) {
 }
 
+utils::TelemetryHandle &Evaluator::get_telemetry_handle() {
+    return telemetry;
+}
+
 bool Evaluator::dead_ends_are_reliable() const {
     return true;
 }
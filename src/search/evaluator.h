@@ -5,6 +5,7 @@
 #include "xaip/explicit_mugs_search/msgs_evaluation_context.h"
 
 #include "../utils/logging.h"
+#include "../utils/telemetry.h"
 
 #include <set>
 
@@ -21,6 +22,7 @@ class Evaluator {
     const bool use_for_reporting_minima;
     const bool use_for_boosting;
     const bool use_for_counting_evaluations;
+    utils::TelemetryHandle telemetry;
 protected:
     mutable utils::LogProxy log;
 public:
@@ -91,6 +93,8 @@ public:
     bool is_used_for_reporting_minima() const;
     bool is_used_for_boosting() const;
     bool is_used_for_counting_evaluations() const;
+    // Telemetry component for the time spent in compute_result.
+    utils::TelemetryHandle &get_telemetry_handle();
 
     virtual bool does_cache_estimates() const;
     virtual bool is_estimate_cached(const State &state) const;
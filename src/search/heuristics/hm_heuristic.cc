@@ -5,26 +5,146 @@
 
 #include "../task_utils/task_properties.h"
 #include "../utils/logging.h"
+#include "../utils/system.h"
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
 #include <limits>
-#include <set>
 
 using namespace std;
 
 namespace hm_heuristic {
+template<typename Callback>
+static bool for_each_subtuple_from(
+    const vector<int> &facts, int max_size, vector<int> &subtuple,
+    size_t pos, const Callback &callback) {
+    for (size_t i = pos; i < facts.size(); ++i) {
+        subtuple.push_back(facts[i]);
+        bool go_on = callback(subtuple) &&
+            (static_cast<int>(subtuple.size()) == max_size ||
+             for_each_subtuple_from(facts, max_size, subtuple, i + 1, callback));
+        subtuple.pop_back();
+        if (!go_on) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+  Call callback for the nonempty subtuples of at most max_size of the given
+  sorted facts until it returns false. Return false if it was stopped. The
+  subtuples are built in the given buffer to avoid allocations.
+*/
+template<typename Callback>
+static bool for_each_subtuple(
+    const vector<int> &facts, int max_size, vector<int> &buffer,
+    const Callback &callback) {
+    buffer.clear();
+    if (max_size <= 0) {
+        return true;
+    }
+    return for_each_subtuple_from(facts, max_size, buffer, 0, callback);
+}
+
 HMHeuristic::HMHeuristic(const Options &opts)
     : Heuristic(opts),
       m(opts.get<int>("m")),
       has_cond_effects(task_properties::has_conditional_effects(task_proxy)),
-      goals(task_properties::get_fact_pairs(task_proxy.get_goals())) {
+      num_facts(0),
+      num_visits(0) {
     if (log.is_at_least_normal()) {
         log << "Using h^" << m << "." << endl;
-        log << "The implementation of the h^m heuristic is preliminary." << endl
-            << "It is SLOOOOOOOOOOOW." << endl
-            << "Please do not use this for comparison!" << endl;
     }
-    generate_all_tuples();
+    for (VariableProxy var : task_proxy.get_variables()) {
+        fact_offsets.push_back(num_facts);
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            fact_vars.push_back(var.get_id());
+        }
+        num_facts += var.get_domain_size();
+    }
+
+    // Rank the tuples of size k with the combinatorial number system.
+    const size_t max_size = numeric_limits<size_t>::max();
+    binomials.resize(m + 1, vector<size_t>(num_facts + 1, 0));
+    for (int n = 0; n <= num_facts; ++n) {
+        binomials[0][n] = 1;
+        for (int k = 1; k <= m && k <= n; ++k) {
+            size_t with_n = binomials[k - 1][n - 1];
+            size_t without_n = binomials[k][n - 1];
+            if (with_n > max_size - without_n) {
+                cerr << "h^" << m << " table is too large" << endl;
+                utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+            }
+            binomials[k][n] = with_n + without_n;
+        }
+    }
+    tuple_offsets.assign(m + 2, 0);
+    for (int k = 1; k <= m; ++k) {
+        if (binomials[k][num_facts] > max_size - tuple_offsets[k]) {
+            cerr << "h^" << m << " table is too large" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_OUT_OF_MEMORY);
+        }
+        tuple_offsets[k + 1] = tuple_offsets[k] + binomials[k][num_facts];
+    }
+    size_t num_tuples = tuple_offsets[m + 1];
+    hm_table.resize(num_tuples);
+    closed.resize(num_tuples);
+    if (log.is_at_least_normal()) {
+        log << "Number of h^" << m << " table entries: " << num_tuples << endl;
+    }
+
+    precondition_of.resize(num_facts);
+    closed_partners.resize(num_facts);
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        HMOperator hm_op;
+        hm_op.cost = op.get_cost();
+        for (FactProxy pre : op.get_preconditions()) {
+            hm_op.pre.push_back(get_fact_id(pre.get_pair()));
+        }
+        sort(hm_op.pre.begin(), hm_op.pre.end());
+        for (EffectProxy eff : op.get_effects()) {
+            hm_op.eff.push_back(get_fact_id(eff.get_fact().get_pair()));
+        }
+        sort(hm_op.eff.begin(), hm_op.eff.end());
+        hm_op.eff.erase(unique(hm_op.eff.begin(), hm_op.eff.end()),
+                        hm_op.eff.end());
+        for (int pre : hm_op.pre) {
+            if (none_of(hm_op.eff.begin(), hm_op.eff.end(), [&](int eff) {
+                            return fact_vars[eff] == fact_vars[pre];
+                        })) {
+                hm_op.prevail.push_back(pre);
+            }
+        }
+        hm_op.num_precondition_tuples = 0;
+        for_each_subtuple(hm_op.pre, m, subtuple_buffer, [&](const Tuple &) -> bool {
+                              ++hm_op.num_precondition_tuples;
+                              return true;
+                          });
+        hm_op.num_unsatisfied = 0;
+        hm_op.last_visit = -1;
+        for (int fact : hm_op.pre) {
+            precondition_of[fact].push_back(operators.size());
+        }
+        if (hm_op.pre.empty()) {
+            operators_without_precondition.push_back(operators.size());
+        }
+        operators.push_back(move(hm_op));
+    }
+
+    Tuple goals;
+    for (FactProxy goal : task_proxy.get_goals()) {
+        goals.push_back(get_fact_id(goal.get_pair()));
+    }
+    sort(goals.begin(), goals.end());
+    is_goal_tuple.resize(num_tuples, false);
+    num_goal_tuples = 0;
+    for_each_subtuple(goals, m, subtuple_buffer, [&](const Tuple &tuple) -> bool {
+                          is_goal_tuple[get_tuple_index(tuple)] = true;
+                          ++num_goal_tuples;
+                          return true;
+                      });
 }
 
 
@@ -33,17 +153,59 @@ bool HMHeuristic::dead_ends_are_reliable() const {
 }
 
 
+int HMHeuristic::get_fact_id(const FactPair &fact) const {
+    return fact_offsets[fact.var] + fact.value;
+}
+
+
+size_t HMHeuristic::get_tuple_index(const Tuple &tuple) const {
+    assert(!tuple.empty() && static_cast<int>(tuple.size()) <= m);
+    size_t index = tuple_offsets[tuple.size()];
+    for (size_t i = 0; i < tuple.size(); ++i) {
+        index += binomials[i + 1][tuple[i]];
+    }
+    return index;
+}
+
+
+size_t HMHeuristic::get_pair_index(int fact1, int fact2) const {
+    assert(m >= 2 && fact1 != fact2);
+    if (fact1 > fact2) {
+        swap(fact1, fact2);
+    }
+    return tuple_offsets[2] + binomials[1][fact1] + binomials[2][fact2];
+}
+
+
+void HMHeuristic::get_tuple(size_t index, Tuple &tuple) const {
+    int size = 1;
+    while (tuple_offsets[size + 1] <= index) {
+        ++size;
+    }
+    size_t rank = index - tuple_offsets[size];
+    tuple.resize(size);
+    for (int k = size; k >= 1; --k) {
+        // Find the largest fact f with (f choose k) <= rank.
+        const vector<size_t> &column = binomials[k];
+        int fact = upper_bound(column.begin(), column.begin() + num_facts,
+                               rank) - column.begin() - 1;
+        tuple[k - 1] = fact;
+        rank -= column[fact];
+    }
+}
+
+
 int HMHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     if (task_properties::is_goal_state(task_proxy, state)) {
         return 0;
     } else {
-        Tuple s_tup = task_properties::get_fact_pairs(state);
-
-        init_hm_table(s_tup);
-        update_hm_table();
+        Tuple state_facts;
+        for (FactProxy fact : state) {
+            state_facts.push_back(get_fact_id(fact.get_pair()));
+        }
 
-        int h = eval(goals);
+        int h = compute_goal_value(state_facts);
 
         if (h == numeric_limits<int>::max())
             return DEAD_END;
@@ -52,216 +214,270 @@ int HMHeuristic::compute_heuristic(const State &ancestor_state) {
 }
 
 
-void HMHeuristic::init_hm_table(const Tuple &t) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        int h_val = check_tuple_in_tuple(tuple, t);
-        hm_table[tuple] = h_val;
+void HMHeuristic::enqueue_if_cheaper(const Tuple &tuple, int cost) {
+    size_t index = get_tuple_index(tuple);
+    if (!closed[index] && cost < hm_table[index]) {
+        hm_table[index] = cost;
+        queue.emplace(cost, tuple.size(), index);
     }
 }
 
 
-void HMHeuristic::update_hm_table() {
-    int round = 0;
-    do {
-        ++round;
-        was_updated = false;
-
-        for (OperatorProxy op : task_proxy.get_operators()) {
-            Tuple pre = get_operator_pre(op);
-
-            int c1 = eval(pre);
-            if (c1 != numeric_limits<int>::max()) {
-                Tuple eff = get_operator_eff(op);
-                vector<Tuple> partial_effs;
-                generate_all_partial_tuples(eff, partial_effs);
-                for (Tuple &partial_eff : partial_effs) {
-                    update_hm_entry(partial_eff, c1 + op.get_cost());
+int HMHeuristic::compute_goal_value(const Tuple &state_facts) {
+    fill(hm_table.begin(), hm_table.end(), numeric_limits<int>::max());
+    fill(closed.begin(), closed.end(), false);
+    closed_facts.clear();
+    for (vector<int> &partners : closed_partners) {
+        partners.clear();
+    }
+    queue = TupleQueue();
+    num_visits = 0;
+
+    for_each_subtuple(state_facts, m, subtuple_buffer, [&](const Tuple &tuple) -> bool {
+                          enqueue_if_cheaper(tuple, 0);
+                          return true;
+                      });
+    for (HMOperator &op : operators) {
+        op.num_unsatisfied = op.num_precondition_tuples;
+        op.last_visit = -1;
+    }
+    for (int op_id : operators_without_precondition) {
+        apply_operator(operators[op_id], Tuple(), 0);
+    }
 
-                    int eff_size = partial_eff.size();
-                    if (eff_size < m) {
-                        extend_tuple(partial_eff, op);
-                    }
-                }
-            }
+    int num_open_goal_tuples = num_goal_tuples;
+    Tuple tuple;
+    while (!queue.empty()) {
+        int value = get<0>(queue.top());
+        size_t index = get<2>(queue.top());
+        queue.pop();
+        if (closed[index] || hm_table[index] < value) {
+            continue;
         }
-    } while (was_updated);
+        closed[index] = true;
+        // Tuples are closed in order of increasing value.
+        if (is_goal_tuple[index] && --num_open_goal_tuples == 0) {
+            return value;
+        }
+        get_tuple(index, tuple);
+        if (tuple.size() == 1) {
+            closed_facts.push_back(tuple[0]);
+        } else if (tuple.size() == 2) {
+            closed_partners[tuple[0]].push_back(tuple[1]);
+            closed_partners[tuple[1]].push_back(tuple[0]);
+        }
+        close_tuple(tuple, value);
+    }
+    return numeric_limits<int>::max();
 }
 
 
-void HMHeuristic::extend_tuple(const Tuple &t, const OperatorProxy &op) {
-    for (auto &hm_ent : hm_table) {
-        const Tuple &tuple = hm_ent.first;
-        bool contradict = false;
-        for (const FactPair &fact : tuple) {
-            if (contradict_effect_of(op, fact.var, fact.value)) {
-                contradict = true;
-                break;
+void HMHeuristic::close_tuple(const Tuple &tuple, int value) {
+    ++num_visits;
+    for (int fact : tuple) {
+        for (int op_id : precondition_of[fact]) {
+            if (operators[op_id].last_visit != num_visits) {
+                operators[op_id].last_visit = num_visits;
+                process_operator(op_id, tuple, value);
             }
         }
-        if (!contradict && (tuple.size() > t.size()) && (check_tuple_in_tuple(t, tuple) == 0)) {
-            Tuple pre = get_operator_pre(op);
-
-            Tuple others;
-            for (const FactPair &fact : tuple) {
-                if (find(t.begin(), t.end(), fact) == t.end()) {
-                    others.push_back(fact);
-                    if (find(pre.begin(), pre.end(), fact) == pre.end()) {
-                        pre.push_back(fact);
-                    }
-                }
-            }
-
-            sort(pre.begin(), pre.end());
-
-            set<int> vars;
-            bool is_valid = true;
-            for (const FactPair &fact : pre) {
-                if (vars.count(fact.var) != 0) {
-                    is_valid = false;
-                    break;
-                }
-                vars.insert(fact.var);
-            }
-
-            if (is_valid) {
-                int c2 = eval(pre);
-                if (c2 != numeric_limits<int>::max()) {
-                    update_hm_entry(tuple, c2 + op.get_cost());
-                }
+    }
+    /*
+      h^m values are monotone (subtuples have lower or equal values) and
+      tuples with equal values are closed in order of increasing size, so
+      the tuple that completes the requirements of a pair (o, O) is
+      inclusion-maximal among them. Unless pre(o) is empty, it therefore
+      contains a precondition fact and o was visited above.
+    */
+    if (static_cast<int>(tuple.size()) < m) {
+        for (int op_id : operators_without_precondition) {
+            if (operators[op_id].last_visit != num_visits) {
+                operators[op_id].last_visit = num_visits;
+                process_operator(op_id, tuple, value);
             }
         }
     }
 }
 
 
-int HMHeuristic::eval(const Tuple &t) const {
-    vector<Tuple> partial;
-    generate_all_partial_tuples(t, partial);
-    int max = 0;
-    for (Tuple &tuple : partial) {
-        assert(hm_table.count(tuple) == 1);
-
-        int h = hm_table.at(tuple);
-        if (h > max) {
-            max = h;
+void HMHeuristic::process_operator(int op_id, const Tuple &tuple, int value) {
+    HMOperator &op = operators[op_id];
+    Tuple &extension = extension_buffer;
+    extension.clear();
+    if (op.num_unsatisfied > 0) {
+        // Only precondition tuples matter until the operator is applicable.
+        for (int fact : tuple) {
+            if (!binary_search(op.pre.begin(), op.pre.end(), fact)) {
+                return;
+            }
+        }
+        if (--op.num_unsatisfied == 0) {
+            apply_operator(op, extension, value);
+            // Apply all extensions whose tuples were closed before.
+            apply_extensions(op, extension, get_extension_candidates(op), 0, value);
         }
+        return;
+    }
+    for (int fact : tuple) {
+        if (!binary_search(op.pre.begin(), op.pre.end(), fact)) {
+            if (!can_extend(op, extension, fact)) {
+                return;
+            }
+            extension.push_back(fact);
+        }
+    }
+    // Precondition tuples were closed before the operator became applicable.
+    assert(!extension.empty());
+    if (static_cast<int>(extension.size()) < m) {
+        apply_extensions(op, extension, get_extension_candidates(op), 0, value);
     }
-    return max;
 }
 
 
-int HMHeuristic::update_hm_entry(const Tuple &t, int val) {
-    assert(hm_table.count(t) == 1);
-    if (hm_table[t] > val) {
-        hm_table[t] = val;
-        was_updated = true;
+const vector<int> &HMHeuristic::get_extension_candidates(
+    const HMOperator &op) const {
+    /*
+      All facts of a valid extension form closed pairs with each
+      precondition fact, so it suffices to consider the closed partners of
+      the precondition fact with the fewest of them.
+    */
+    if (op.pre.empty()) {
+        return closed_facts;
     }
-    return val;
+    const vector<int> *candidates = &closed_partners[op.pre[0]];
+    for (int fact : op.pre) {
+        if (closed_partners[fact].size() < candidates->size()) {
+            candidates = &closed_partners[fact];
+        }
+    }
+    return *candidates;
 }
 
 
-int HMHeuristic::check_tuple_in_tuple(
-    const Tuple &tuple, const Tuple &big_tuple) const {
-    for (const FactPair &fact0 : tuple) {
-        bool found = false;
-        for (auto &fact1 : big_tuple) {
-            if (fact0 == fact1) {
-                found = true;
-                break;
-            }
+bool HMHeuristic::can_extend(
+    const HMOperator &op, const Tuple &extension, int fact) const {
+    /*
+      Facts on precondition variables are either required or contradict the
+      precondition (prevail facts are added by apply_operator). Facts on
+      effect variables are either contradicted by the operator or achieved
+      by it, and in the latter case the extension without them achieves the
+      same tuples with weaker requirements.
+    */
+    int var = fact_vars[fact];
+    for (int pre : op.pre) {
+        if (fact_vars[pre] == var) {
+            return false;
         }
-        if (!found) {
-            return numeric_limits<int>::max();
+    }
+    for (int eff : op.eff) {
+        if (fact_vars[eff] == var) {
+            return false;
         }
     }
-    return 0;
-}
-
-
-HMHeuristic::Tuple HMHeuristic::get_operator_pre(const OperatorProxy &op) const {
-    Tuple preconditions = task_properties::get_fact_pairs(op.get_preconditions());
-    sort(preconditions.begin(), preconditions.end());
-    return preconditions;
-}
-
-
-HMHeuristic::Tuple HMHeuristic::get_operator_eff(const OperatorProxy &op) const {
-    Tuple effects;
-    for (EffectProxy eff : op.get_effects()) {
-        effects.push_back(eff.get_fact().get_pair());
+    for (int other : extension) {
+        if (fact_vars[other] == var) {
+            return false;
+        }
     }
-    sort(effects.begin(), effects.end());
-    return effects;
+    return true;
 }
 
 
-bool HMHeuristic::contradict_effect_of(
-    const OperatorProxy &op, int var, int val) const {
-    for (EffectProxy eff : op.get_effects()) {
-        FactProxy fact = eff.get_fact();
-        if (fact.get_variable().get_id() == var && fact.get_value() != val) {
-            return true;
+void HMHeuristic::apply_extensions(
+    const HMOperator &op, Tuple &extension, const vector<int> &candidates,
+    size_t next_candidate, int value) {
+    if (!extension.empty()) {
+        Tuple &sorted_extension = sorted_extension_buffer;
+        sorted_extension.assign(extension.begin(), extension.end());
+        sort(sorted_extension.begin(), sorted_extension.end());
+        /*
+          The tuples required by a superset of the extension include the
+          tuples required by the extension.
+        */
+        if (!are_extension_tuples_closed(op, sorted_extension)) {
+            return;
         }
+        apply_operator(op, sorted_extension, value);
     }
-    return false;
-}
-
-
-void HMHeuristic::generate_all_tuples() {
-    Tuple t;
-    generate_all_tuples_aux(0, m, t);
-}
-
-
-void HMHeuristic::generate_all_tuples_aux(int var, int sz, const Tuple &base) {
-    int num_variables = task_proxy.get_variables().size();
-    for (int i = var; i < num_variables; ++i) {
-        int domain_size = task_proxy.get_variables()[i].get_domain_size();
-        for (int j = 0; j < domain_size; ++j) {
-            Tuple tuple(base);
-            tuple.emplace_back(i, j);
-            hm_table[tuple] = 0;
-            if (sz > 1) {
-                generate_all_tuples_aux(i + 1, sz - 1, tuple);
-            }
+    if (static_cast<int>(extension.size()) == m - 1) {
+        return;
+    }
+    for (size_t i = next_candidate; i < candidates.size(); ++i) {
+        int fact = candidates[i];
+        if (can_extend(op, extension, fact)) {
+            extension.push_back(fact);
+            apply_extensions(op, extension, candidates, i + 1, value);
+            extension.pop_back();
         }
     }
 }
 
 
-void HMHeuristic::generate_all_partial_tuples(
-    const Tuple &base_tuple, vector<Tuple> &res) const {
-    Tuple t;
-    generate_all_partial_tuples_aux(base_tuple, t, 0, m, res);
-}
-
-
-void HMHeuristic::generate_all_partial_tuples_aux(
-    const Tuple &base_tuple, const Tuple &t, int index, int sz, vector<Tuple> &res) const {
-    if (sz == 1) {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-        }
-    } else {
-        for (size_t i = index; i < base_tuple.size(); ++i) {
-            Tuple tuple(t);
-            tuple.push_back(base_tuple[i]);
-            res.push_back(tuple);
-            generate_all_partial_tuples_aux(base_tuple, tuple, i + 1, sz - 1, res);
+bool HMHeuristic::are_extension_tuples_closed(
+    const HMOperator &op, const Tuple &extension) {
+    if (m >= 2) {
+        // Pairs of an extension fact and a precondition fact rule out most
+        // extensions and are cheap to look up.
+        for (int fact : extension) {
+            for (int pre : op.pre) {
+                if (!closed[get_pair_index(fact, pre)]) {
+                    return false;
+                }
+            }
         }
     }
+    // Precondition tuples are closed since the operator is applicable.
+    Tuple &tuple = tuple_buffer;
+    return for_each_subtuple(
+        extension, m, subtuple_buffer, [&](const Tuple &extension_part) -> bool {
+            if (!closed[get_tuple_index(extension_part)]) {
+                return false;
+            }
+            int max_pre_size = m - static_cast<int>(extension_part.size());
+            return for_each_subtuple(
+                op.pre, max_pre_size, inner_subtuple_buffer,
+                [&](const Tuple &pre_part) -> bool {
+                    tuple.clear();
+                    merge(pre_part.begin(), pre_part.end(),
+                          extension_part.begin(), extension_part.end(),
+                          back_inserter(tuple));
+                    return closed[get_tuple_index(tuple)];
+                });
+        });
 }
 
 
-void HMHeuristic::dump_table() const {
-    if (log.is_at_least_debug()) {
-        for (auto &hm_ent : hm_table) {
-            log << "h(" << hm_ent.first << ") = " << hm_ent.second << endl;
-        }
-    }
+void HMHeuristic::apply_operator(
+    const HMOperator &op, const Tuple &extension, int value) {
+    int cost = value + op.cost;
+    int max_size = m - static_cast<int>(extension.size());
+    Tuple &achieved = tuple_buffer;
+    Tuple &target = target_buffer;
+    for_each_subtuple(
+        op.eff, max_size, subtuple_buffer, [&](const Tuple &effects) -> bool {
+            for (size_t i = 1; i < effects.size(); ++i) {
+                if (fact_vars[effects[i]] == fact_vars[effects[i - 1]]) {
+                    return true;
+                }
+            }
+            achieved.clear();
+            merge(effects.begin(), effects.end(),
+                  extension.begin(), extension.end(),
+                  back_inserter(achieved));
+            enqueue_if_cheaper(achieved, cost);
+            // Prevail facts persist.
+            for_each_subtuple(
+                op.prevail, max_size - static_cast<int>(effects.size()),
+                inner_subtuple_buffer, [&](const Tuple &prevail) -> bool {
+                    target.clear();
+                    merge(achieved.begin(), achieved.end(),
+                          prevail.begin(), prevail.end(),
+                          back_inserter(target));
+                    enqueue_if_cheaper(target, cost);
+                    return true;
+                });
+            return true;
+        });
 }
 
 
@@ -3,10 +3,9 @@
 
 #include "../heuristic.h"
 
-#include <algorithm>
-#include <iostream>
-#include <map>
-#include <string>
+#include <functional>
+#include <queue>
+#include <tuple>
 #include <vector>
 
 namespace options {
@@ -17,45 +16,100 @@ namespace hm_heuristic {
 /*
   Haslum's h^m heuristic family ("critical path heuristics").
 
-  This is a very slow implementation and should not be used for
-  speed benchmarks.
+  Tuples of at most m facts are ranked into a flat table (see
+  get_tuple_index). h^m is the h^max value of the goal in the compiled
+  task Pi^m, whose actions are pairs of an operator o and a set O of at most
+  m-1 facts on variables that o neither requires nor affects. The pair
+  (o, O) requires all tuples of pre(o) u O and achieves all tuples of
+  eff(o) u O u prevail(o) that contain an effect.
+
+  We compute the table with a generalized Dijkstra search over the tuples.
+  The pairs (o, O) are never instantiated up front: when a tuple is closed,
+  we only consider the operators whose precondition contains one of its
+  facts (or that have no precondition), and apply the pairs whose required
+  tuples are all closed. The search stops as soon as all goal tuples are
+  closed.
 */
-
 class HMHeuristic : public Heuristic {
-    using Tuple = std::vector<FactPair>;
+    // Sorted IDs of facts on pairwise different variables.
+    using Tuple = std::vector<int>;
+    // Entries (value, tuple size, tuple index) ordered by value and size.
+    using QueueEntry = std::tuple<int, int, size_t>;
+    using TupleQueue = std::priority_queue<
+        QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>>;
+
+    struct HMOperator {
+        int cost;
+        Tuple pre;
+        /*
+          Sorted and without duplicates. With conditional effects, there
+          can be several effects on the same variable.
+        */
+        std::vector<int> eff;
+        // Preconditions on variables without effects.
+        Tuple prevail;
+        // Number of tuples of at most m precondition facts.
+        int num_precondition_tuples;
+        // Number of precondition tuples that are not closed yet.
+        int num_unsatisfied;
+        // Number of the last close_tuple call that considered the operator.
+        int last_visit;
+    };
+
     // parameters
     const int m;
     const bool has_cond_effects;
 
-    const Tuple goals;
-
-    // h^m table
-    std::map<Tuple, int> hm_table;
-    bool was_updated;
-
-    // auxiliary methods
-    void init_hm_table(const Tuple &t);
-    void update_hm_table();
-    int eval(const Tuple &t) const;
-    int update_hm_entry(const Tuple &t, int val);
-    void extend_tuple(const Tuple &t, const OperatorProxy &op);
-
-    int check_tuple_in_tuple(const Tuple &tuple, const Tuple &big_tuple) const;
-
-    int get_operator_pre_value(const OperatorProxy &op, int var) const;
-    Tuple get_operator_pre(const OperatorProxy &op) const;
-    Tuple get_operator_eff(const OperatorProxy &op) const;
-    bool contradict_effect_of(const OperatorProxy &op, int var, int val) const;
-
-    void generate_all_tuples();
-    void generate_all_tuples_aux(int var, int sz, const Tuple &base);
-
-    void generate_all_partial_tuples(const Tuple &base_tuple,
-                                     std::vector<Tuple> &res) const;
-    void generate_all_partial_tuples_aux(const Tuple &base_tuple, const Tuple &t, int index,
-                                         int sz, std::vector<Tuple> &res) const;
-
-    void dump_table() const;
+    std::vector<int> fact_offsets;
+    std::vector<int> fact_vars;
+    int num_facts;
+    // binomials[k][n] is n choose k for k <= m and n <= num_facts.
+    std::vector<std::vector<size_t>> binomials;
+    // tuple_offsets[k] is the index of the first tuple of size k.
+    std::vector<size_t> tuple_offsets;
+
+    std::vector<HMOperator> operators;
+    // Operators that have the given fact as precondition.
+    std::vector<std::vector<int>> precondition_of;
+    std::vector<int> operators_without_precondition;
+    std::vector<bool> is_goal_tuple;
+    int num_goal_tuples;
+
+    // Data of the current evaluation.
+    std::vector<int> hm_table;
+    std::vector<bool> closed;
+    // Facts whose singleton tuple is closed.
+    std::vector<int> closed_facts;
+    // For each fact, the facts with which it forms a closed pair.
+    std::vector<std::vector<int>> closed_partners;
+    TupleQueue queue;
+    int num_visits;
+
+    // Buffers that avoid allocations in the inner loops.
+    Tuple extension_buffer;
+    Tuple sorted_extension_buffer;
+    Tuple subtuple_buffer;
+    Tuple inner_subtuple_buffer;
+    Tuple tuple_buffer;
+    Tuple target_buffer;
+
+    int get_fact_id(const FactPair &fact) const;
+    size_t get_tuple_index(const Tuple &tuple) const;
+    size_t get_pair_index(int fact1, int fact2) const;
+    void get_tuple(size_t index, Tuple &tuple) const;
+
+    void enqueue_if_cheaper(const Tuple &tuple, int cost);
+    int compute_goal_value(const Tuple &state_facts);
+    void close_tuple(const Tuple &tuple, int value);
+    void process_operator(int op_id, const Tuple &tuple, int value);
+    const std::vector<int> &get_extension_candidates(const HMOperator &op) const;
+    bool can_extend(const HMOperator &op, const Tuple &extension, int fact) const;
+    void apply_extensions(const HMOperator &op, Tuple &extension,
+                          const std::vector<int> &candidates,
+                          size_t next_candidate, int value);
+    bool are_extension_tuples_closed(
+        const HMOperator &op, const Tuple &extension);
+    void apply_operator(const HMOperator &op, const Tuple &extension, int value);
 
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
@@ -15,6 +15,7 @@
 #include <OsiSolverInterface.hpp>
 #include <CoinPackedMatrix.hpp>
 #include <CoinPackedVector.hpp>
+#include <CoinWarmStartBasis.hpp>
 #ifdef __GNUG__
 #pragma GCC diagnostic pop
 #endif
@@ -172,6 +173,7 @@ void LPSolver::load_problem(const LinearProgram &lp) {
     clear_temporary_data();
     is_mip = false;
     is_initialized = false;
+    is_solved = false;
     num_permanent_constraints = lp.get_constraints().size();
 
     for (const LPVariable &var : lp.get_variables()) {
@@ -335,6 +337,8 @@ void LPSolver::set_objective_coefficients(const vector<double> &coefficients) {
 void LPSolver::set_objective_coefficient(int index, double coefficient) {
     assert(index < get_num_variables());
     try {
+        if (lp_solver->getObjCoefficients()[index] == coefficient)
+            return;
         lp_solver->setObjCoeff(index, coefficient);
     } catch (CoinError &error) {
         handle_coin_error(error);
@@ -345,6 +349,8 @@ void LPSolver::set_objective_coefficient(int index, double coefficient) {
 void LPSolver::set_constraint_lower_bound(int index, double bound) {
     assert(index < get_num_constraints());
     try {
+        if (lp_solver->getRowLower()[index] == bound)
+            return;
         lp_solver->setRowLower(index, bound);
     } catch (CoinError &error) {
         handle_coin_error(error);
@@ -355,6 +361,8 @@ void LPSolver::set_constraint_lower_bound(int index, double bound) {
 void LPSolver::set_constraint_upper_bound(int index, double bound) {
     assert(index < get_num_constraints());
     try {
+        if (lp_solver->getRowUpper()[index] == bound)
+            return;
         lp_solver->setRowUpper(index, bound);
     } catch (CoinError &error) {
         handle_coin_error(error);
@@ -365,6 +373,8 @@ void LPSolver::set_constraint_upper_bound(int index, double bound) {
 void LPSolver::set_variable_lower_bound(int index, double bound) {
     assert(index < get_num_variables());
     try {
+        if (lp_solver->getColLower()[index] == bound)
+            return;
         lp_solver->setColLower(index, bound);
     } catch (CoinError &error) {
         handle_coin_error(error);
@@ -375,6 +385,8 @@ void LPSolver::set_variable_lower_bound(int index, double bound) {
 void LPSolver::set_variable_upper_bound(int index, double bound) {
     assert(index < get_num_variables());
     try {
+        if (lp_solver->getColUpper()[index] == bound)
+            return;
         lp_solver->setColUpper(index, bound);
     } catch (CoinError &error) {
         handle_coin_error(error);
@@ -384,9 +396,40 @@ void LPSolver::set_variable_upper_bound(int index, double bound) {
 
 void LPSolver::set_mip_gap(double gap) {
     lp::set_mip_gap(lp_solver.get(), gap);
+    is_solved = false;
+}
+
+shared_ptr<CoinWarmStart> LPSolver::get_warm_start() const {
+    assert(is_solved);
+    if (is_mip || has_temporary_constraints_) {
+        return nullptr;
+    }
+    try {
+        return shared_ptr<CoinWarmStart>(lp_solver->getWarmStart());
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
+}
+
+void LPSolver::set_warm_start(const shared_ptr<CoinWarmStart> &warm_start) {
+    const CoinWarmStartBasis *basis =
+        dynamic_cast<const CoinWarmStartBasis *>(warm_start.get());
+    if (is_solved || !basis || !is_initialized ||
+        basis->getNumStructural() != get_num_variables() ||
+        basis->getNumArtificial() != get_num_constraints()) {
+        return;
+    }
+    try {
+        lp_solver->setWarmStart(basis);
+    } catch (CoinError &error) {
+        handle_coin_error(error);
+    }
 }
 
 void LPSolver::solve() {
+    if (is_solved) {
+        return;
+    }
     try {
         if (is_initialized) {
             lp_solver->resolve();
@@ -25,6 +25,7 @@
 #endif
 
 class CoinPackedVectorBase;
+class CoinWarmStart;
 class OsiSolverInterface;
 
 namespace options {
@@ -164,6 +165,25 @@ public:
 
     LP_METHOD(void set_mip_gap(double gap))
 
+    /*
+      Return the basis of the last solved LP, which can be passed to
+      set_warm_start() to start solving a later LP from it. Return nullptr
+      for MIPs and if the LP has temporary constraints, since their number
+      and meaning differ between LPs.
+    */
+    LP_METHOD(std::shared_ptr<CoinWarmStart> get_warm_start() const)
+    /*
+      Start the next call to solve() from the given basis. The basis is
+      ignored if the LP has not changed since the last call to solve() or if
+      the basis does not fit the dimensions of the current LP.
+    */
+    LP_METHOD(void set_warm_start(const std::shared_ptr<CoinWarmStart> &warm_start))
+
+    /*
+      Solve the LP. Setting a bound or coefficient to its current value does
+      not modify the LP, so if nothing changed since the last call, we keep
+      the previous solution without calling the solver.
+    */
     LP_METHOD(void solve())
     LP_METHOD(void write_lp(const std::string &filename) const)
     LP_METHOD(void print_failure_analysis() const)
@@ -66,7 +66,7 @@ static void breadth_first_search(
 void Distances::compute_init_distances_unit_cost() {
     vector<vector<int>> forward_graph(get_num_states());
     for (GroupAndTransitions gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         for (const Transition &transition : transitions) {
             forward_graph[transition.src].push_back(transition.target);
         }
@@ -81,7 +81,7 @@ void Distances::compute_init_distances_unit_cost() {
 void Distances::compute_goal_distances_unit_cost() {
     vector<vector<int>> backward_graph(get_num_states());
     for (GroupAndTransitions gat : transition_system) {
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         for (const Transition &transition : transitions) {
             backward_graph[transition.target].push_back(transition.src);
         }
@@ -126,7 +126,7 @@ void Distances::compute_init_distances_general_cost() {
     vector<vector<pair<int, int>>> forward_graph(get_num_states());
     for (GroupAndTransitions gat : transition_system) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         int cost = label_group.get_cost();
         for (const Transition &transition : transitions) {
             forward_graph[transition.src].push_back(
@@ -146,7 +146,7 @@ void Distances::compute_goal_distances_general_cost() {
     vector<vector<pair<int, int>>> backward_graph(get_num_states());
     for (GroupAndTransitions gat : transition_system) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         int cost = label_group.get_cost();
         for (const Transition &transition : transitions) {
             backward_graph[transition.target].push_back(
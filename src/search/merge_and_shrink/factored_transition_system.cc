@@ -9,6 +9,7 @@
 #include "../utils/collections.h"
 #include "../utils/logging.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 
 #include <cassert>
@@ -43,6 +44,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(
     vector<unique_ptr<Distances>> &&distances,
     const bool compute_init_distances,
     const bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log)
     : labels(move(labels)),
       transition_systems(move(transition_systems)),
@@ -50,12 +52,22 @@ FactoredTransitionSystem::FactoredTransitionSystem(
       distances(move(distances)),
       compute_init_distances(compute_init_distances),
       compute_goal_distances(compute_goal_distances),
+      num_threads(num_threads),
       num_active_entries(this->transition_systems.size()) {
+    /*
+      The distances of the factors are independent, so we compute them
+      concurrently. The log is not thread-safe, so the threads log nothing.
+    */
+    utils::LogProxy silent_log = utils::get_silent_log();
+    utils::LogProxy &factor_log = num_threads > 1 ? silent_log : log;
+    utils::run_in_parallel(
+        this->transition_systems.size(), num_threads, [&](int index) {
+            if (compute_init_distances || compute_goal_distances) {
+                this->distances[index]->compute_distances(
+                    compute_init_distances, compute_goal_distances, factor_log);
+            }
+        });
     for (size_t index = 0; index < this->transition_systems.size(); ++index) {
-        if (compute_init_distances || compute_goal_distances) {
-            this->distances[index]->compute_distances(
-                compute_init_distances, compute_goal_distances, log);
-        }
         assert(is_component_valid(index));
     }
 }
@@ -67,6 +79,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&ot
       distances(move(other.distances)),
       compute_init_distances(move(other.compute_init_distances)),
       compute_goal_distances(move(other.compute_goal_distances)),
+      num_threads(move(other.num_threads)),
       num_active_entries(move(other.num_active_entries)) {
     /*
       This is just a default move constructor. Unfortunately Visual
@@ -117,12 +130,12 @@ void FactoredTransitionSystem::apply_label_mapping(
         assert(new_label_old_labels.first == labels->get_size());
         labels->reduce_labels(new_label_old_labels.second);
     }
-    for (size_t i = 0; i < transition_systems.size(); ++i) {
-        if (transition_systems[i]) {
-            transition_systems[i]->apply_label_reduction(
-                label_mapping, static_cast<int>(i) != combinable_index);
-        }
-    }
+    utils::run_in_parallel(transition_systems.size(), num_threads, [&](int i) {
+            if (transition_systems[i]) {
+                transition_systems[i]->apply_label_reduction(
+                    label_mapping, i != combinable_index);
+            }
+        });
     assert_all_components_valid();
 }
 
@@ -67,6 +67,8 @@ class FactoredTransitionSystem {
     std::vector<std::unique_ptr<Distances>> distances;
     const bool compute_init_distances;
     const bool compute_goal_distances;
+    // Number of threads for transformations that act on all factors.
+    const int num_threads;
     int num_active_entries;
 
     /*
@@ -91,6 +93,7 @@ public:
         std::vector<std::unique_ptr<Distances>> &&distances,
         bool compute_init_distances,
         bool compute_goal_distances,
+        int num_threads,
         utils::LogProxy &log);
     FactoredTransitionSystem(FactoredTransitionSystem &&other);
     ~FactoredTransitionSystem();
@@ -106,7 +109,8 @@ public:
       updating all transitions of all transition systems. Only for the factor
       at combinable_index, the local equivalence relation over labels must be
       recomputed; for all factors, all labels that are combined by the label
-      mapping have been locally equivalent already before.
+      mapping have been locally equivalent already before. The transition
+      systems are updated concurrently on num_threads threads.
     */
     void apply_label_mapping(
         const std::vector<std::pair<int, std::vector<int>>> &label_mapping,
@@ -91,6 +91,7 @@ public:
     FactoredTransitionSystem create(
         bool compute_init_distances,
         bool compute_goal_distances,
+        int num_threads,
         utils::LogProxy &log);
 };
 
@@ -380,11 +381,27 @@ vector<unique_ptr<TransitionSystem>> FTSFactory::create_transition_systems(const
         ts_data.label_equivalence_relation =
             utils::make_unique_ptr<LabelEquivalenceRelation>(
                 labels, ts_data.label_groups);
+        // Store the transitions of all groups in one buffer.
+        vector<Transition> transitions;
+        vector<size_t> group_offsets;
+        vector<size_t> group_sizes;
+        group_offsets.reserve(ts_data.transitions_by_group_id.size());
+        group_sizes.reserve(ts_data.transitions_by_group_id.size());
+        for (const vector<Transition> &group_transitions :
+             ts_data.transitions_by_group_id) {
+            group_offsets.push_back(transitions.size());
+            group_sizes.push_back(group_transitions.size());
+            transitions.insert(transitions.end(),
+                               group_transitions.begin(), group_transitions.end());
+        }
+        utils::release_vector_memory(ts_data.transitions_by_group_id);
         result.push_back(utils::make_unique_ptr<TransitionSystem>(
                              ts_data.num_variables,
                              move(ts_data.incorporated_variables),
                              move(ts_data.label_equivalence_relation),
-                             move(ts_data.transitions_by_group_id),
+                             move(transitions),
+                             move(group_offsets),
+                             move(group_sizes),
                              ts_data.num_states,
                              move(ts_data.goal_states),
                              ts_data.init_state
@@ -430,6 +447,7 @@ vector<unique_ptr<Distances>> FTSFactory::create_distances(
 FactoredTransitionSystem FTSFactory::create(
     const bool compute_init_distances,
     const bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log) {
     if (log.is_at_least_normal()) {
         log << "Building atomic transition systems... " << endl;
@@ -453,6 +471,7 @@ FactoredTransitionSystem FTSFactory::create(
         move(distances),
         compute_init_distances,
         compute_goal_distances,
+        num_threads,
         log);
 }
 
@@ -460,10 +479,12 @@ FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
     const bool compute_init_distances,
     const bool compute_goal_distances,
+    int num_threads,
     utils::LogProxy &log) {
     return FTSFactory(task_proxy).create(
         compute_init_distances,
         compute_goal_distances,
+        num_threads,
         log);
 }
 }
@@ -21,9 +21,11 @@
 #include "../utils/countdown_timer.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/system.h"
 #include "../utils/timer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -52,6 +54,7 @@ MergeAndShrinkAlgorithm::MergeAndShrinkAlgorithm(const Options &opts) :
     prune_irrelevant_states(opts.get<bool>("prune_irrelevant_states")),
     log(utils::get_log_from_options(opts)),
     main_loop_max_time(opts.get<double>("main_loop_max_time")),
+    num_threads(opts.get<int>("num_threads")),
     starting_peak_memory(0) {
     assert(max_states_before_merge > 0);
     assert(max_states >= max_states_before_merge);
@@ -357,6 +360,7 @@ FactoredTransitionSystem MergeAndShrinkAlgorithm::build_factored_transition_syst
             task_proxy,
             compute_init_distances,
             compute_goal_distances,
+            num_threads,
             log);
     if (log.is_at_least_normal()) {
         log_progress(timer, "after computation of atomic factors", log);
@@ -364,15 +368,34 @@ FactoredTransitionSystem MergeAndShrinkAlgorithm::build_factored_transition_syst
 
     /*
       Prune all atomic factors according to the chosen options. Stop early if
-      one factor is unsolvable.
+      one factor is unsolvable. The atomic factors are independent, so with
+      several threads, we prune all of them concurrently (without logging,
+      because the log is not thread-safe) and check for unsolvability
+      afterwards.
 
       TODO: think about if we can prune already while creating the atomic FTS.
     */
     bool pruned = false;
     bool unsolvable = false;
+    if (num_threads > 1 &&
+        (prune_unreachable_states || prune_irrelevant_states)) {
+        utils::LogProxy silent_log = utils::get_silent_log();
+        vector<char> pruned_factors(fts.get_size(), false);
+        utils::run_in_parallel(fts.get_size(), num_threads, [&](int index) {
+                pruned_factors[index] = prune_step(
+                    fts,
+                    index,
+                    prune_unreachable_states,
+                    prune_irrelevant_states,
+                    silent_log);
+            });
+        pruned = find(pruned_factors.begin(), pruned_factors.end(), true) !=
+            pruned_factors.end();
+    }
     for (int index = 0; index < fts.get_size(); ++index) {
         assert(fts.is_active(index));
-        if (prune_unreachable_states || prune_irrelevant_states) {
+        if (num_threads == 1 &&
+            (prune_unreachable_states || prune_irrelevant_states)) {
             bool pruned_factor = prune_step(
                 fts,
                 index,
@@ -452,6 +475,16 @@ void add_merge_and_shrink_algorithm_options_to_parser(OptionParser &parser) {
         "transformation is runtime-intense.",
         "infinity",
         Bounds("0.0", "infinity"));
+
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for the transformations that act on all factors "
+        "independently: computing the distances and pruning of the atomic "
+        "factors, and applying label reductions to all factors. The result "
+        "does not depend on the number of threads. With several threads, "
+        "these transformations do not log details about individual factors.",
+        "1",
+        Bounds("1", "infinity"));
 }
 
 void add_transition_system_size_limit_options_to_parser(OptionParser &parser) {
@@ -44,6 +44,7 @@ class MergeAndShrinkAlgorithm {
 
     mutable utils::LogProxy log;
     const double main_loop_max_time;
+    const int num_threads;
 
     long starting_peak_memory;
 
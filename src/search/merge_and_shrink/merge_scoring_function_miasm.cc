@@ -13,6 +13,7 @@
 
 #include "../utils/logging.h"
 #include "../utils/markup.h"
+#include "../utils/parallel.h"
 
 using namespace std;
 
@@ -23,50 +24,58 @@ MergeScoringFunctionMIASM::MergeScoringFunctionMIASM(
       max_states(options.get<int>("max_states")),
       max_states_before_merge(options.get<int>("max_states_before_merge")),
       shrink_threshold_before_merge(options.get<int>("threshold_before_merge")),
+      num_threads(options.get<int>("num_threads")),
       silent_log(utils::get_silent_log()) {
 }
 
+double MergeScoringFunctionMIASM::compute_score(
+    const FactoredTransitionSystem &fts, int index1, int index2) {
+    unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
+        fts,
+        index1,
+        index2,
+        *shrink_strategy,
+        max_states,
+        max_states_before_merge,
+        shrink_threshold_before_merge,
+        silent_log);
+
+    // Compute distances for the product and count the alive states.
+    unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
+    const bool compute_init_distances = true;
+    const bool compute_goal_distances = true;
+    distances->compute_distances(compute_init_distances, compute_goal_distances, silent_log);
+    int num_states = product->get_size();
+    int alive_states_count = 0;
+    for (int state = 0; state < num_states; ++state) {
+        if (distances->get_init_distance(state) != INF &&
+            distances->get_goal_distance(state) != INF) {
+            ++alive_states_count;
+        }
+    }
+
+    /*
+      Compute the score as the ratio of alive states of the product
+      compared to the number of states of the full product.
+    */
+    assert(num_states);
+    return static_cast<double>(alive_states_count) /
+           static_cast<double>(num_states);
+}
+
 vector<double> MergeScoringFunctionMIASM::compute_scores(
     const FactoredTransitionSystem &fts,
     const vector<pair<int, int>> &merge_candidates) {
-    vector<double> scores;
-    scores.reserve(merge_candidates.size());
-    for (pair<int, int> merge_candidate : merge_candidates) {
-        int index1 = merge_candidate.first;
-        int index2 = merge_candidate.second;
-        unique_ptr<TransitionSystem> product = shrink_before_merge_externally(
-            fts,
-            index1,
-            index2,
-            *shrink_strategy,
-            max_states,
-            max_states_before_merge,
-            shrink_threshold_before_merge,
-            silent_log);
-
-        // Compute distances for the product and count the alive states.
-        unique_ptr<Distances> distances = utils::make_unique_ptr<Distances>(*product);
-        const bool compute_init_distances = true;
-        const bool compute_goal_distances = true;
-        distances->compute_distances(compute_init_distances, compute_goal_distances, silent_log);
-        int num_states = product->get_size();
-        int alive_states_count = 0;
-        for (int state = 0; state < num_states; ++state) {
-            if (distances->get_init_distance(state) != INF &&
-                distances->get_goal_distance(state) != INF) {
-                ++alive_states_count;
-            }
-        }
-
-        /*
-          Compute the score as the ratio of alive states of the product
-          compared to the number of states of the full product.
-        */
-        assert(num_states);
-        double score = static_cast<double>(alive_states_count) /
-            static_cast<double>(num_states);
-        scores.push_back(score);
-    }
+    /*
+      The products of the merge candidates are computed independently, so
+      we score them concurrently if the shrink strategy allows it.
+    */
+    int threads = shrink_strategy->supports_concurrent_calls() ? num_threads : 1;
+    vector<double> scores(merge_candidates.size());
+    utils::run_in_parallel(merge_candidates.size(), threads, [&](int i) {
+            scores[i] = compute_score(
+                fts, merge_candidates[i].first, merge_candidates[i].second);
+        });
     return scores;
 }
 
@@ -127,6 +136,13 @@ static shared_ptr<MergeScoringFunction>_parse(options::OptionParser &parser) {
         "We recommend setting this to match the shrink strategy configuration "
         "given to {{{merge_and_shrink}}}, see note below.");
     add_transition_system_size_limit_options_to_parser(parser);
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for computing the products of the merge "
+        "candidates. Shrink strategies that use random numbers (shrink_fh, "
+        "shrink_random) are always run on a single thread.",
+        "1",
+        options::Bounds("1", "infinity"));
     // TODO: this is only necessary for handle_shrink_limit_options_defaults.
     utils::add_log_options_to_parser(parser);
 
@@ -14,7 +14,11 @@ class MergeScoringFunctionMIASM : public MergeScoringFunction {
     const int max_states;
     const int max_states_before_merge;
     const int shrink_threshold_before_merge;
+    const int num_threads;
     utils::LogProxy silent_log;
+
+    double compute_score(
+        const FactoredTransitionSystem &fts, int index1, int index2);
 protected:
     virtual std::string name() const override;
 public:
@@ -188,7 +188,7 @@ void ShrinkBisimulation::compute_signatures(
     */
     for (GroupAndTransitions gat : ts) {
         const LabelGroup &label_group = gat.label_group;
-        const vector<Transition> &transitions = gat.transitions;
+        const TransitionRange &transitions = gat.transitions;
         for (const Transition &transition : transitions) {
             assert(signatures[transition.src + 1].state == transition.src);
             bool skip_transition = false;
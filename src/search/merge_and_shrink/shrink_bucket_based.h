@@ -58,6 +58,10 @@ public:
         const Distances &distances,
         int target_size,
         utils::LogProxy &log) const override;
+    // The random number generator is shared between calls.
+    virtual bool supports_concurrent_calls() const override {
+        return false;
+    }
     static void add_options_to_parser(options::OptionParser &parser);
 };
 }
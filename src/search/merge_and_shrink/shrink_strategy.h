@@ -44,6 +44,16 @@ public:
     virtual bool requires_init_distances() const = 0;
     virtual bool requires_goal_distances() const = 0;
 
+    /*
+      Return true if compute_equivalence_relation may be called for
+      different transition systems concurrently and gives the same results
+      as sequential calls, i.e., if it does not use shared mutable state
+      such as a random number generator.
+    */
+    virtual bool supports_concurrent_calls() const {
+        return true;
+    }
+
     void dump_options(utils::LogProxy &log) const;
     std::string get_name() const;
 };
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <iostream>
 #include <iterator>
+#include <numeric>
 #include <set>
 #include <sstream>
 #include <string>
@@ -28,23 +29,19 @@ ostream &operator<<(ostream &os, const Transition &trans) {
     return os;
 }
 
-// Sorts the given set of transitions and removes duplicates.
-static void normalize_given_transitions(vector<Transition> &transitions) {
-    sort(transitions.begin(), transitions.end());
-    transitions.erase(unique(transitions.begin(), transitions.end()), transitions.end());
+bool TransitionRange::operator==(const TransitionRange &other) const {
+    return size() == other.size() && equal(begin(), end(), other.begin());
 }
 
-TSConstIterator::TSConstIterator(
-    const LabelEquivalenceRelation &label_equivalence_relation,
-    const vector<vector<Transition>> &transitions_by_group_id,
-    bool end)
-    : label_equivalence_relation(label_equivalence_relation),
-      transitions_by_group_id(transitions_by_group_id),
-      current_group_id((end ? label_equivalence_relation.get_size() : 0)) {
+TSConstIterator::TSConstIterator(const TransitionSystem &ts, bool end)
+    : ts(ts),
+      current_group_id((end ? ts.label_equivalence_relation->get_size() : 0)) {
     next_valid_index();
 }
 
 void TSConstIterator::next_valid_index() {
+    const LabelEquivalenceRelation &label_equivalence_relation =
+        *ts.label_equivalence_relation;
     while (current_group_id < label_equivalence_relation.get_size()
            && label_equivalence_relation.is_empty_group(current_group_id)) {
         ++current_group_id;
@@ -58,8 +55,8 @@ void TSConstIterator::operator++() {
 
 GroupAndTransitions TSConstIterator::operator*() const {
     return GroupAndTransitions(
-        label_equivalence_relation.get_group(current_group_id),
-        transitions_by_group_id[current_group_id]);
+        ts.label_equivalence_relation->get_group(current_group_id),
+        ts.get_transitions_for_group_id(current_group_id));
 }
 
 
@@ -82,14 +79,18 @@ TransitionSystem::TransitionSystem(
     int num_variables,
     vector<int> &&incorporated_variables,
     unique_ptr<LabelEquivalenceRelation> &&label_equivalence_relation,
-    vector<vector<Transition>> &&transitions_by_group_id,
+    vector<Transition> &&transitions,
+    vector<size_t> &&group_offsets,
+    vector<size_t> &&group_sizes,
     int num_states,
     vector<bool> &&goal_states,
     int init_state)
     : num_variables(num_variables),
       incorporated_variables(move(incorporated_variables)),
       label_equivalence_relation(move(label_equivalence_relation)),
-      transitions_by_group_id(move(transitions_by_group_id)),
+      transitions(move(transitions)),
+      group_offsets(move(group_offsets)),
+      group_sizes(move(group_sizes)),
       num_states(num_states),
       goal_states(move(goal_states)),
       init_state(init_state) {
@@ -103,7 +104,9 @@ TransitionSystem::TransitionSystem(const TransitionSystem &other)
       label_equivalence_relation(
           utils::make_unique_ptr<LabelEquivalenceRelation>(
               *other.label_equivalence_relation)),
-      transitions_by_group_id(other.transitions_by_group_id),
+      transitions(other.transitions),
+      group_offsets(other.group_offsets),
+      group_sizes(other.group_sizes),
       num_states(other.num_states),
       goal_states(other.goal_states),
       init_state(other.init_state) {
@@ -132,8 +135,11 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         ts2.incorporated_variables.begin(), ts2.incorporated_variables.end(),
         back_inserter(incorporated_variables));
     vector<vector<int>> label_groups;
-    vector<vector<Transition>> transitions_by_group_id;
-    transitions_by_group_id.reserve(labels.get_max_size());
+    vector<Transition> transitions;
+    vector<size_t> group_offsets;
+    vector<size_t> group_sizes;
+    group_offsets.reserve(labels.get_max_size());
+    group_sizes.reserve(labels.get_max_size());
 
     int ts1_size = ts1.get_size();
     int ts2_size = ts2.get_size();
@@ -165,7 +171,7 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
     vector<int> dead_labels;
     for (GroupAndTransitions gat : ts1) {
         const LabelGroup &group1 = gat.label_group;
-        const vector<Transition> &transitions1 = gat.transitions;
+        const TransitionRange &transitions1 = gat.transitions;
 
         // Distribute the labels of this group among the "buckets"
         // corresponding to the groups of ts2.
@@ -179,15 +185,26 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
 
         // Now create the new groups together with their transitions.
         for (auto &bucket : buckets) {
-            const vector<Transition> &transitions2 =
+            const TransitionRange transitions2 =
                 ts2.get_transitions_for_group_id(bucket.first);
 
-            // Create the new transitions for this bucket
-            vector<Transition> new_transitions;
-            if (!transitions1.empty() && !transitions2.empty()
-                && transitions1.size() > new_transitions.max_size() / transitions2.size())
+            // Create a new group if the transitions are not empty
+            vector<int> &new_labels = bucket.second;
+            if (transitions1.empty() || transitions2.empty()) {
+                dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
+                continue;
+            }
+
+            /*
+              Append the new transitions for this bucket to the buffer. We do
+              not reserve space per bucket, since growing the buffer to the
+              exact size every time would make merging quadratic.
+            */
+            size_t offset = transitions.size();
+            if (transitions1.size() >
+                (transitions.max_size() - offset) / transitions2.size())
                 utils::exit_with(ExitCode::SEARCH_OUT_OF_MEMORY);
-            new_transitions.reserve(transitions1.size() * transitions2.size());
+            size_t num_new_transitions = transitions1.size() * transitions2.size();
             for (const Transition &transition1 : transitions1) {
                 int src1 = transition1.src;
                 int target1 = transition1.target;
@@ -196,19 +213,13 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
                     int target2 = transition2.target;
                     int src = src1 * multiplier + src2;
                     int target = target1 * multiplier + target2;
-                    new_transitions.push_back(Transition(src, target));
+                    transitions.push_back(Transition(src, target));
                 }
             }
-
-            // Create a new group if the transitions are not empty
-            vector<int> &new_labels = bucket.second;
-            if (new_transitions.empty()) {
-                dead_labels.insert(dead_labels.end(), new_labels.begin(), new_labels.end());
-            } else {
-                sort(new_transitions.begin(), new_transitions.end());
-                label_groups.push_back(move(new_labels));
-                transitions_by_group_id.push_back(move(new_transitions));
-            }
+            sort(transitions.begin() + offset, transitions.end());
+            label_groups.push_back(move(new_labels));
+            group_offsets.push_back(offset);
+            group_sizes.push_back(num_new_transitions);
         }
     }
 
@@ -222,10 +233,11 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
     if (!dead_labels.empty()) {
         label_groups.push_back(move(dead_labels));
         // Dead labels have empty transitions
-        transitions_by_group_id.emplace_back();
+        group_offsets.push_back(transitions.size());
+        group_sizes.push_back(0);
     }
 
-    assert(transitions_by_group_id.size() == label_groups.size());
+    assert(group_offsets.size() == label_groups.size());
 
     unique_ptr<LabelEquivalenceRelation> label_equivalence_relation =
         utils::make_unique_ptr<LabelEquivalenceRelation>(labels, label_groups);
@@ -234,7 +246,9 @@ unique_ptr<TransitionSystem> TransitionSystem::merge(
         num_variables,
         move(incorporated_variables),
         move(label_equivalence_relation),
-        move(transitions_by_group_id),
+        move(transitions),
+        move(group_offsets),
+        move(group_sizes),
         num_states,
         move(goal_states),
         init_state
@@ -249,15 +263,16 @@ void TransitionSystem::compute_locally_equivalent_labels() {
     for (int group_id1 = 0; group_id1 < label_equivalence_relation->get_size();
          ++group_id1) {
         if (!label_equivalence_relation->is_empty_group(group_id1)) {
-            const vector<Transition> &transitions1 = transitions_by_group_id[group_id1];
+            const TransitionRange transitions1 =
+                get_transitions_for_group_id(group_id1);
             for (int group_id2 = group_id1 + 1;
                  group_id2 < label_equivalence_relation->get_size(); ++group_id2) {
                 if (!label_equivalence_relation->is_empty_group(group_id2)) {
-                    vector<Transition> &transitions2 = transitions_by_group_id[group_id2];
-                    if (transitions1 == transitions2) {
+                    if (transitions1 == get_transitions_for_group_id(group_id2)) {
                         label_equivalence_relation->move_group_into_group(
                             group_id2, group_id1);
-                        utils::release_vector_memory(transitions2);
+                        // The space is reclaimed by compact_transitions().
+                        group_sizes[group_id2] = 0;
                     }
                 }
             }
@@ -265,6 +280,58 @@ void TransitionSystem::compute_locally_equivalent_labels() {
     }
 }
 
+void TransitionSystem::add_group_transitions(
+    const vector<Transition> &new_transitions) {
+    group_offsets.push_back(transitions.size());
+    group_sizes.push_back(new_transitions.size());
+    transitions.insert(
+        transitions.end(), new_transitions.begin(), new_transitions.end());
+}
+
+void TransitionSystem::compact_transitions(const vector<int> *abstraction_mapping) {
+    /*
+      The ranges of the non-empty groups are ordered by group ID, so the
+      write position never overtakes the read position and we can move the
+      transitions in place.
+    */
+    size_t write_pos = 0;
+    for (size_t group_id = 0; group_id < group_offsets.size(); ++group_id) {
+        size_t read_pos = group_offsets[group_id];
+        size_t read_end = read_pos + group_sizes[group_id];
+        assert(group_sizes[group_id] == 0 || read_pos >= write_pos);
+        size_t new_offset = write_pos;
+        for (; read_pos < read_end; ++read_pos) {
+            Transition transition = transitions[read_pos];
+            if (abstraction_mapping) {
+                transition.src = (*abstraction_mapping)[transition.src];
+                transition.target = (*abstraction_mapping)[transition.target];
+                if (transition.src == PRUNED_STATE ||
+                    transition.target == PRUNED_STATE) {
+                    continue;
+                }
+            }
+            transitions[write_pos++] = transition;
+        }
+        auto group_begin = transitions.begin() + new_offset;
+        auto group_end = transitions.begin() + write_pos;
+        if (abstraction_mapping) {
+            sort(group_begin, group_end);
+            group_end = unique(group_begin, group_end);
+            write_pos = group_end - transitions.begin();
+        }
+        group_offsets[group_id] = new_offset;
+        group_sizes[group_id] = write_pos - new_offset;
+    }
+    transitions.erase(transitions.begin() + write_pos, transitions.end());
+    /*
+      Shrinking copies the whole buffer, so we only do it if more than half
+      of the capacity is unused, e.g. after a shrink step or after the
+      geometric growth during merging.
+    */
+    if (transitions.capacity() > 2 * transitions.size())
+        transitions.shrink_to_fit();
+}
+
 void TransitionSystem::apply_abstraction(
     const StateEquivalenceRelation &state_equivalence_relation,
     const vector<int> &abstraction_mapping,
@@ -294,31 +361,8 @@ void TransitionSystem::apply_abstraction(
     }
     goal_states = move(new_goal_states);
 
-    // Update all transitions.
-    for (vector<Transition> &transitions : transitions_by_group_id) {
-        if (!transitions.empty()) {
-            vector<Transition> new_transitions;
-            /*
-              We reserve more memory than necessary here, but this is better
-              than potentially resizing the vector several times when inserting
-              transitions one after the other. See issue604-v6.
-
-              An alternative could be to not use a new vector, but to modify
-              the existing transitions inplace, and to remove all empty
-              positions in the end. This would be more ugly, though.
-            */
-            new_transitions.reserve(transitions.size());
-            for (size_t i = 0; i < transitions.size(); ++i) {
-                const Transition &transition = transitions[i];
-                int src = abstraction_mapping[transition.src];
-                int target = abstraction_mapping[transition.target];
-                if (src != PRUNED_STATE && target != PRUNED_STATE)
-                    new_transitions.push_back(Transition(src, target));
-            }
-            normalize_given_transitions(new_transitions);
-            transitions = move(new_transitions);
-        }
-    }
+    // Update all transitions in place.
+    compact_transitions(&abstraction_mapping);
 
     compute_locally_equivalent_labels();
 
@@ -384,8 +428,10 @@ void TransitionSystem::apply_label_reduction(
                 int group_id = label_equivalence_relation->get_group_id(old_label_no);
                 if (seen_group_ids.insert(group_id).second) {
                     affected_group_ids.insert(group_id);
-                    const vector<Transition> &transitions = transitions_by_group_id[group_id];
-                    new_label_transitions.insert(transitions.begin(), transitions.end());
+                    const TransitionRange group_transitions =
+                        get_transitions_for_group_id(group_id);
+                    new_label_transitions.insert(
+                        group_transitions.begin(), group_transitions.end());
                 }
             }
             new_transitions.emplace_back(
@@ -407,25 +453,30 @@ void TransitionSystem::apply_label_reduction(
           position.
 
           NOTE: it is important that this happens in increasing order of label
-          numbers to ensure that transitions_by_group_id are synchronized with
+          numbers to ensure that the group transitions are synchronized with
           label groups of label_equivalence_relation.
         */
         for (size_t i = 0; i < label_mapping.size(); ++i) {
-            vector<Transition> &transitions = new_transitions[i];
             assert(label_equivalence_relation->get_group_id(label_mapping[i].first)
-                   == static_cast<int>(transitions_by_group_id.size()));
-            transitions_by_group_id.push_back(move(transitions));
+                   == static_cast<int>(group_offsets.size()));
+            add_group_transitions(new_transitions[i]);
         }
 
         // Go over all affected group IDs and remove their transitions if the
         // group is empty.
         for (int group_id : affected_group_ids) {
             if (label_equivalence_relation->is_empty_group(group_id)) {
-                utils::release_vector_memory(transitions_by_group_id[group_id]);
+                group_sizes[group_id] = 0;
             }
         }
 
         compute_locally_equivalent_labels();
+
+        // Reclaim the space of removed groups once it dominates the buffer.
+        size_t num_used = accumulate(group_sizes.begin(), group_sizes.end(), size_t(0));
+        if (2 * num_used < transitions.size()) {
+            compact_transitions();
+        }
     }
 
     assert(are_transitions_sorted_unique());
@@ -440,15 +491,19 @@ string TransitionSystem::tag() const {
 
 bool TransitionSystem::are_transitions_sorted_unique() const {
     for (GroupAndTransitions gat : *this) {
-        if (!utils::is_sorted_unique(gat.transitions))
-            return false;
+        const TransitionRange &group_transitions = gat.transitions;
+        for (size_t i = 1; i < group_transitions.size(); ++i) {
+            if (group_transitions[i - 1] >= group_transitions[i])
+                return false;
+        }
     }
     return true;
 }
 
 bool TransitionSystem::in_sync_with_label_equivalence_relation() const {
     return label_equivalence_relation->get_size() ==
-           static_cast<int>(transitions_by_group_id.size());
+           static_cast<int>(group_offsets.size()) &&
+           group_offsets.size() == group_sizes.size();
 }
 
 bool TransitionSystem::is_solvable(const Distances &distances) const {
@@ -498,7 +553,7 @@ void TransitionSystem::dump_dot_graph(utils::LogProxy &log) const {
         }
         for (GroupAndTransitions gat : *this) {
             const LabelGroup &label_group = gat.label_group;
-            const vector<Transition> &transitions = gat.transitions;
+            const TransitionRange &transitions = gat.transitions;
             for (const Transition &transition : transitions) {
                 int src = transition.src;
                 int target = transition.target;
@@ -531,7 +586,7 @@ void TransitionSystem::dump_labels_and_transitions(utils::LogProxy &log) const {
             }
             log << endl;
             log << "transitions: ";
-            const vector<Transition> &transitions = gat.transitions;
+            const TransitionRange &transitions = gat.transitions;
             for (size_t i = 0; i < transitions.size(); ++i) {
                 int src = transitions[i].src;
                 int target = transitions[i].target;
@@ -3,6 +3,7 @@
 
 #include "types.h"
 
+#include <cstddef>
 #include <iostream>
 #include <memory>
 #include <string>
@@ -18,6 +19,7 @@ class Distances;
 class LabelEquivalenceRelation;
 class LabelGroup;
 class Labels;
+class TransitionSystem;
 
 struct Transition {
     int src;
@@ -41,11 +43,46 @@ struct Transition {
     }
 };
 
+/*
+  The transitions of a label group, which are stored in a contiguous range
+  of the transition buffer of a TransitionSystem.
+*/
+class TransitionRange {
+    const Transition *first;
+    const Transition *last;
+public:
+    TransitionRange(const Transition *first, const Transition *last)
+        : first(first), last(last) {
+    }
+
+    const Transition *begin() const {
+        return first;
+    }
+
+    const Transition *end() const {
+        return last;
+    }
+
+    std::size_t size() const {
+        return last - first;
+    }
+
+    bool empty() const {
+        return first == last;
+    }
+
+    const Transition &operator[](std::size_t i) const {
+        return first[i];
+    }
+
+    bool operator==(const TransitionRange &other) const;
+};
+
 struct GroupAndTransitions {
     const LabelGroup &label_group;
-    const std::vector<Transition> &transitions;
+    const TransitionRange transitions;
     GroupAndTransitions(const LabelGroup &label_group,
-                        const std::vector<Transition> &transitions)
+                        const TransitionRange &transitions)
         : label_group(label_group),
           transitions(transitions) {
     }
@@ -58,16 +95,13 @@ class TSConstIterator {
       the data structure used by LabelEquivalenceRelation, which could be
       easily exchanged.
     */
-    const LabelEquivalenceRelation &label_equivalence_relation;
-    const std::vector<std::vector<Transition>> &transitions_by_group_id;
+    const TransitionSystem &ts;
     // current_group_id is the actual iterator
     int current_group_id;
 
     void next_valid_index();
 public:
-    TSConstIterator(const LabelEquivalenceRelation &label_equivalence_relation,
-                    const std::vector<std::vector<Transition>> &transitions_by_group_id,
-                    bool end);
+    TSConstIterator(const TransitionSystem &ts, bool end);
     void operator++();
     GroupAndTransitions operator*() const;
 
@@ -81,6 +115,7 @@ public:
 };
 
 class TransitionSystem {
+    friend class TSConstIterator;
 private:
     /*
       The following two attributes are only used for output.
@@ -104,17 +139,21 @@ private:
     std::unique_ptr<LabelEquivalenceRelation> label_equivalence_relation;
 
     /*
-      The transitions of a label group are indexed via its ID. The ID of a
-      group does not change, and hence its transitions are never moved.
-
-      We tested different alternatives to store the transitions, but they all
-      performed worse: storing a vector transitions in the label group increases
-      memory usage and runtime; storing the transitions more compactly and
-      incrementally increasing the size of transitions_of_groups whenever a
-      new label group is added also increases runtime. See also issue492 and
-      issue521.
+      The transitions of all label groups are stored in one buffer
+      (compressed sparse row layout): the transitions of the group with ID
+      id are at positions [group_offsets[id], group_offsets[id] +
+      group_sizes[id]) of transitions. The ID of a group does not change.
+      The ranges of the non-empty groups are ordered by group ID and do not
+      overlap, but there can be unused space between them, which is
+      reclaimed by compact_transitions().
+
+      Compared to a separate vector per group, this avoids many small
+      allocations when computing products, abstractions and label
+      reductions, and abstractions can be applied in place.
     */
-    std::vector<std::vector<Transition>> transitions_by_group_id;
+    std::vector<Transition> transitions;
+    std::vector<std::size_t> group_offsets;
+    std::vector<std::size_t> group_sizes;
 
     int num_states;
     std::vector<bool> goal_states;
@@ -126,8 +165,21 @@ private:
     */
     void compute_locally_equivalent_labels();
 
-    const std::vector<Transition> &get_transitions_for_group_id(int group_id) const {
-        return transitions_by_group_id[group_id];
+    // Append a group with the given transitions at the end of the buffer.
+    void add_group_transitions(const std::vector<Transition> &new_transitions);
+
+    /*
+      Move the transitions of all non-empty groups to the front of the
+      buffer, optionally mapping the states with abstraction_mapping (and
+      dropping transitions with pruned states). The transitions of each group
+      are sorted and duplicates are removed. The buffer is shrunk if more
+      than half of its capacity is unused.
+    */
+    void compact_transitions(const std::vector<int> *abstraction_mapping = nullptr);
+
+    TransitionRange get_transitions_for_group_id(int group_id) const {
+        const Transition *first = transitions.data() + group_offsets[group_id];
+        return TransitionRange(first, first + group_sizes[group_id]);
     }
 
     // Statistics and output
@@ -138,7 +190,9 @@ public:
         int num_variables,
         std::vector<int> &&incorporated_variables,
         std::unique_ptr<LabelEquivalenceRelation> &&label_equivalence_relation,
-        std::vector<std::vector<Transition>> &&transitions_by_group_id,
+        std::vector<Transition> &&transitions,
+        std::vector<std::size_t> &&group_offsets,
+        std::vector<std::size_t> &&group_sizes,
         int num_states,
         std::vector<bool> &&goal_states,
         int init_state);
@@ -178,15 +232,11 @@ public:
         bool only_equivalent_labels);
 
     TSConstIterator begin() const {
-        return TSConstIterator(*label_equivalence_relation,
-                               transitions_by_group_id,
-                               false);
+        return TSConstIterator(*this, false);
     }
 
     TSConstIterator end() const {
-        return TSConstIterator(*label_equivalence_relation,
-                               transitions_by_group_id,
-                               true);
+        return TSConstIterator(*this, true);
     }
 
     /*
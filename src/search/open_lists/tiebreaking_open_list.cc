@@ -7,6 +7,7 @@
 
 #include "../utils/memory.h"
 
+#include <algorithm>
 #include <cassert>
 #include <deque>
 #include <map>
@@ -16,6 +17,40 @@
 using namespace std;
 
 namespace tiebreaking_open_list {
+/*
+  Dead-end detection shared by the open lists in this file. If one safe
+  evaluator detects a dead end, the state is a reliable dead end.
+*/
+static bool is_reliable_dead_end(
+    const vector<shared_ptr<Evaluator>> &evaluators,
+    EvaluationContext &eval_context) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
+            evaluator->dead_ends_are_reliable())
+            return true;
+    return false;
+}
+
+static bool is_dead_end(
+    const vector<shared_ptr<Evaluator>> &evaluators,
+    bool allow_unsafe_pruning,
+    EvaluationContext &eval_context) {
+    // TODO: Properly document this behaviour.
+    // If one safe heuristic detects a dead end, return true.
+    if (is_reliable_dead_end(evaluators, eval_context))
+        return true;
+    // If the first heuristic detects a dead-end and we allow "unsafe
+    // pruning", return true.
+    if (allow_unsafe_pruning &&
+        eval_context.is_evaluator_value_infinite(evaluators[0].get()))
+        return true;
+    // Otherwise, return true if all heuristics agree this is a dead-end.
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
+            return false;
+    return true;
+}
+
 template<class Entry>
 class TieBreakingOpenList : public OpenList<Entry> {
     using Bucket = deque<Entry>;
@@ -41,6 +76,11 @@ public:
     explicit TieBreakingOpenList(const Options &opts);
     virtual ~TieBreakingOpenList() override = default;
 
+    // Insert an entry whose key has already been computed.
+    void insert_with_key(const vector<int> &key, const Entry &entry);
+    // Return the key of the entry that remove_min() returns next.
+    const vector<int> &get_min_key() const;
+
     virtual Entry remove_min() override;
     virtual bool empty() const override;
     virtual void clear() override;
@@ -66,11 +106,22 @@ void TieBreakingOpenList<Entry>::do_insertion(
     key.reserve(evaluators.size());
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
         key.push_back(eval_context.get_evaluator_value_or_infinity(evaluator.get()));
+    insert_with_key(key, entry);
+}
 
+template<class Entry>
+void TieBreakingOpenList<Entry>::insert_with_key(
+    const vector<int> &key, const Entry &entry) {
     buckets[key].push_back(entry);
     ++size;
 }
 
+template<class Entry>
+const vector<int> &TieBreakingOpenList<Entry>::get_min_key() const {
+    assert(size > 0);
+    return buckets.begin()->first;
+}
+
 template<class Entry>
 Entry TieBreakingOpenList<Entry>::remove_min() {
     assert(size > 0);
@@ -112,48 +163,339 @@ void TieBreakingOpenList<Entry>::get_path_dependent_evaluators(
 template<class Entry>
 bool TieBreakingOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
-    // TODO: Properly document this behaviour.
-    // If one safe heuristic detects a dead end, return true.
-    if (is_reliable_dead_end(eval_context))
-        return true;
-    // If the first heuristic detects a dead-end and we allow "unsafe
-    // pruning", return true.
-    if (allow_unsafe_pruning &&
-        eval_context.is_evaluator_value_infinite(evaluators[0].get()))
-        return true;
-    // Otherwise, return true if all heuristics agree this is a dead-end.
-    for (const shared_ptr<Evaluator> &evaluator : evaluators)
-        if (!eval_context.is_evaluator_value_infinite(evaluator.get()))
-            return false;
-    return true;
+    return tiebreaking_open_list::is_dead_end(
+        evaluators, allow_unsafe_pruning, eval_context);
 }
 
 template<class Entry>
 bool TieBreakingOpenList<Entry>::is_reliable_dead_end(
     EvaluationContext &eval_context) const {
+    return tiebreaking_open_list::is_reliable_dead_end(
+        evaluators, eval_context);
+}
+
+
+/*
+  Tie-breaking open list for one or two evaluators, which is the common case
+  of A* with tie-breaking on h. It expands entries in the same order as
+  TieBreakingOpenList, but stores entries with non-negative keys in a dense
+  two-level array of buckets (first over the first key component, then over
+  the second one) instead of a map with vector keys. Each bucket is a FIFO
+  queue of fixed-size chunks that are taken from and returned to a shared
+  pool, so that inserting and removing entries usually does not allocate
+  memory.
+
+  The array grows with the largest keys seen so far and holds at most
+  MAX_NUM_SLOTS rows and buckets in total. Entries whose key would exceed
+  this limit (e.g., infinite estimates or large action costs) are stored in
+  a TieBreakingOpenList instead. Once a key does not fit into the array, it
+  never fits later, so entries with equal keys are never split between the
+  array and the fallback list.
+*/
+template<class Entry>
+class BucketTieBreakingOpenList : public OpenList<Entry> {
+    static const int MAX_NUM_SLOTS = 1 << 20;
+    static const int CHUNK_SIZE = 32;
+    static const int NO_CHUNK = -1;
+
+    struct Chunk {
+        vector<Entry> entries;
+        int next;
+    };
+
+    // Entries of a bucket are chunk_pool[first_chunk].entries[begin:] etc.
+    struct Bucket {
+        int first_chunk = NO_CHUNK;
+        int last_chunk = NO_CHUNK;
+        int begin = 0;
+
+        bool empty() const {
+            return first_chunk == NO_CHUNK;
+        }
+    };
+
+    struct Row {
+        vector<Bucket> buckets;
+        // All buckets with a lower second key component are empty.
+        int min_bucket = 0;
+        int size = 0;
+    };
+
+    vector<Row> rows;
+    // All rows with a lower first key component are empty.
+    int min_row;
+    // Number of rows plus the number of buckets in all rows.
+    int num_slots;
+    int num_bucket_entries;
+    vector<Chunk> chunk_pool;
+    vector<int> free_chunks;
+
+    TieBreakingOpenList<Entry> overflow_list;
+    int size;
+
+    vector<shared_ptr<Evaluator>> evaluators;
+    // See TieBreakingOpenList.
+    bool allow_unsafe_pruning;
+
+    bool fits_into_buckets(int first_key, int second_key) const;
+    int allocate_chunk();
+    void push_back(Bucket &bucket, const Entry &entry);
+    Entry pop_front(Bucket &bucket);
+    Bucket &get_min_bucket(int &first_key, int &second_key);
+    Entry remove_min_from_buckets();
+
+protected:
+    virtual void do_insertion(EvaluationContext &eval_context,
+                              const Entry &entry) override;
+
+public:
+    explicit BucketTieBreakingOpenList(const Options &opts);
+    virtual ~BucketTieBreakingOpenList() override = default;
+
+    virtual Entry remove_min() override;
+    virtual bool empty() const override;
+    virtual void clear() override;
+    virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual bool is_dead_end(
+        EvaluationContext &eval_context) const override;
+    virtual bool is_reliable_dead_end(
+        EvaluationContext &eval_context) const override;
+};
+
+template<class Entry>
+BucketTieBreakingOpenList<Entry>::BucketTieBreakingOpenList(const Options &opts)
+    : OpenList<Entry>(opts.get<bool>("pref_only")),
+      min_row(0),
+      num_slots(0),
+      num_bucket_entries(0),
+      overflow_list(opts),
+      size(0),
+      evaluators(opts.get_list<shared_ptr<Evaluator>>("evals")),
+      allow_unsafe_pruning(opts.get<bool>("unsafe_pruning")) {
+    assert(evaluators.size() == 1 || evaluators.size() == 2);
+}
+
+template<class Entry>
+bool BucketTieBreakingOpenList<Entry>::fits_into_buckets(
+    int first_key, int second_key) const {
+    if (first_key < 0 || first_key >= MAX_NUM_SLOTS ||
+        second_key < 0 || second_key >= MAX_NUM_SLOTS) {
+        return false;
+    }
+    int num_rows = rows.size();
+    int num_new_rows = max(0, first_key + 1 - num_rows);
+    int row_length = 0;
+    if (first_key < num_rows) {
+        row_length = rows[first_key].buckets.size();
+    }
+    int num_new_buckets = max(0, second_key + 1 - row_length);
+    return num_slots + num_new_rows + num_new_buckets <= MAX_NUM_SLOTS;
+}
+
+template<class Entry>
+int BucketTieBreakingOpenList<Entry>::allocate_chunk() {
+    int chunk_id;
+    if (free_chunks.empty()) {
+        chunk_id = chunk_pool.size();
+        chunk_pool.emplace_back();
+        chunk_pool.back().entries.reserve(CHUNK_SIZE);
+    } else {
+        chunk_id = free_chunks.back();
+        free_chunks.pop_back();
+        chunk_pool[chunk_id].entries.clear();
+    }
+    chunk_pool[chunk_id].next = NO_CHUNK;
+    return chunk_id;
+}
+
+template<class Entry>
+void BucketTieBreakingOpenList<Entry>::push_back(
+    Bucket &bucket, const Entry &entry) {
+    if (bucket.empty()) {
+        bucket.first_chunk = bucket.last_chunk = allocate_chunk();
+        bucket.begin = 0;
+    } else if (chunk_pool[bucket.last_chunk].entries.size() == CHUNK_SIZE) {
+        int chunk_id = allocate_chunk();
+        chunk_pool[bucket.last_chunk].next = chunk_id;
+        bucket.last_chunk = chunk_id;
+    }
+    chunk_pool[bucket.last_chunk].entries.push_back(entry);
+}
+
+template<class Entry>
+Entry BucketTieBreakingOpenList<Entry>::pop_front(Bucket &bucket) {
+    assert(!bucket.empty());
+    Chunk &chunk = chunk_pool[bucket.first_chunk];
+    Entry result = chunk.entries[bucket.begin++];
+    if (bucket.begin == static_cast<int>(chunk.entries.size())) {
+        // The first chunk is used up.
+        free_chunks.push_back(bucket.first_chunk);
+        bucket.first_chunk = chunk.next;
+        bucket.begin = 0;
+        if (bucket.first_chunk == NO_CHUNK) {
+            bucket.last_chunk = NO_CHUNK;
+        }
+    }
+    return result;
+}
+
+template<class Entry>
+void BucketTieBreakingOpenList<Entry>::do_insertion(
+    EvaluationContext &eval_context, const Entry &entry) {
+    int first_key = eval_context.get_evaluator_value_or_infinity(
+        evaluators[0].get());
+    int second_key = 0;
+    if (evaluators.size() == 2) {
+        second_key = eval_context.get_evaluator_value_or_infinity(
+            evaluators[1].get());
+    }
+    ++size;
+    if (!fits_into_buckets(first_key, second_key)) {
+        vector<int> key = {first_key};
+        if (evaluators.size() == 2) {
+            key.push_back(second_key);
+        }
+        overflow_list.insert_with_key(key, entry);
+        return;
+    }
+
+    if (first_key >= static_cast<int>(rows.size())) {
+        num_slots += first_key + 1 - rows.size();
+        rows.resize(first_key + 1);
+    }
+    Row &row = rows[first_key];
+    if (second_key >= static_cast<int>(row.buckets.size())) {
+        num_slots += second_key + 1 - row.buckets.size();
+        row.buckets.resize(second_key + 1);
+    }
+    push_back(row.buckets[second_key], entry);
+    ++row.size;
+    ++num_bucket_entries;
+    if (num_bucket_entries == 1 || first_key < min_row) {
+        min_row = first_key;
+    }
+    if (row.size == 1 || second_key < row.min_bucket) {
+        row.min_bucket = second_key;
+    }
+}
+
+template<class Entry>
+typename BucketTieBreakingOpenList<Entry>::Bucket &
+BucketTieBreakingOpenList<Entry>::get_min_bucket(int &first_key, int &second_key) {
+    assert(num_bucket_entries > 0);
+    while (rows[min_row].size == 0) {
+        ++min_row;
+    }
+    Row &row = rows[min_row];
+    while (row.buckets[row.min_bucket].empty()) {
+        ++row.min_bucket;
+    }
+    first_key = min_row;
+    second_key = row.min_bucket;
+    return row.buckets[row.min_bucket];
+}
+
+template<class Entry>
+Entry BucketTieBreakingOpenList<Entry>::remove_min_from_buckets() {
+    int first_key;
+    int second_key;
+    Bucket &bucket = get_min_bucket(first_key, second_key);
+    --rows[first_key].size;
+    --num_bucket_entries;
+    return pop_front(bucket);
+}
+
+template<class Entry>
+Entry BucketTieBreakingOpenList<Entry>::remove_min() {
+    assert(size > 0);
+    --size;
+    if (overflow_list.empty()) {
+        return remove_min_from_buckets();
+    } else if (num_bucket_entries == 0) {
+        return overflow_list.remove_min();
+    }
+    int first_key;
+    int second_key;
+    get_min_bucket(first_key, second_key);
+    vector<int> key = {first_key};
+    if (evaluators.size() == 2) {
+        key.push_back(second_key);
+    }
+    if (key < overflow_list.get_min_key()) {
+        return remove_min_from_buckets();
+    } else {
+        return overflow_list.remove_min();
+    }
+}
+
+template<class Entry>
+bool BucketTieBreakingOpenList<Entry>::empty() const {
+    return size == 0;
+}
+
+template<class Entry>
+void BucketTieBreakingOpenList<Entry>::clear() {
+    rows.clear();
+    min_row = 0;
+    num_slots = 0;
+    num_bucket_entries = 0;
+    chunk_pool.clear();
+    free_chunks.clear();
+    overflow_list.clear();
+    size = 0;
+}
+
+template<class Entry>
+void BucketTieBreakingOpenList<Entry>::get_path_dependent_evaluators(
+    set<Evaluator *> &evals) {
     for (const shared_ptr<Evaluator> &evaluator : evaluators)
-        if (eval_context.is_evaluator_value_infinite(evaluator.get()) &&
-            evaluator->dead_ends_are_reliable())
-            return true;
-    return false;
+        evaluator->get_path_dependent_evaluators(evals);
+}
+
+template<class Entry>
+bool BucketTieBreakingOpenList<Entry>::is_dead_end(
+    EvaluationContext &eval_context) const {
+    return tiebreaking_open_list::is_dead_end(
+        evaluators, allow_unsafe_pruning, eval_context);
+}
+
+template<class Entry>
+bool BucketTieBreakingOpenList<Entry>::is_reliable_dead_end(
+    EvaluationContext &eval_context) const {
+    return tiebreaking_open_list::is_reliable_dead_end(
+        evaluators, eval_context);
 }
 
 TieBreakingOpenListFactory::TieBreakingOpenListFactory(const Options &options)
     : options(options) {
 }
 
+bool TieBreakingOpenListFactory::use_buckets() const {
+    int num_evaluators = options.get_list<shared_ptr<Evaluator>>("evals").size();
+    return num_evaluators <= 2;
+}
+
 unique_ptr<StateOpenList>
 TieBreakingOpenListFactory::create_state_open_list() {
+    if (use_buckets())
+        return utils::make_unique_ptr<BucketTieBreakingOpenList<StateOpenListEntry>>(options);
     return utils::make_unique_ptr<TieBreakingOpenList<StateOpenListEntry>>(options);
 }
 
 unique_ptr<EdgeOpenList>
 TieBreakingOpenListFactory::create_edge_open_list() {
+    if (use_buckets())
+        return utils::make_unique_ptr<BucketTieBreakingOpenList<EdgeOpenListEntry>>(options);
     return utils::make_unique_ptr<TieBreakingOpenList<EdgeOpenListEntry>>(options);
 }
 
 static shared_ptr<OpenListFactory> _parse(OptionParser &parser) {
-    parser.document_synopsis("Tie-breaking open list", "");
+    parser.document_synopsis(
+        "Tie-breaking open list",
+        "With one or two evaluators, entries with small non-negative keys "
+        "are stored in dense buckets instead of a map. The buckets cover at "
+        "most 2^20 keys; entries with other keys are stored in a map. This "
+        "does not change the order in which entries are removed.");
     parser.add_list_option<shared_ptr<Evaluator>>("evals", "evaluators");
     parser.add_option<bool>(
         "pref_only",
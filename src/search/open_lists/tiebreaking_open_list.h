@@ -7,6 +7,9 @@
 namespace tiebreaking_open_list {
 class TieBreakingOpenListFactory : public OpenListFactory {
     Options options;
+
+    // Use the bucket-based implementation for one or two evaluators.
+    bool use_buckets() const;
 public:
     explicit TieBreakingOpenListFactory(const Options &options);
     virtual ~TieBreakingOpenListFactory() override = default;
@@ -12,12 +12,18 @@
 using namespace std;
 
 namespace operator_counting {
+static const int WARM_START_CACHE_SIZE = 1024;
+
 OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
     : Heuristic(opts),
       constraint_generators(
           opts.get_list<shared_ptr<ConstraintGenerator>>("constraint_generators")),
       lp_solver(opts.get<lp::LPSolverType>("lpsolver")),
-      use_integer_operator_counts(opts.get<bool>("use_integer_operator_counts")) {
+      use_integer_operator_counts(opts.get<bool>("use_integer_operator_counts")),
+      use_warm_starts(opts.get<bool>("use_warm_starts")) {
+    if (use_warm_starts) {
+        warm_start_cache.resize(WARM_START_CACHE_SIZE);
+    }
     lp_solver.set_mip_gap(0);
     named_vector::NamedVector<lp::LPVariable> variables;
     double infinity = lp_solver.get_infinity();
@@ -35,6 +41,23 @@ OperatorCountingHeuristic::OperatorCountingHeuristic(const Options &opts)
 OperatorCountingHeuristic::~OperatorCountingHeuristic() {
 }
 
+OperatorCountingHeuristic::WarmStartEntry &OperatorCountingHeuristic::get_cache_entry(
+    const State &state) {
+    return warm_start_cache[state.get_id().hash() % warm_start_cache.size()];
+}
+
+void OperatorCountingHeuristic::notify_state_transition(
+    const State &parent_state, OperatorID, const State &state) {
+    const WarmStartEntry &parent_entry = get_cache_entry(parent_state);
+    next_warm_start.registry = state.get_registry();
+    next_warm_start.id = state.get_id();
+    if (parent_entry.matches(parent_state)) {
+        next_warm_start.warm_start = parent_entry.warm_start;
+    } else {
+        next_warm_start.warm_start = nullptr;
+    }
+}
+
 int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
     State state = convert_ancestor_state(ancestor_state);
     assert(!lp_solver.has_temporary_constraints());
@@ -45,12 +68,28 @@ int OperatorCountingHeuristic::compute_heuristic(const State &ancestor_state) {
             return DEAD_END;
         }
     }
+    // Heuristic values may also be computed for unregistered states.
+    bool is_registered = ancestor_state.get_registry() != nullptr;
+    if (use_warm_starts && is_registered) {
+        const WarmStartEntry &entry = get_cache_entry(ancestor_state);
+        if (entry.matches(ancestor_state)) {
+            lp_solver.set_warm_start(entry.warm_start);
+        } else if (next_warm_start.matches(ancestor_state)) {
+            lp_solver.set_warm_start(next_warm_start.warm_start);
+        }
+    }
     int result;
     lp_solver.solve();
     if (lp_solver.has_optimal_solution()) {
         double epsilon = 0.01;
         double objective_value = lp_solver.get_objective_value();
         result = ceil(objective_value - epsilon);
+        if (use_warm_starts && is_registered) {
+            WarmStartEntry &entry = get_cache_entry(ancestor_state);
+            entry.registry = ancestor_state.get_registry();
+            entry.id = ancestor_state.get_id();
+            entry.warm_start = lp_solver.get_warm_start();
+        }
     } else {
         result = DEAD_END;
     }
@@ -110,6 +149,20 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "increase the runtime.",
         "false");
 
+    parser.add_option<bool>(
+        "use_warm_starts",
+        "start solving the LP of a state from the optimal basis of its "
+        "parent instead of the basis of the previously evaluated state. The "
+        "bases of the last evaluated states are kept in a cache with " +
+        to_string(WARM_START_CACHE_SIZE) + " entries; if the basis of the "
+        "parent was evicted, solving starts from the previous LP as usual. "
+        "Cache entries are keyed by state registry and state ID, so states "
+        "of different searches using the same heuristic do not share bases. "
+        "Bases are only reused "
+        "between LPs without temporary constraints, i.e., they are not used "
+        "with lmcut_constraints() and integer operator counts.",
+        "false");
+
     lp::add_lp_solver_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
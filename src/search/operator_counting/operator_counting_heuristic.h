@@ -8,6 +8,8 @@
 #include <memory>
 #include <vector>
 
+class CoinWarmStart;
+
 namespace options {
 class Options;
 }
@@ -19,11 +21,55 @@ class OperatorCountingHeuristic : public Heuristic {
     std::vector<std::shared_ptr<ConstraintGenerator>> constraint_generators;
     lp::LPSolver lp_solver;
     const bool use_integer_operator_counts;
+    const bool use_warm_starts;
+    /*
+      Optimal LP basis of a registered state. State IDs are only unique
+      within a state registry, and an evaluator can be used with several
+      registries (e.g., by the iterations of an iterated search), so the
+      registry is part of the key. If a registry is destroyed and a new one
+      is allocated at the same address, an entry can refer to a state of
+      the old registry. This only leads to a worse starting basis, since
+      the LP is always solved to optimality.
+    */
+    struct WarmStartEntry {
+        const StateRegistry *registry;
+        StateID id;
+        std::shared_ptr<CoinWarmStart> warm_start;
+
+        WarmStartEntry()
+            : registry(nullptr), id(StateID::no_state) {
+        }
+
+        bool matches(const State &state) const {
+            return registry == state.get_registry() && id == state.get_id();
+        }
+    };
+
+    /*
+      Direct-mapped cache of the optimal LP bases of recently evaluated
+      states, indexed by state ID. Older bases are overwritten, so memory
+      usage does not grow with the number of states.
+    */
+    std::vector<WarmStartEntry> warm_start_cache;
+    // Basis of the parent of the state that is evaluated next.
+    WarmStartEntry next_warm_start;
+
+    WarmStartEntry &get_cache_entry(const State &state);
 protected:
     virtual int compute_heuristic(const State &ancestor_state) override;
 public:
     explicit OperatorCountingHeuristic(const options::Options &opts);
     ~OperatorCountingHeuristic();
+
+    virtual void get_path_dependent_evaluators(
+        std::set<Evaluator *> &evals) override {
+        if (use_warm_starts) {
+            evals.insert(this);
+        }
+    }
+
+    virtual void notify_state_transition(
+        const State &parent_state, OperatorID op_id, const State &state) override;
 };
 }
 
@@ -2,6 +2,8 @@
 
 #include "pattern_database.h"
 
+#include "../task_proxy.h"
+
 #include <algorithm>
 #include <cassert>
 #include <iostream>
@@ -16,26 +18,55 @@ CanonicalPDBs::CanonicalPDBs(
     : pdbs(pdbs), pattern_cliques(pattern_cliques) {
     assert(pdbs);
     assert(pattern_cliques);
+    pdb_pointers.reserve(pdbs->size());
+    hash_ends.reserve(pdbs->size());
+    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
+        pdb_pointers.push_back(pdb.get());
+        const Pattern &pattern = pdb->get_pattern();
+        const vector<int> &multipliers = pdb->get_hash_multipliers();
+        hash_vars.insert(hash_vars.end(), pattern.begin(), pattern.end());
+        hash_multipliers.insert(
+            hash_multipliers.end(), multipliers.begin(), multipliers.end());
+        hash_ends.push_back(hash_vars.size());
+    }
+    clique_ends.reserve(pattern_cliques->size());
+    for (const PatternClique &clique : *pattern_cliques) {
+        clique_pdb_ids.insert(clique_pdb_ids.end(), clique.begin(), clique.end());
+        clique_ends.push_back(clique_pdb_ids.size());
+    }
+    h_values.resize(pdbs->size());
 }
 
 int CanonicalPDBs::get_value(const State &state) const {
     // If we have an empty collection, then pattern_cliques = { \emptyset }.
     assert(!pattern_cliques->empty());
-    int max_h = 0;
-    vector<int> h_values;
-    h_values.reserve(pdbs->size());
     state.unpack();
-    for (const shared_ptr<PatternDatabase> &pdb : *pdbs) {
-        int h = pdb->get_value(state.get_unpacked_values());
+    const vector<int> &values = state.get_unpacked_values();
+    int num_pdbs = pdb_pointers.size();
+
+    int pos = 0;
+    for (int i = 0; i < num_pdbs; ++i) {
+        int index = 0;
+        for (int end = hash_ends[i]; pos < end; ++pos) {
+            index += hash_multipliers[pos] * values[hash_vars[pos]];
+        }
+        h_values[i] = index;
+        pdb_pointers[i]->prefetch_value(index);
+    }
+    for (int i = 0; i < num_pdbs; ++i) {
+        int h = pdb_pointers[i]->get_value_for_index(h_values[i]);
         if (h == numeric_limits<int>::max()) {
             return numeric_limits<int>::max();
         }
-        h_values.push_back(h);
+        h_values[i] = h;
     }
-    for (const PatternClique &clique : *pattern_cliques) {
+
+    int max_h = 0;
+    pos = 0;
+    for (int end : clique_ends) {
         int clique_h = 0;
-        for (PatternID pdb_index : clique) {
-            clique_h += h_values[pdb_index];
+        for (; pos < end; ++pos) {
+            clique_h += h_values[clique_pdb_ids[pos]];
         }
         max_h = max(max_h, clique_h);
     }
@@ -12,12 +12,34 @@ class CanonicalPDBs {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
 
+    /*
+      Flat layout of the data needed for evaluating states. The pattern
+      variables and hash multipliers of PDB i are stored at the positions
+      [hash_ends[i - 1], hash_ends[i]) of hash_vars and hash_multipliers, and
+      the PDB ids of clique i at [clique_ends[i - 1], clique_ends[i]) of
+      clique_pdb_ids (with an implicit start of 0 for i = 0).
+    */
+    std::vector<const PatternDatabase *> pdb_pointers;
+    std::vector<int> hash_vars;
+    std::vector<int> hash_multipliers;
+    std::vector<int> hash_ends;
+    std::vector<int> clique_pdb_ids;
+    std::vector<int> clique_ends;
+
+    // Scratch space for the hash indices and h values of the PDBs.
+    mutable std::vector<int> h_values;
+
 public:
     CanonicalPDBs(
         const std::shared_ptr<PDBCollection> &pdbs,
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
     ~CanonicalPDBs() = default;
 
+    /*
+      Compute the hash indices of all PDBs in one pass over the state,
+      prefetch the table entries and then take the maximum over the sums of
+      the h values of the cliques.
+    */
     int get_value(const State &state) const;
 };
 }
@@ -1,20 +1,23 @@
 #include "incremental_canonical_pdbs.h"
 
-#include "canonical_pdbs.h"
 #include "pattern_database.h"
 
+#include "../utils/memory.h"
+
 #include <limits>
 
 using namespace std;
 
 namespace pdbs {
 IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
-    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns)
+    const TaskProxy &task_proxy, const PatternCollection &intitial_patterns,
+    bool compress_pdbs)
     : task_proxy(task_proxy),
       patterns(make_shared<PatternCollection>(intitial_patterns.begin(),
                                               intitial_patterns.end())),
       pattern_databases(make_shared<PDBCollection>()),
       pattern_cliques(nullptr),
+      compress_pdbs(compress_pdbs),
       size(0) {
     pattern_databases->reserve(patterns->size());
     for (const Pattern &pattern : *patterns)
@@ -25,19 +28,24 @@ IncrementalCanonicalPDBs::IncrementalCanonicalPDBs(
 
 void IncrementalCanonicalPDBs::add_pdb_for_pattern(const Pattern &pattern) {
     pattern_databases->push_back(make_shared<PatternDatabase>(task_proxy, pattern));
-    size += pattern_databases->back()->get_size();
+    if (compress_pdbs) {
+        pattern_databases->back()->compress_distances();
+    }
+    size += pattern_databases->back()->get_distance_table_size();
 }
 
 void IncrementalCanonicalPDBs::add_pdb(const shared_ptr<PatternDatabase> &pdb) {
     patterns->push_back(pdb->get_pattern());
     pattern_databases->push_back(pdb);
-    size += pattern_databases->back()->get_size();
+    size += pattern_databases->back()->get_distance_table_size();
     recompute_pattern_cliques();
 }
 
 void IncrementalCanonicalPDBs::recompute_pattern_cliques() {
     pattern_cliques = compute_pattern_cliques(*patterns,
                                               are_additive);
+    canonical_pdbs = utils::make_unique_ptr<CanonicalPDBs>(
+        pattern_databases, pattern_cliques);
 }
 
 vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
@@ -47,8 +55,7 @@ vector<PatternClique> IncrementalCanonicalPDBs::get_pattern_cliques(
 }
 
 int IncrementalCanonicalPDBs::get_value(const State &state) const {
-    CanonicalPDBs canonical_pdbs(pattern_databases, pattern_cliques);
-    return canonical_pdbs.get_value(state);
+    return canonical_pdbs->get_value(state);
 }
 
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
@@ -1,6 +1,7 @@
 #ifndef PDBS_INCREMENTAL_CANONICAL_PDBS_H
 #define PDBS_INCREMENTAL_CANONICAL_PDBS_H
 
+#include "canonical_pdbs.h"
 #include "pattern_cliques.h"
 #include "pattern_collection_information.h"
 #include "types.h"
@@ -16,11 +17,20 @@ class IncrementalCanonicalPDBs {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pattern_databases;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
+    // Evaluator for the current collection, rebuilt when the collection changes.
+    std::unique_ptr<CanonicalPDBs> canonical_pdbs;
 
     // A pair of variables is additive if no operator has an effect on both.
     VariableAdditivity are_additive;
 
-    // The sum of all abstract state sizes of all pdbs in the collection.
+    // Store the distances of the PDBs built here in packed form.
+    bool compress_pdbs;
+
+    /*
+      The sum of the distance table sizes (in 32-bit words) of all pdbs in
+      the collection. Without compression, this is the number of abstract
+      states.
+    */
     int size;
 
     // Adds a PDB for pattern but does not recompute pattern_cliques.
@@ -29,7 +39,8 @@ class IncrementalCanonicalPDBs {
     void recompute_pattern_cliques();
 public:
     IncrementalCanonicalPDBs(const TaskProxy &task_proxy,
-                             const PatternCollection &intitial_patterns);
+                             const PatternCollection &intitial_patterns,
+                             bool compress_pdbs = false);
     virtual ~IncrementalCanonicalPDBs() = default;
 
     // Adds a new PDB to the collection and recomputes pattern_cliques.
@@ -54,7 +54,8 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "maximum abstraction size for combo strategy",
         "1000000",
         Bounds("1", "infinity"));
-    add_generator_options_to_parser(parser);
+    add_pdb_construction_options_to_parser(parser);
+    add_collection_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -383,7 +383,8 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "false");
 
     utils::add_rng_options(parser);
-    add_generator_options_to_parser(parser);
+    add_pdb_construction_options_to_parser(parser);
+    add_collection_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
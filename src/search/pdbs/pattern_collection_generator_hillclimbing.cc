@@ -18,6 +18,7 @@
 #include "../utils/markup.h"
 #include "../utils/math.h"
 #include "../utils/memory.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
 #include "../utils/timer.h"
@@ -133,7 +134,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     PDBCollection &candidate_pdbs) {
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         assert(utils::in_bounds(pattern_var, relevant_neighbours));
         const vector<int> &connected_vars = relevant_neighbours[pattern_var];
@@ -160,16 +161,28 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    /*
+      The candidate PDBs are independent, so we build them concurrently.
+      Compressed PDBs are built with an uncompressed distance table and
+      packed afterwards, so limiting the number of abstract states by
+      pdb_max_size also bounds the temporary memory of each build.
+    */
+    shared_ptr<PDBCollection> new_pdbs = compute_pdbs(
+        task_proxy, new_patterns, num_threads, max_parallel_states,
+        compress_pdbs);
+    int max_pdb_size = 0;
+    for (const shared_ptr<PatternDatabase> &new_pdb : *new_pdbs) {
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+        candidate_pdbs.push_back(new_pdb);
+    }
     return max_pdb_size;
 }
 
@@ -203,53 +216,66 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
       We require that a pattern must have an improvement of at least one in
       order to be taken into account.
     */
-    int improvement = 0;
-    int best_pdb_index = -1;
-
-    // Iterate over all candidates and search for the best improving pattern/pdb
-    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
+    int num_candidates = candidate_pdbs.size();
+    /*
+      If a candidate's size added to the current collection's size exceeds
+      the maximum collection size, then forget the pdb.
+    */
+    for (int i = 0; i < num_candidates; ++i) {
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
-        if (!pdb) {
-            /* candidate pattern is too large or has already been added to
-               the canonical heuristic. */
-            continue;
-        }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
-        int combined_size = current_pdbs->get_size() + pdb->get_size();
-        if (combined_size > collection_max_size) {
+        if (pdb && current_pdbs->get_size() + pdb->get_distance_table_size() >
+            collection_max_size) {
             candidate_pdbs[i] = nullptr;
-            continue;
         }
+    }
+
+    // Make sure that the sample states can be read by all threads.
+    for (const State &sample : samples) {
+        sample.unpack();
+    }
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        vector<PatternClique> pattern_cliques =
-            current_pdbs->get_pattern_cliques(pdb->get_pattern());
-        for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
-            const State &sample = samples[sample_id];
-            assert(utils::in_bounds(sample_id, samples_h_values));
-            int h_collection = samples_h_values[sample_id];
-            if (is_heuristic_improved(
-                    *pdb, sample, h_collection,
-                    *current_pdbs->get_pattern_databases(), pattern_cliques)) {
-                ++count;
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+      The candidates are evaluated independently of each other, so we
+      distribute them over the threads. Threads skip the remaining
+      candidates when the time limit is reached.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    const PDBCollection &pdbs = *current_pdbs->get_pattern_databases();
+    vector<int> counts(num_candidates, 0);
+    utils::run_in_parallel(num_candidates, num_threads, [&](int i) {
+            const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
+            if (!pdb || hill_climbing_timer->is_expired()) {
+                /* candidate pattern is too large or has already been added to
+                   the canonical heuristic. */
+                return;
             }
-        }
+            vector<PatternClique> pattern_cliques =
+                current_pdbs->get_pattern_cliques(pdb->get_pattern());
+            for (int sample_id = 0; sample_id < num_samples; ++sample_id) {
+                const State &sample = samples[sample_id];
+                assert(utils::in_bounds(sample_id, samples_h_values));
+                int h_collection = samples_h_values[sample_id];
+                if (is_heuristic_improved(
+                        *pdb, sample, h_collection, pdbs, pattern_cliques)) {
+                    ++counts[i];
+                }
+            }
+        });
+    if (hill_climbing_timer->is_expired())
+        throw HillClimbingTimeout();
+
+    // Search for the best improving pattern/pdb
+    int improvement = 0;
+    int best_pdb_index = -1;
+    for (int i = 0; i < num_candidates; ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -447,7 +473,7 @@ PatternCollectionInformation PatternCollectionGeneratorHillclimbing::compute_pat
         initial_pattern_collection.emplace_back(1, goal_var_id);
     }
     current_pdbs = utils::make_unique_ptr<IncrementalCanonicalPDBs>(
-        task_proxy, initial_pattern_collection);
+        task_proxy, initial_pattern_collection, compress_pdbs);
     if (log.is_at_least_normal()) {
         log << "Done calculating initial pattern collection: " << timer << endl;
     }
@@ -522,12 +548,18 @@ void add_hillclimbing_options(OptionParser &parser) {
 
     parser.add_option<int>(
         "pdb_max_size",
-        "maximal number of states per pattern database ",
+        "maximal number of states per pattern database. This also holds "
+        "with compress_pdbs: each candidate PDB is first built with an "
+        "uncompressed distance table of one 32-bit word per state and only "
+        "packed afterwards, so this limit bounds the temporary memory of "
+        "building a candidate.",
         "2000000",
         Bounds("1", "infinity"));
     parser.add_option<int>(
         "collection_max_size",
-        "maximal number of states in the pattern collection",
+        "maximal number of states in the pattern collection. With "
+        "compress_pdbs, this limits the total size of the packed distance "
+        "tables instead, measured in 32-bit words.",
         "20000000",
         Bounds("1", "infinity"));
     parser.add_option<int>(
@@ -553,7 +585,8 @@ void add_hillclimbing_options(OptionParser &parser) {
         "infinity",
         Bounds("0.0", "infinity"));
     utils::add_rng_options(parser);
-    add_generator_options_to_parser(parser);
+    add_pdb_construction_options_to_parser(parser);
+    add_collection_generator_options_to_parser(parser);
 }
 
 void check_hillclimbing_options(
@@ -27,9 +27,15 @@ class PatternDatabase;
 
 // Implementation of the pattern generation algorithm by Haslum et al.
 class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator {
-    // maximum number of states for each pdb
+    /*
+      Maximum number of abstract states of each pdb and added size of all
+      pdbs, measured by the size of their distance tables in 32-bit words
+      (see PatternDatabase::get_distance_table_size). Without compression,
+      the latter is the number of abstract states. PDBs are built
+      uncompressed and packed afterwards, so pdb_max_size counts states
+      even with compression to bound the memory needed for building them.
+    */
     const int pdb_max_size;
-    // maximum added size of all pdbs
     const int collection_max_size;
     const int num_samples;
     // minimal improvement required for hill climbing to continue search
@@ -48,7 +54,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The new
+      PDBs are built concurrently (see compute_pdbs in utils.h).
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -77,7 +84,9 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     /*
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
-      the index of the best pdb in candidate_pdbs.
+      the index of the best pdb in candidate_pdbs. The candidates are
+      evaluated on num_threads threads; ties are broken in favour of the
+      first candidate, as in a sequential evaluation.
     */
     std::pair<int, int> find_best_improving_pdb(
         const std::vector<State> &samples,
@@ -36,7 +36,8 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "patterns",
         "list of patterns (which are lists of variable numbers of the planning "
         "task).");
-    add_generator_options_to_parser(parser);
+    add_pdb_construction_options_to_parser(parser);
+    add_collection_generator_options_to_parser(parser);
 
     Options opts = parser.parse();
     if (parser.dry_run())
@@ -30,6 +30,9 @@ class PatternCollectionInformation {
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<std::vector<PatternClique>> pattern_cliques;
     utils::LogProxy &log;
+    int num_threads;
+    int max_parallel_states;
+    bool compress_pdbs;
 
     void create_pdbs_if_missing();
     void create_pattern_cliques_if_missing();
@@ -43,6 +46,15 @@ public:
     ~PatternCollectionInformation() = default;
 
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
+    /*
+      Build missing PDBs on up to num_threads threads with at most
+      max_parallel_states abstract states under construction at a time
+      and store their distances in packed form if compress_pdbs is true
+      (see compute_pdbs in utils.h). By default, PDBs are built sequentially
+      and not compressed.
+    */
+    void set_pdb_construction_options(
+        int num_threads, int max_parallel_states, bool compress_pdbs);
     void set_pattern_cliques(
         const std::shared_ptr<std::vector<PatternClique>> &pattern_cliques);
 
@@ -72,6 +72,51 @@ void AbstractOperator::dump(const Pattern &pattern,
     }
 }
 
+PackedDistanceTable::PackedDistanceTable()
+    : bits_per_entry(0),
+      log_entries_per_word(0),
+      mask(0) {
+}
+
+PackedDistanceTable::PackedDistanceTable(
+    const vector<int> &distances, int bits_per_entry)
+    : bits_per_entry(bits_per_entry),
+      log_entries_per_word(0),
+      mask((uint64_t(1) << bits_per_entry) - 1) {
+    assert(bits_per_entry > 0 && bits_per_entry <= 16);
+    assert((bits_per_entry & (bits_per_entry - 1)) == 0);
+    while ((bits_per_entry << log_entries_per_word) < 64) {
+        ++log_entries_per_word;
+    }
+    int entries_per_word = 1 << log_entries_per_word;
+    words.resize((distances.size() + entries_per_word - 1) / entries_per_word, 0);
+    for (size_t i = 0; i < distances.size(); ++i) {
+        uint64_t value = mask;
+        if (distances[i] != numeric_limits<int>::max()) {
+            assert(static_cast<uint64_t>(distances[i]) < mask);
+            value = distances[i];
+        }
+        int entry = i & (entries_per_word - 1);
+        words[i >> log_entries_per_word] |= value << (entry * bits_per_entry);
+    }
+}
+
+int PackedDistanceTable::compute_bits_per_entry(const vector<int> &distances) {
+    int max_distance = 0;
+    for (int distance : distances) {
+        if (distance != numeric_limits<int>::max()) {
+            max_distance = max(max_distance, distance);
+        }
+    }
+    for (int bits = 1; bits <= 16; bits *= 2) {
+        // The largest value of each width is reserved for dead ends.
+        if (max_distance < (1 << bits) - 1) {
+            return bits;
+        }
+    }
+    return 0;
+}
+
 PatternDatabase::PatternDatabase(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
@@ -366,15 +411,29 @@ int PatternDatabase::hash_index(const vector<int> &state) const {
 }
 
 int PatternDatabase::get_value(const vector<int> &state) const {
-    return distances[hash_index(state)];
+    return get_value_for_index(hash_index(state));
+}
+
+void PatternDatabase::compress_distances() {
+    if (has_compressed_distances()) {
+        return;
+    }
+    int bits_per_entry = PackedDistanceTable::compute_bits_per_entry(distances);
+    if (bits_per_entry == 0) {
+        return;
+    }
+    packed_distances = PackedDistanceTable(distances, bits_per_entry);
+    utils::release_vector_memory(distances);
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
-    for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+    for (int i = 0; i < num_states; ++i) {
+        int distance = has_compressed_distances() ?
+            packed_distances.get(i) : distances[i];
+        if (distance != numeric_limits<int>::max()) {
+            sum += distance;
             ++size;
         }
     }
@@ -5,6 +5,8 @@
 
 #include "../task_proxy.h"
 
+#include <cstdint>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -81,6 +83,61 @@ public:
               utils::LogProxy &log) const;
 };
 
+/*
+  Table of distances that stores every entry with the same number of bits
+  (a power of two up to 16, so that no entry spans two words). The largest
+  representable value marks dead ends.
+*/
+class PackedDistanceTable {
+    int bits_per_entry;
+    int log_entries_per_word;
+    std::uint64_t mask;
+    std::vector<std::uint64_t> words;
+public:
+    PackedDistanceTable();
+    /*
+      Pack the given distances with the given number of bits per entry (see
+      compute_bits_per_entry). Dead ends are represented by
+      numeric_limits<int>::max().
+    */
+    PackedDistanceTable(const std::vector<int> &distances, int bits_per_entry);
+
+    /*
+      Return the smallest supported number of bits per entry that can
+      represent all finite distances and the dead-end marker, or 0 if the
+      distances are too large to be packed.
+    */
+    static int compute_bits_per_entry(const std::vector<int> &distances);
+
+    bool empty() const {
+        return words.empty();
+    }
+
+    int get_bits_per_entry() const {
+        return bits_per_entry;
+    }
+
+    int get_num_words() const {
+        return words.size();
+    }
+
+    void prefetch(int index) const {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&words[index >> log_entries_per_word]);
+#else
+        (void)index;
+#endif
+    }
+
+    int get(int index) const {
+        std::uint64_t word = words[index >> log_entries_per_word];
+        int entry = index & ((1 << log_entries_per_word) - 1);
+        std::uint64_t value = (word >> (entry * bits_per_entry)) & mask;
+        return value == mask ? std::numeric_limits<int>::max()
+               : static_cast<int>(value);
+    }
+};
+
 // Implements a single pattern database
 class PatternDatabase {
     Pattern pattern;
@@ -93,6 +150,8 @@ class PatternDatabase {
       dead-ends are represented by numeric_limits<int>::max()
     */
     std::vector<int> distances;
+    // Replaces distances after compress_distances() has been called.
+    PackedDistanceTable packed_distances;
 
     std::vector<int> generating_op_ids;
     std::vector<std::vector<OperatorID>> wildcard_plan;
@@ -186,16 +245,67 @@ public:
 
     int get_value(const std::vector<int> &state) const;
 
+    // Returns the h value of the abstract state with the given hash index.
+    int get_value_for_index(int index) const {
+        if (has_compressed_distances()) {
+            return packed_distances.get(index);
+        }
+        return distances[index];
+    }
+
+    // Prefetches the table entry of the abstract state with the given index.
+    void prefetch_value(int index) const {
+#if defined(__GNUC__) || defined(__clang__)
+        if (has_compressed_distances()) {
+            packed_distances.prefetch(index);
+        } else {
+            __builtin_prefetch(&distances[index]);
+        }
+#else
+        (void)index;
+#endif
+    }
+
+    const std::vector<int> &get_hash_multipliers() const {
+        return hash_multipliers;
+    }
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
     }
 
+    /*
+      Store the distances with as few bits per entry as possible (see
+      PackedDistanceTable). The h values do not change. Nothing happens if
+      the distances are too large to be packed.
+    */
+    void compress_distances();
+
+    bool has_compressed_distances() const {
+        return !packed_distances.empty();
+    }
+
     // Returns the size (number of abstract states) of the PDB
     int get_size() const {
         return num_states;
     }
 
+    // Number of bits used to store each distance (32 if not compressed).
+    int get_bits_per_distance() const {
+        return has_compressed_distances() ?
+               packed_distances.get_bits_per_entry() : 32;
+    }
+
+    /*
+      Size of the distance table in 32-bit words. Without compression this
+      equals get_size().
+    */
+    int get_distance_table_size() const {
+        return has_compressed_distances() ?
+               2 * packed_distances.get_num_words() : num_states;
+    }
+
     std::vector<std::vector<OperatorID>> && extract_wildcard_plan() {
         return std::move(wildcard_plan);
     };
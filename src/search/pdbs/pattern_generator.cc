@@ -4,11 +4,17 @@
 
 #include "../plugin.h"
 
+#include <limits>
+
 using namespace std;
 
 namespace pdbs {
 PatternCollectionGenerator::PatternCollectionGenerator(const options::Options &opts)
-    : log(utils::get_log_from_options(opts)) {
+    : log(utils::get_log_from_options(opts)),
+      num_threads(opts.get<int>("num_threads", 1)),
+      max_parallel_states(
+          opts.get<int>("max_parallel_states", numeric_limits<int>::max())),
+      compress_pdbs(opts.get<bool>("compress_pdbs", false)) {
 }
 
 PatternCollectionInformation PatternCollectionGenerator::generate(
@@ -18,6 +24,8 @@ PatternCollectionInformation PatternCollectionGenerator::generate(
     }
     utils::Timer timer;
     PatternCollectionInformation pci = compute_patterns(task);
+    pci.set_pdb_construction_options(
+        num_threads, max_parallel_states, compress_pdbs);
     dump_pattern_collection_generation_statistics(
         name(), timer(), pci, log);
     return pci;
@@ -46,6 +54,39 @@ void add_generator_options_to_parser(options::OptionParser &parser) {
     utils::add_log_options_to_parser(parser);
 }
 
+void add_pdb_construction_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for building the PDBs of the pattern collection. "
+        "Independent PDBs are built concurrently; the result does not depend "
+        "on the number of threads.",
+        "1",
+        options::Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_parallel_states",
+        "maximum total number of abstract states of the PDBs that are built "
+        "at the same time. This bounds the memory used by concurrent PDB "
+        "construction. A PDB that is larger than this budget is built while "
+        "no other PDB is under construction.",
+        "infinity",
+        options::Bounds("1", "infinity"));
+    parser.add_option<bool>(
+        "compress_pdbs",
+        "store the distances of the PDBs with the smallest number of bits "
+        "(1, 2, 4, 8 or 16) that fits the largest finite distance of each "
+        "PDB instead of 32 bits. This reduces the memory of PDBs with small "
+        "distances, e.g., in unit-cost tasks, at a small lookup cost. "
+        "Hill climbing also compresses the PDBs it builds during the search "
+        "and measures its collection size limit by the packed distance "
+        "tables. All other size limits count abstract states, since PDBs "
+        "are built uncompressed before they are packed.",
+        "false");
+}
+
+void add_collection_generator_options_to_parser(options::OptionParser &parser) {
+    add_generator_options_to_parser(parser);
+}
+
 static PluginTypePlugin<PatternCollectionGenerator> _type_plugin_collection(
     "PatternCollectionGenerator",
     "Factory for pattern collections");
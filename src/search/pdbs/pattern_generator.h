@@ -28,6 +28,14 @@ class PatternCollectionGenerator {
         const std::shared_ptr<AbstractTask> &task) = 0;
 protected:
     mutable utils::LogProxy log;
+    /*
+      Parallelism and memory budget for building the PDBs of the collection.
+      Only used if the generator does not build the PDBs itself, see
+      add_pdb_construction_options_to_parser.
+    */
+    const int num_threads;
+    const int max_parallel_states;
+    const bool compress_pdbs;
 public:
     explicit PatternCollectionGenerator(const options::Options &opts);
     virtual ~PatternCollectionGenerator() = default;
@@ -50,6 +58,15 @@ public:
 };
 
 extern void add_generator_options_to_parser(options::OptionParser &parser);
+/*
+  Options for building the PDBs of the generated collection. Only add them
+  to generators that return patterns without PDBs, since generators that
+  build their PDBs themselves (e.g., CEGAR-based ones) ignore them.
+*/
+extern void add_pdb_construction_options_to_parser(
+    options::OptionParser &parser);
+extern void add_collection_generator_options_to_parser(
+    options::OptionParser &parser);
 }
 
 #endif
@@ -12,9 +12,12 @@
 #include "../utils/logging.h"
 #include "../utils/markup.h"
 #include "../utils/math.h"
+#include "../utils/parallel.h"
 #include "../utils/rng.h"
 
+#include <condition_variable>
 #include <limits>
+#include <mutex>
 
 using namespace std;
 
@@ -44,6 +47,43 @@ int compute_total_pdb_size(
     return size;
 }
 
+shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int num_threads, int max_parallel_states, bool compress) {
+    int num_patterns = patterns.size();
+    vector<int> pdb_sizes;
+    pdb_sizes.reserve(num_patterns);
+    for (const Pattern &pattern : patterns) {
+        pdb_sizes.push_back(compute_pdb_size(task_proxy, pattern));
+    }
+
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>(num_patterns);
+    mutex budget_mutex;
+    condition_variable budget_released;
+    int states_under_construction = 0;
+    utils::run_in_parallel(num_patterns, num_threads, [&](int i) {
+            int size = pdb_sizes[i];
+            {
+                unique_lock<mutex> lock(budget_mutex);
+                budget_released.wait(lock, [&]() {
+                        return states_under_construction == 0 ||
+                        size <= max_parallel_states - states_under_construction;
+                    });
+                states_under_construction += size;
+            }
+            (*pdbs)[i] = make_shared<PatternDatabase>(task_proxy, patterns[i]);
+            if (compress) {
+                (*pdbs)[i]->compress_distances();
+            }
+            {
+                lock_guard<mutex> lock(budget_mutex);
+                states_under_construction -= size;
+            }
+            budget_released.notify_all();
+        });
+    return pdbs;
+}
+
 vector<FactPair> get_goals_in_random_order(
     const TaskProxy &task_proxy, utils::RandomNumberGenerator &rng) {
     vector<FactPair> goals = task_properties::get_fact_pairs(task_proxy.get_goals());
@@ -23,6 +23,18 @@ extern int compute_pdb_size(const TaskProxy &task_proxy, const Pattern &pattern)
 extern int compute_total_pdb_size(
     const TaskProxy &task_proxy, const PatternCollection &pattern_collection);
 
+/*
+  Compute the PDBs for the given patterns (in the same order) on up to
+  num_threads threads. The PDBs that are under construction at the same
+  time have at most max_parallel_states abstract states in total, unless a
+  single PDB is larger, in which case it is built on its own. If
+  compress is true, the distances of the PDBs are stored in packed form
+  (see PatternDatabase::compress_distances).
+*/
+extern std::shared_ptr<PDBCollection> compute_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    int num_threads, int max_parallel_states, bool compress = false);
+
 extern std::vector<FactPair> get_goals_in_random_order(
     const TaskProxy &task_proxy, utils::RandomNumberGenerator &rng);
 extern std::vector<int> get_non_goal_variables(const TaskProxy &task_proxy);
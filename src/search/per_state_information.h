@@ -118,7 +118,7 @@ public:
             utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
         }
         segmented_vector::SegmentedVector<Entry> *entries = get_entries(registry);
-        int state_id = state.get_id().value;
+        StateIDValue state_id = state.get_id().value;
         assert(state.get_id() != StateID::no_state);
         size_t virtual_size = registry->size();
         assert(utils::in_bounds(state_id, *registry));
@@ -139,10 +139,10 @@ public:
         if (!entries) {
             return default_value;
         }
-        int state_id = state.get_id().value;
+        StateIDValue state_id = state.get_id().value;
         assert(state.get_id() != StateID::no_state);
         assert(utils::in_bounds(state_id, *registry));
-        int num_entries = entries->size();
+        StateIDValue num_entries = entries->size();
         if (state_id >= num_entries) {
             return default_value;
         }
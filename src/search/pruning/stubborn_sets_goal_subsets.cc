@@ -0,0 +1,100 @@
+#include "stubborn_sets_goal_subsets.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/task_properties.h"
+
+#include "../utils/collections.h"
+
+using namespace std;
+
+namespace stubborn_sets_goal_subsets {
+StubbornSetsGoalSubsets::StubbornSetsGoalSubsets(const options::Options &opts)
+    : StubbornSetsSimple(opts),
+      msgs_pruning(opts.get<shared_ptr<PruningMethod>>("msgs_pruning")) {
+}
+
+void StubbornSetsGoalSubsets::initialize(const shared_ptr<AbstractTask> &task) {
+    StubbornSetsSimple::initialize(task);
+    TaskProxy task_proxy(*task);
+    // Without hard goals, all goals are soft goals (see MSGSCollection).
+    if (task_proxy.get_hard_goals().empty()) {
+        sorted_goal_facts = task_properties::get_fact_pairs(task_proxy.get_goals());
+    } else {
+        sorted_goal_facts = task_properties::get_fact_pairs(task_proxy.get_hard_goals());
+        for (FactProxy goal : task_proxy.get_soft_goals()) {
+            sorted_goal_facts.push_back(goal.get_pair());
+        }
+    }
+    utils::sort_unique(sorted_goal_facts);
+    log << "pruning method: stubborn sets preserving goal subsets" << endl;
+    msgs_pruning->initialize(task);
+}
+
+void StubbornSetsGoalSubsets::initialize_stubborn_set(const State &state) {
+    // Add a necessary enabling set for each unsatisfied goal fact.
+    for (const FactPair &goal : sorted_goal_facts) {
+        if (state[goal.var].get_value() != goal.value) {
+            add_necessary_enabling_set(goal);
+        }
+    }
+}
+
+bool StubbornSetsGoalSubsets::prune(const State &state, int remaining_cost) {
+    return msgs_pruning->prune_state(state, remaining_cost);
+}
+
+StateID StubbornSetsGoalSubsets::get_cardinally_best_state() {
+    return msgs_pruning->get_cardinally_best_state();
+}
+
+int StubbornSetsGoalSubsets::get_max_solved_soft_goals() {
+    return msgs_pruning->get_max_solved_soft_goals();
+}
+
+void StubbornSetsGoalSubsets::print_statistics() const {
+    StubbornSetsSimple::print_statistics();
+    msgs_pruning->print_statistics();
+}
+
+void StubbornSetsGoalSubsets::set_abstract_task(shared_ptr<AbstractTask> task) {
+    StubbornSetsSimple::set_abstract_task(task);
+    msgs_pruning->set_abstract_task(task);
+}
+
+MSGSCollection StubbornSetsGoalSubsets::get_msgs() const {
+    return msgs_pruning->get_msgs();
+}
+
+void StubbornSetsGoalSubsets::init_msgs(MSGSCollection collection) {
+    msgs_pruning->init_msgs(collection);
+}
+
+static shared_ptr<PruningMethod> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Stubborn sets preserving goal subsets",
+        "Variant of 'StubbornSetsSimple' for the computation of the maximal "
+        "solvable goal subsets (MSGS). The stubborn set of a state contains "
+        "the achievers of all hard and soft goal facts that are not satisfied "
+        "in the state, so every subset of goals that is reachable within the "
+        "cost bound remains reachable, with the same cost, in the pruned state "
+        "space. States are pruned by the given MSGS pruning method, which also "
+        "collects the MSGS.");
+    parser.add_option<shared_ptr<PruningMethod>>(
+        "msgs_pruning",
+        "pruning method that prunes states and collects the MSGS "
+        "(e.g., rgssp or rgsst)",
+        "null()");
+    add_pruning_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run()) {
+        return nullptr;
+    }
+
+    return make_shared<StubbornSetsGoalSubsets>(opts);
+}
+
+static Plugin<PruningMethod> _plugin("stubborn_sets_goal_subsets", _parse);
+}
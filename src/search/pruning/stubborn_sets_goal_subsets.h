@@ -0,0 +1,48 @@
+#ifndef PRUNING_STUBBORN_SETS_GOAL_SUBSETS_H
+#define PRUNING_STUBBORN_SETS_GOAL_SUBSETS_H
+
+#include "stubborn_sets_simple.h"
+
+namespace stubborn_sets_goal_subsets {
+/*
+  Strong stubborn sets that preserve all reachable goal subsets instead of
+  only the plans for the conjunctive goal.
+
+  Every state whose goal subset is not satisfied in the current state s
+  violates at least one goal fact that is false in s. Seeding the stubborn
+  set with the achievers of *all* hard and soft goal facts that are false in
+  s therefore yields a disjunctive action landmark for every such subset at
+  once, and the usual closure (necessary enabling sets for inapplicable
+  operators, interfering operators for applicable ones) makes the set
+  stubborn for each of them. For every plan to a goal subset there is a
+  permutation of the same cost that starts with a stubborn operator, so
+  every goal subset that is reachable within the cost bound stays reachable.
+  The subsets satisfied in s itself are recorded when s is expanded.
+
+  Since a search engine only has one pruning method, operator pruning is
+  combined with a state pruning method for MSGS search (e.g., rgssp), to
+  which the pruning of states and the access to the MSGS are forwarded.
+*/
+class StubbornSetsGoalSubsets : public stubborn_sets_simple::StubbornSetsSimple {
+    std::shared_ptr<PruningMethod> msgs_pruning;
+    // Sorted hard and soft goal facts.
+    std::vector<FactPair> sorted_goal_facts;
+
+    virtual bool prune(const State &state, int remaining_cost) override;
+protected:
+    virtual void initialize_stubborn_set(const State &state) override;
+public:
+    explicit StubbornSetsGoalSubsets(const options::Options &opts);
+    virtual void initialize(const std::shared_ptr<AbstractTask> &task) override;
+    virtual StateID get_cardinally_best_state() override;
+    virtual int get_max_solved_soft_goals() override;
+    virtual void print_statistics() const override;
+
+    virtual void set_abstract_task(std::shared_ptr<AbstractTask> task) override;
+
+    virtual MSGSCollection get_msgs() const override;
+    virtual void init_msgs(MSGSCollection collection) override;
+};
+}
+
+#endif
@@ -12,7 +12,6 @@ class StubbornSetsSimple : public stubborn_sets::StubbornSetsActionCentric {
     std::vector<std::vector<int>> interference_relation;
     std::vector<bool> interference_relation_computed;
 
-    void add_necessary_enabling_set(const FactPair &fact);
     void add_interfering(int op_no);
 
     inline bool interfere(int op1_no, int op2_no) {
@@ -22,6 +21,7 @@ class StubbornSetsSimple : public stubborn_sets::StubbornSetsActionCentric {
     }
     const std::vector<int> &get_interfering_operators(int op1_no);
 protected:
+    void add_necessary_enabling_set(const FactPair &fact);
     virtual void initialize_stubborn_set(const State &state) override;
     virtual void handle_stubborn_operator(const State &state,
                                           int op_no) override;
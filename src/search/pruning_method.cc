@@ -14,6 +14,8 @@ using namespace std;
 PruningMethod::PruningMethod(const options::Options &opts)
     : timer_ops(false),
       timer_states(false),
+      telemetry_ops("pruning operators " + opts.get_unparsed_config()),
+      telemetry_states("pruning states " + opts.get_unparsed_config()),
       log(utils::get_log_from_options(opts)),
       task(nullptr) {
 }
@@ -38,7 +40,10 @@ void PruningMethod::prune_operators(
         timer_ops.resume();
     }
     int num_ops_before_pruning = op_ids.size();
-    prune(state, op_ids);
+    {
+        utils::TelemetryTimer timer(telemetry_ops);
+        prune(state, op_ids);
+    }
     num_successors_before_pruning += num_ops_before_pruning;
     num_successors_after_pruning += op_ids.size();
     if (log.is_at_least_verbose()) {
@@ -56,7 +61,11 @@ bool PruningMethod::prune_state(const State &state, int remaining_cost){
     if (log.is_at_least_verbose()) {
         timer_states.resume();
     }
-    bool can_be_pruned = prune(state, remaining_cost);
+    bool can_be_pruned;
+    {
+        utils::TelemetryTimer timer(telemetry_states);
+        can_be_pruned = prune(state, remaining_cost);
+    }
     num_tested_states++;
     num_pruned_states = can_be_pruned ? num_pruned_states + 1 : num_pruned_states;
     if (log.is_at_least_verbose()) {
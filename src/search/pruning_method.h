@@ -5,6 +5,7 @@
 #include "state_id.h"
 
 #include "../utils/logging.h"
+#include "../utils/telemetry.h"
 #include "../utils/timer.h"
 
 #include "xaip/explicit_mugs_search/msgs_collection.h"
@@ -27,6 +28,8 @@ class Options;
 class PruningMethod {
     utils::Timer timer_ops;
     utils::Timer timer_states;
+    utils::TelemetryHandle telemetry_ops;
+    utils::TelemetryHandle telemetry_states;
     friend class limited_pruning::LimitedPruning;
 
     virtual void prune(
@@ -12,6 +12,7 @@
 #include "utils/countdown_timer.h"
 #include "utils/rng_options.h"
 #include "utils/system.h"
+#include "utils/telemetry.h"
 #include "utils/timer.h"
 
 #include <cassert>
@@ -24,12 +25,16 @@ using utils::ExitCode;
 class PruningMethod;
 
 successor_generator::SuccessorGenerator &get_successor_generator(
-    const TaskProxy &task_proxy, utils::LogProxy &log) {
+    const TaskProxy &task_proxy,
+    successor_generator::SuccessorGeneratorType type,
+    utils::LogProxy &log) {
     if (log.is_at_least_normal())
         log << "Building successor generator..." << flush;
     int peak_memory_before = utils::get_peak_memory_in_kb();
     utils::Timer successor_generator_timer;
     successor_generator::SuccessorGenerator &successor_generator =
+        (type == successor_generator::SuccessorGeneratorType::FLAT) ?
+        successor_generator::g_flat_successor_generators[task_proxy] :
         successor_generator::g_successor_generators[task_proxy];
     successor_generator_timer.stop();
     if (log.is_at_least_normal()){
@@ -50,8 +55,12 @@ SearchEngine::SearchEngine(const Options &opts)
       task(tasks::g_root_task),
       task_proxy(*task),
       log(utils::get_log_from_options(opts)),
-      state_registry(task_proxy),
-      successor_generator(get_successor_generator(task_proxy, log)),
+      state_registry(task_proxy, opts.get<bool>("compress_states")),
+      successor_generator(get_successor_generator(
+                              task_proxy,
+                              opts.get<successor_generator::SuccessorGeneratorType>(
+                                  "successor_generator"),
+                              log)),
       search_space(state_registry, log),
       statistics(log),
       cost_type(opts.get<OperatorCost>("cost_type")),
@@ -63,6 +72,11 @@ SearchEngine::SearchEngine(const Options &opts)
         utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
     }
     bound = opts.get<int>("bound");
+    string telemetry_file = opts.get<string>("telemetry_file");
+    if (telemetry_file != "none") {
+        utils::g_telemetry.enable(
+            telemetry_file, opts.get<double>("telemetry_interval"));
+    }
     if (log.is_at_least_normal())
         task_properties::print_variable_statistics(task_proxy);
 }
@@ -93,17 +107,37 @@ void SearchEngine::search() {
     utils::CountdownTimer timer(max_time);
     while (status == IN_PROGRESS) {
         status = step();
+        if (utils::g_telemetry.is_enabled() &&
+            utils::g_telemetry.is_sample_due()) {
+            write_telemetry_sample();
+        }
         if (timer.is_expired()) {
             log << "Time limit reached. Abort search." << endl;
             status = TIMEOUT;
             break;
         }
     }
+    if (utils::g_telemetry.is_enabled())
+        write_telemetry_sample();
     // TODO: Revise when and which search times are logged.
     if (log.is_at_least_normal())
         log << "Actual search time: " << timer.get_elapsed_time() << endl;
 }
 
+void SearchEngine::write_telemetry_sample() const {
+    utils::g_telemetry.write_sample({
+            {"expanded", statistics.get_expanded()},
+            {"evaluated_states", statistics.get_evaluated_states()},
+            {"evaluations", statistics.get_evaluations()},
+            {"generated", statistics.get_generated()},
+            {"reopened", statistics.get_reopened()},
+            {"dead_ends", statistics.get_dead_ends()},
+            {"generated_ops", statistics.get_generated_ops()},
+            {"registered_states",
+             static_cast<int64_t>(state_registry.size())}
+        });
+}
+
 bool SearchEngine::check_goal_and_set_plan(const State &state) {
     if (task_properties::is_goal_state(task_proxy, state)) {
         if (log.is_at_least_normal())
@@ -170,6 +204,39 @@ void SearchEngine::add_options_to_parser(OptionParser &parser) {
         "if task is not solvable, output plan to state with the most solved goal facts",
         "false"
     );
+    parser.add_option<bool>(
+        "compress_states",
+        "store registered states as deltas to their parent states with "
+        "periodic full copies. This needs much less memory for tasks with "
+        "large states at the cost of slower state lookups",
+        "false");
+    vector<string> successor_generator_types;
+    vector<string> successor_generator_types_doc;
+    successor_generator_types.push_back("TREE");
+    successor_generator_types_doc.push_back(
+        "tree of generator nodes evaluated on unpacked states");
+    successor_generator_types.push_back("FLAT");
+    successor_generator_types_doc.push_back(
+        "generator compiled into a flat array that is evaluated iteratively "
+        "on packed states");
+    parser.add_enum_option<successor_generator::SuccessorGeneratorType>(
+        "successor_generator",
+        successor_generator_types,
+        "successor generator implementation",
+        "TREE",
+        successor_generator_types_doc);
+    parser.add_option<string>(
+        "telemetry_file",
+        "write samples of the search counters, the time spent in the "
+        "successor generator, evaluators, pruning methods and other "
+        "instrumented components, and the peak memory usage to this file "
+        "(one JSON object per line). Use 'none' to disable telemetry",
+        "none");
+    parser.add_option<double>(
+        "telemetry_interval",
+        "minimum time in seconds between two telemetry samples",
+        "1.0",
+        Bounds("0.0", "infinity"));
     utils::add_log_options_to_parser(parser);
 }
 
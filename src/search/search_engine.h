@@ -61,6 +61,7 @@ protected:
     bool check_goal(const State &state);
     void set_osp_plan(const State &state);
     int get_adjusted_cost(const OperatorProxy &op) const;
+    void write_telemetry_sample() const;
 public:
     SearchEngine(const options::Options &opts);
     virtual ~SearchEngine();
@@ -29,7 +29,10 @@ EagerSearch::EagerSearch(const Options &opts)
       preferred_operator_evaluators(opts.get_list<shared_ptr<Evaluator>>("preferred")),
       lazy_evaluator(opts.get<shared_ptr<Evaluator>>("lazy_evaluator", nullptr)),
       eval(opts.get<shared_ptr<Evaluator>>("eval", nullptr)),
-      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      evaluation_pipeline(opts, log),
+      dead_end_stage(evaluation_pipeline.add_stage("dead_end")),
+      pruning_stage(evaluation_pipeline.add_stage("pruning")) {
     if (lazy_evaluator && !lazy_evaluator->does_cache_estimates()) {
         cerr << "lazy_evaluator must cache its estimates" << endl;
         utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
@@ -110,6 +113,7 @@ void EagerSearch::print_statistics() const {
     statistics.print_detailed_statistics();
     search_space.print_statistics();
     pruning_method->print_statistics();
+    evaluation_pipeline.print_statistics(log);
     eval->print_statistics();
 }
 
@@ -206,11 +210,20 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
+    vector<OperatorID> succ_ops;
+    succ_ops.reserve(applicable_ops.size());
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
-        if ((node->get_real_g() + op.get_cost()) >= bound)
-            continue;
-        State succ_state = state_registry.get_successor_state(s, op);
+        if ((node->get_real_g() + op.get_cost()) < bound)
+            succ_ops.push_back(op_id);
+    }
+    vector<State> succ_states;
+    state_registry.get_successor_states(s, succ_ops, succ_states);
+
+    for (size_t i = 0; i < succ_ops.size(); ++i) {
+        OperatorID op_id = succ_ops[i];
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        const State &succ_state = succ_states[i];
         statistics.inc_generated();
         bool is_preferred = preferred_operators.contains(op_id);
 
@@ -237,12 +250,17 @@ SearchStatus EagerSearch::step() {
                 succ_state, succ_g, is_preferred, &statistics);
             statistics.inc_evaluated_states();
 
-            if (open_list->is_dead_end(succ_eval_context)) {
+            int remaining_cost = bound - (node->get_real_g() + op.get_cost());
+            int rejecting_stage = evaluation_pipeline.run([&](int stage) -> bool {
+                    if (stage == dead_end_stage)
+                        return open_list->is_dead_end(succ_eval_context);
+                    return pruning_method->prune_state(succ_state, remaining_cost);
+                });
+            if (rejecting_stage == dead_end_stage) {
                 succ_node.mark_as_dead_end();
                 statistics.inc_dead_ends();
                 continue;
-            }
-            if (pruning_method->prune_state(succ_state, bound - (node->get_real_g() + op.get_cost()))){
+            } else if (rejecting_stage == pruning_stage) {
                 continue;
             }
             succ_node.open(*node, op, get_adjusted_cost(op));
@@ -328,6 +346,7 @@ void EagerSearch::update_f_value_statistics(EvaluationContext &eval_context) {
 
 void add_options_to_parser(OptionParser &parser) {
     SearchEngine::add_pruning_option(parser);
+    add_evaluation_pipeline_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
 }
 }
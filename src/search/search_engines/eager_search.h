@@ -1,6 +1,7 @@
 #ifndef SEARCH_ENGINES_EAGER_SEARCH_H
 #define SEARCH_ENGINES_EAGER_SEARCH_H
 
+#include "../evaluation_pipeline.h"
 #include "../open_list.h"
 #include "../search_engine.h"
 
@@ -29,6 +30,10 @@ class EagerSearch : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    EvaluationPipeline evaluation_pipeline;
+    const int dead_end_stage;
+    const int pruning_stage;
+
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(EvaluationContext &eval_context);
     void reward_progress();
@@ -0,0 +1,438 @@
+#include "hda_search.h"
+
+#include "../evaluation_context.h"
+#include "../evaluator.h"
+#include "../open_list_factory.h"
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../algorithms/int_packer.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/countdown_timer.h"
+#include "../utils/hash.h"
+#include "../utils/logging.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
+#include "../utils/telemetry.h"
+
+#include <algorithm>
+#include <cassert>
+#include <set>
+#include <thread>
+
+using namespace std;
+
+namespace hda_search {
+MessageQueue::MessageQueue()
+    : head(nullptr) {
+}
+
+MessageQueue::~MessageQueue() {
+    Message *message = head.load();
+    while (message) {
+        Message *next = message->next;
+        delete message;
+        message = next;
+    }
+}
+
+void MessageQueue::push(Message *message) {
+    message->next = head.load(memory_order_relaxed);
+    while (!head.compare_exchange_weak(
+               message->next, message,
+               memory_order_release, memory_order_relaxed)) {
+    }
+}
+
+Message *MessageQueue::pop_all() {
+    Message *stack = head.exchange(nullptr, memory_order_acquire);
+    // Reverse the stack to get the messages in the order they were pushed.
+    Message *queue = nullptr;
+    while (stack) {
+        Message *next = stack->next;
+        stack->next = queue;
+        queue = stack;
+        stack = next;
+    }
+    return queue;
+}
+
+
+HDAWorker::HDAWorker(
+    HDASearch &engine, int id, unique_ptr<StateOpenList> open_list,
+    const shared_ptr<Evaluator> &bound_evaluator,
+    successor_generator::SuccessorGeneratorType successor_generator_type)
+    : engine(engine),
+      id(id),
+      state_registry(engine.task_proxy),
+      successor_generator(
+          utils::make_unique_ptr<successor_generator::SuccessorGenerator>(
+              engine.task_proxy, successor_generator_type)),
+      open_list(move(open_list)),
+      bound_evaluator(bound_evaluator),
+      log(engine.log),
+      statistics(log) {
+}
+
+bool HDAWorker::receive(
+    const PackedStateBin *data, int g, int real_g, int parent_worker,
+    StateID parent_id, OperatorID creating_operator) {
+    State state = state_registry.register_state_data(data);
+    HDANodeInfo &info = node_infos[state];
+    if (info.dead_end || (!info.is_new() && info.g <= g)) {
+        return false;
+    }
+    bool is_new = info.is_new();
+    if (!is_new && info.closed) {
+        statistics.inc_reopened();
+    }
+    info.g = g;
+    info.real_g = real_g;
+    info.closed = false;
+    info.parent_worker = parent_worker;
+    info.parent_id = parent_id;
+    info.creating_operator = creating_operator;
+
+    EvaluationContext eval_context(state, g, false, &statistics);
+    if (is_new) {
+        statistics.inc_evaluated_states();
+        if (bound_evaluator) {
+            info.h = eval_context.get_evaluator_value_or_infinity(
+                bound_evaluator.get());
+        }
+        if (info.h == EvaluationResult::INFTY ||
+            open_list->is_dead_end(eval_context)) {
+            info.dead_end = true;
+            statistics.inc_dead_ends();
+            return false;
+        }
+    }
+    if (exceeds_bound(info)) {
+        return false;
+    }
+    open_list->insert(eval_context, state.get_id());
+    return true;
+}
+
+bool HDAWorker::exceeds_bound(const HDANodeInfo &info) const {
+    return info.real_g + info.h >=
+           engine.current_bound.load(memory_order_relaxed);
+}
+
+void HDAWorker::send(Message *message) {
+    inbox.push(message);
+}
+
+void HDAWorker::process_inbox() {
+    Message *message = inbox.pop_all();
+    while (message) {
+        if (!receive(message->data.data(), message->g, message->real_g,
+                     message->parent_worker, message->parent_id,
+                     message->creating_operator)) {
+            // The message does not turn into an open list entry.
+            --engine.num_pending_work;
+        }
+        Message *next = message->next;
+        delete message;
+        message = next;
+    }
+}
+
+void HDAWorker::expand(const State &state, HDANodeInfo &info) {
+    vector<OperatorID> applicable_ops;
+    successor_generator->generate_applicable_ops(state, applicable_ops);
+
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    int num_bins = state_packer.get_num_bins();
+    const PackedStateBin *buffer = state.get_buffer();
+    int g = info.g;
+    int real_g = info.real_g;
+    int bound = engine.current_bound.load(memory_order_relaxed);
+    OperatorsProxy operators = engine.task_proxy.get_operators();
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = operators[op_id];
+        int succ_real_g = real_g + op.get_cost();
+        if (succ_real_g >= bound)
+            continue;
+        statistics.inc_generated();
+
+        successor_buffer.assign(buffer, buffer + num_bins);
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, state)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(successor_buffer.data(), effect_pair.var, effect_pair.value);
+            }
+        }
+        int succ_g = g + engine.get_adjusted_cost(op);
+
+        int owner = engine.get_owner(successor_buffer.data());
+        if (owner == id) {
+            if (receive(successor_buffer.data(), succ_g, succ_real_g,
+                        id, state.get_id(), op_id)) {
+                ++engine.num_pending_work;
+            }
+        } else {
+            Message *message = new Message();
+            message->data = successor_buffer;
+            message->g = succ_g;
+            message->real_g = succ_real_g;
+            message->parent_worker = id;
+            message->parent_id = state.get_id();
+            message->creating_operator = op_id;
+            // Count the message before it can be processed.
+            ++engine.num_pending_work;
+            engine.workers[owner]->send(message);
+        }
+    }
+}
+
+void HDAWorker::run() {
+    utils::CountdownTimer timer(engine.max_time);
+    while (!engine.stop.load(memory_order_relaxed)) {
+        process_inbox();
+        if (open_list->empty()) {
+            if (engine.num_pending_work.load() == 0) {
+                break;
+            }
+            this_thread::yield();
+            continue;
+        }
+        if (timer.is_expired()) {
+            engine.timed_out = true;
+            engine.stop = true;
+            break;
+        }
+
+        StateID state_id = open_list->remove_min();
+        State state = state_registry.lookup_state(state_id);
+        HDANodeInfo &info = node_infos[state];
+        /*
+          The bound may have decreased since the node was opened. Discarding
+          such nodes without expanding them lets the search finish as soon
+          as all open lists only contain nodes with g + h >= bound.
+        */
+        if (!info.closed && !exceeds_bound(info)) {
+            info.closed = true;
+            statistics.inc_expanded();
+            if (task_properties::is_goal_state(engine.task_proxy, state)) {
+                engine.report_solution(id, state_id, info.real_g);
+            } else {
+                expand(state, info);
+            }
+        }
+        // Decrement only after all successors have been counted.
+        --engine.num_pending_work;
+    }
+}
+
+const HDANodeInfo &HDAWorker::get_node_info(StateID state_id) {
+    return node_infos[state_registry.lookup_state(state_id)];
+}
+
+
+HDASearch::HDASearch(
+    const Options &opts, options::Registry &registry,
+    const options::Predefinitions &predefinitions)
+    : SearchEngine(opts),
+      num_threads(opts.get<int>("num_threads")),
+      optimal(opts.get<bool>("optimal")),
+      num_pending_work(0),
+      stop(false),
+      timed_out(false),
+      current_bound(bound),
+      solution_worker(-1),
+      solution_state_id(StateID::no_state) {
+    if (task_properties::has_axioms(task_proxy)) {
+        cerr << "error: hda does not support axioms" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    if (utils::g_telemetry.is_enabled()) {
+        cerr << "error: hda does not support telemetry" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    /*
+      Parse the open list once per worker so that each worker uses its own
+      evaluator objects. The parser and the evaluator constructors are not
+      thread-safe, so this has to happen before the threads are started.
+    */
+    ParseTree open_list_config = opts.get<ParseTree>("open");
+    auto successor_generator_type =
+        opts.get<successor_generator::SuccessorGeneratorType>("successor_generator");
+    for (int i = 0; i < num_threads; ++i) {
+        OptionParser parser(open_list_config, registry, predefinitions, false);
+        shared_ptr<OpenListFactory> factory =
+            parser.start_parsing<shared_ptr<OpenListFactory>>();
+        shared_ptr<Evaluator> bound_evaluator;
+        if (opts.contains("bound_eval")) {
+            OptionParser eval_parser(opts.get<ParseTree>("bound_eval"),
+                                     registry, predefinitions, false);
+            bound_evaluator = eval_parser.start_parsing<shared_ptr<Evaluator>>();
+        }
+        workers.push_back(utils::make_unique_ptr<HDAWorker>(
+                              *this, i, factory->create_state_open_list(),
+                              bound_evaluator, successor_generator_type));
+    }
+}
+
+HDASearch::~HDASearch() {
+}
+
+int HDASearch::get_owner(const PackedStateBin *data) const {
+    utils::HashState hash_state;
+    int num_bins = state_registry.get_state_packer().get_num_bins();
+    for (int i = 0; i < num_bins; ++i) {
+        hash_state.feed(data[i]);
+    }
+    return hash_state.get_hash64() % num_threads;
+}
+
+void HDASearch::report_solution(int worker, StateID state_id, int real_g) {
+    lock_guard<mutex> lock(solution_mutex);
+    if (real_g >= current_bound.load())
+        return;
+    solution_worker = worker;
+    solution_state_id = state_id;
+    if (optimal) {
+        // Continue as branch and bound search with the new bound.
+        current_bound = real_g;
+    } else {
+        stop = true;
+    }
+}
+
+void HDASearch::trace_plan() {
+    Plan plan;
+    int worker = solution_worker;
+    StateID state_id = solution_state_id;
+    while (true) {
+        const HDANodeInfo &info = workers[worker]->get_node_info(state_id);
+        if (info.creating_operator == OperatorID::no_operator) {
+            assert(info.parent_id == StateID::no_state);
+            break;
+        }
+        plan.push_back(info.creating_operator);
+        worker = info.parent_worker;
+        state_id = info.parent_id;
+    }
+    reverse(plan.begin(), plan.end());
+    set_plan(plan);
+}
+
+void HDASearch::initialize() {
+    log << "Conducting hash-distributed search with " << num_threads
+        << " threads" << (optimal ? " until optimality is proven" : "")
+        << ", (real) bound = " << bound << endl;
+    current_bound = bound;
+
+    const State &initial_state = state_registry.get_initial_state();
+    const PackedStateBin *data = initial_state.get_buffer();
+    int owner = get_owner(data);
+    if (workers[owner]->receive(data, 0, 0, -1, StateID::no_state,
+                                OperatorID::no_operator)) {
+        ++num_pending_work;
+    } else {
+        log << "Initial state is a dead end." << endl;
+    }
+}
+
+SearchStatus HDASearch::step() {
+    vector<thread> threads;
+    threads.reserve(num_threads);
+    for (const unique_ptr<HDAWorker> &worker : workers) {
+        threads.emplace_back(&HDAWorker::run, worker.get());
+    }
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+
+    for (const unique_ptr<HDAWorker> &worker : workers) {
+        const SearchStatistics &worker_statistics = worker->get_statistics();
+        statistics.inc_expanded(worker_statistics.get_expanded());
+        statistics.inc_evaluated_states(worker_statistics.get_evaluated_states());
+        statistics.inc_evaluations(worker_statistics.get_evaluations());
+        statistics.inc_generated(worker_statistics.get_generated());
+        statistics.inc_reopened(worker_statistics.get_reopened());
+    }
+
+    if (solution_worker != -1) {
+        log << "Solution found!" << endl;
+        trace_plan();
+        return SOLVED;
+    }
+    if (timed_out) {
+        return TIMEOUT;
+    }
+    log << "Completely explored state space -- no solution!" << endl;
+    return FAILED;
+}
+
+void HDASearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    for (const unique_ptr<HDAWorker> &worker : workers) {
+        log << "Worker expansions: " << worker->get_statistics().get_expanded() << endl;
+    }
+}
+
+static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Hash-distributed best-first search (HDA*)",
+        "Parallel best-first search in which each state is owned by one "
+        "thread, determined by the hash of the state. Each thread expands its "
+        "states in the order of its own open list and sends successors "
+        "to their owners through lock-free message queues.");
+    parser.document_note(
+        "Evaluators",
+        "The open list is created once per thread, so that every thread uses "
+        "its own evaluator objects. Do not use predefined evaluators in the "
+        "open list since they would be shared between threads. "
+        "Path-dependent evaluators, preferred operators, telemetry and tasks "
+        "with axioms are not supported.");
+    parser.document_note(
+        "Optimality",
+        "Without optimal=true, the search stops at the first plan with cost "
+        "below the bound, which need not be the cheapest one even with an "
+        "admissible heuristic because threads expand states independently. "
+        "With optimal=true, each plan becomes the new bound and the search "
+        "continues until all threads are idle and no messages are in "
+        "flight. Nodes with g + h >= bound are pruned when they are "
+        "generated and when they are removed from the open list, where h is "
+        "the value of bound_eval (0 without it), so the search finishes "
+        "once all open lists only contain such nodes.");
+    parser.add_option<ParseTree>("open", "open list (parsed once per thread)");
+    parser.add_option<ParseTree>(
+        "bound_eval",
+        "evaluator used to prune nodes with g + h >= bound (parsed once per "
+        "thread). It must be admissible for the real operator costs. Usually "
+        "this is the heuristic of the open list.",
+        OptionParser::NONE);
+    parser.add_option<int>(
+        "num_threads", "number of worker threads", "1", Bounds("1", "infinity"));
+    parser.add_option<bool>(
+        "optimal",
+        "continue the search until the cheapest plan is found",
+        "false");
+    SearchEngine::add_options_to_parser(parser);
+    Options opts = parser.parse();
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        // Check that the open list can be parsed.
+        OptionParser test_parser(opts.get<ParseTree>("open"), parser.get_registry(),
+                                 parser.get_predefinitions(), true);
+        test_parser.start_parsing<shared_ptr<OpenListFactory>>();
+        if (opts.contains("bound_eval")) {
+            OptionParser eval_parser(opts.get<ParseTree>("bound_eval"),
+                                     parser.get_registry(),
+                                     parser.get_predefinitions(), true);
+            eval_parser.start_parsing<shared_ptr<Evaluator>>();
+        }
+        return nullptr;
+    } else {
+        return make_shared<HDASearch>(
+            opts, parser.get_registry(), parser.get_predefinitions());
+    }
+}
+
+static Plugin<SearchEngine> _plugin("hda", _parse);
+}
@@ -0,0 +1,172 @@
+#ifndef SEARCH_ENGINES_HDA_SEARCH_H
+#define SEARCH_ENGINES_HDA_SEARCH_H
+
+#include "../open_list.h"
+#include "../option_parser_util.h"
+#include "../per_state_information.h"
+#include "../search_engine.h"
+
+#include "../task_utils/successor_generator.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace options {
+class Registry;
+class Predefinitions;
+}
+
+namespace hda_search {
+/*
+  A state (given by its packed data) that is sent to the worker owning it,
+  together with the g values and the parent of the path that reached it.
+*/
+struct Message {
+    Message *next;
+    std::vector<PackedStateBin> data;
+    int g;
+    int real_g;
+    int parent_worker;
+    StateID parent_id;
+    OperatorID creating_operator;
+
+    Message()
+        : next(nullptr), g(-1), real_g(-1), parent_worker(-1),
+          parent_id(StateID::no_state),
+          creating_operator(OperatorID::no_operator) {
+    }
+};
+
+/*
+  Lock-free queue with many producers and a single consumer. Producers push
+  onto a linked stack with compare-and-swap, the consumer takes the whole
+  stack at once and reverses it, so messages of each producer are received
+  in the order they were sent.
+*/
+class MessageQueue {
+    std::atomic<Message *> head;
+public:
+    MessageQueue();
+    ~MessageQueue();
+
+    void push(Message *message);
+    // Return all messages in the order they were pushed.
+    Message *pop_all();
+};
+
+struct HDANodeInfo {
+    int g = -1;
+    int real_g = -1;
+    // Value of the bound evaluator (0 without one).
+    int h = 0;
+    bool closed = false;
+    bool dead_end = false;
+    int parent_worker = -1;
+    StateID parent_id = StateID::no_state;
+    OperatorID creating_operator = OperatorID::no_operator;
+
+    bool is_new() const {
+        return g == -1;
+    }
+};
+
+class HDASearch;
+
+/*
+  A worker owns all states whose packed data hashes to its ID. It has its
+  own state registry, open list and bound evaluator (with their own
+  evaluator objects), node information and successor generator, so that
+  workers never access each other's data structures apart from the message
+  queues.
+*/
+class HDAWorker {
+    HDASearch &engine;
+    const int id;
+    StateRegistry state_registry;
+    std::unique_ptr<successor_generator::SuccessorGenerator> successor_generator;
+    std::unique_ptr<StateOpenList> open_list;
+    std::shared_ptr<Evaluator> bound_evaluator;
+    PerStateInformation<HDANodeInfo> node_infos;
+    MessageQueue inbox;
+    utils::LogProxy log;
+    SearchStatistics statistics;
+    std::vector<PackedStateBin> successor_buffer;
+
+    void process_inbox();
+    // Return true if no plan through the node can be cheaper than the bound.
+    bool exceeds_bound(const HDANodeInfo &info) const;
+    void expand(const State &state, HDANodeInfo &info);
+public:
+    HDAWorker(HDASearch &engine, int id,
+              std::unique_ptr<StateOpenList> open_list,
+              const std::shared_ptr<Evaluator> &bound_evaluator,
+              successor_generator::SuccessorGeneratorType successor_generator_type);
+
+    /*
+      Register the state with the given data and open it if it is new or
+      was reached more cheaply and g + h is below the current bound. Return
+      true if the state was inserted into the open list.
+    */
+    bool receive(const PackedStateBin *data, int g, int real_g,
+                 int parent_worker, StateID parent_id,
+                 OperatorID creating_operator);
+    void send(Message *message);
+    void run();
+
+    const HDANodeInfo &get_node_info(StateID state_id);
+    StateRegistry &get_state_registry() {
+        return state_registry;
+    }
+    const SearchStatistics &get_statistics() const {
+        return statistics;
+    }
+};
+
+/*
+  Hash-distributed A* (Kishimoto et al., 2009): each state is owned by a
+  worker thread determined by the hash of its packed data. Workers expand
+  their own states and send successors to their owners.
+*/
+class HDASearch : public SearchEngine {
+    friend class HDAWorker;
+
+    const int num_threads;
+    const bool optimal;
+    std::vector<std::unique_ptr<HDAWorker>> workers;
+
+    /*
+      Number of open list entries plus the number of messages that were
+      sent but not processed yet. The search space is exhausted when this
+      drops to zero: only existing work can create new work.
+    */
+    std::atomic<int64_t> num_pending_work;
+    std::atomic<bool> stop;
+    std::atomic<bool> timed_out;
+    // Nodes are pruned if real g + h is at least this value.
+    std::atomic<int> current_bound;
+
+    std::mutex solution_mutex;
+    int solution_worker;
+    StateID solution_state_id;
+
+    int get_owner(const PackedStateBin *data) const;
+    void report_solution(int worker, StateID state_id, int real_g);
+    void trace_plan();
+
+protected:
+    virtual void initialize() override;
+    virtual SearchStatus step() override;
+
+public:
+    HDASearch(const options::Options &opts, options::Registry &registry,
+              const options::Predefinitions &predefinitions);
+    virtual ~HDASearch() override;
+
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -98,6 +98,18 @@ void SearchNode::close() {
     info.status = SearchNodeInfo::CLOSED;
 }
 
+void SearchNode::restore_closed(int g, int real_g) {
+    if (info.status == SearchNodeInfo::NEW) {
+        info.status = SearchNodeInfo::CLOSED;
+        info.parent_state_id = StateID::no_state;
+        info.creating_operator = OperatorID::no_operator;
+    } else if (info.g <= g) {
+        return;
+    }
+    info.g = g;
+    info.real_g = real_g;
+}
+
 void SearchNode::mark_as_dead_end() {
     info.status = SearchNodeInfo::DEAD_END;
 }
@@ -42,6 +42,12 @@ public:
                        const OperatorProxy &parent_op,
                        int adjusted_cost);
     void close();
+    /*
+      Mark a node whose ancestors are no longer in the search space as
+      closed with the given g values, e.g. after the search space was
+      cleared. Keeps the smaller g if the node is already known.
+    */
+    void restore_closed(int g, int real_g);
     void mark_as_dead_end();
 
     void dump(const TaskProxy &task_proxy, utils::LogProxy &log) const;
@@ -1,11 +1,24 @@
 #ifndef STATE_ID_H
 #define STATE_ID_H
 
+#include <cstdint>
 #include <iostream>
 
 // For documentation on classes relevant to storing and working with registered
 // states see the file state_registry.h.
 
+/*
+  By default, state IDs are 32-bit integers, which limits the number of
+  registered states to 2^31 - 1. Configure with -DUSE_WIDE_STATE_IDS=TRUE to
+  use 64-bit state IDs (and hash set keys) for very large searches. This
+  increases the memory used per state.
+*/
+#ifdef USE_WIDE_STATE_IDS
+using StateIDValue = std::int64_t;
+#else
+using StateIDValue = int;
+#endif
+
 class StateID {
     friend class StateRegistry;
     friend std::ostream &operator<<(std::ostream &os, StateID id);
@@ -15,8 +28,8 @@ class StateID {
     friend class PerStateArray;
     friend class PerStateBitset;
 
-    int value;
-    explicit StateID(int value_)
+    StateIDValue value;
+    explicit StateID(StateIDValue value_)
         : value(value_) {
     }
 
@@ -5,18 +5,33 @@
 
 #include "task_utils/task_properties.h"
 #include "utils/logging.h"
+#include "utils/memory.h"
 
 using namespace std;
 
-StateRegistry::StateRegistry(const TaskProxy &task_proxy)
+/*
+  Maximum number of deltas that have to be applied to reconstruct a state
+  from compressed storage and number of decompressed states that are cached.
+*/
+static const int MAX_DELTA_CHAIN_LENGTH = 16;
+static const int DECOMPRESSION_CACHE_SIZE = 4096;
+
+StateRegistry::StateRegistry(const TaskProxy &task_proxy, bool compress_states)
     : task_proxy(task_proxy),
       state_packer(task_properties::g_state_packers[task_proxy]),
       axiom_evaluator(g_axiom_evaluators[task_proxy]),
       num_variables(task_proxy.get_variables().size()),
       state_data_pool(get_bins_per_state()),
+      compressed_storage(
+          compress_states ?
+          utils::make_unique_ptr<CompressedStateStorage>(
+              get_bins_per_state(), MAX_DELTA_CHAIN_LENGTH,
+              DECOMPRESSION_CACHE_SIZE) :
+          nullptr),
+      pending_state_data(nullptr),
       registered_states(
-          StateIDSemanticHash(state_data_pool, get_bins_per_state()),
-          StateIDSemanticEqual(state_data_pool, get_bins_per_state())) {
+          StateIDSemanticHash(*this, get_bins_per_state()),
+          StateIDSemanticEqual(*this, get_bins_per_state())) {
 }
 
 StateID StateRegistry::insert_id_or_pop_state() {
@@ -27,18 +42,78 @@ StateID StateRegistry::insert_id_or_pop_state() {
       state data pool.
     */
     StateID id(state_data_pool.size() - 1);
-    pair<int, bool> result = registered_states.insert(id.value);
+    pair<int_hash_set::KeyType, bool> result = registered_states.insert(id.value);
+    bool is_new_entry = result.second;
+    if (!is_new_entry) {
+        state_data_pool.pop_back();
+    }
+    assert(registered_states.size() ==
+           static_cast<int_hash_set::IndexType>(state_data_pool.size()));
+    return StateID(result.first);
+}
+
+StateID StateRegistry::insert_id_or_pop_state(int_hash_set::HashType hash) {
+    // Like insert_id_or_pop_state(), but with a precomputed hash.
+    StateID id(state_data_pool.size() - 1);
+    pair<int_hash_set::KeyType, bool> result = registered_states.insert_with_hash(id.value, hash);
     bool is_new_entry = result.second;
     if (!is_new_entry) {
         state_data_pool.pop_back();
     }
-    assert(registered_states.size() == static_cast<int>(state_data_pool.size()));
+    assert(registered_states.size() ==
+           static_cast<int_hash_set::IndexType>(state_data_pool.size()));
+    return StateID(result.first);
+}
+
+StateID StateRegistry::insert_compressed_state(
+    const PackedStateBin *data, int_hash_set::HashType hash, StateID parent_id) {
+    /*
+      Insert the ID the state would get into the hash set before storing
+      the state. Until it is stored, get_state_data() answers requests for
+      this ID with the given data.
+    */
+    assert(compressed_storage);
+    StateID id(compressed_storage->size());
+    pending_state_data = data;
+    pair<int_hash_set::KeyType, bool> result = registered_states.insert_with_hash(id.value, hash);
+    bool is_new_entry = result.second;
+    if (is_new_entry) {
+        compressed_storage->push_back(data, parent_id.value);
+    }
+    pending_state_data = nullptr;
+    assert(registered_states.size() ==
+           static_cast<int_hash_set::IndexType>(compressed_storage->size()));
     return StateID(result.first);
 }
 
+StateID StateRegistry::insert_state(
+    const PackedStateBin *data, int_hash_set::HashType hash, StateID parent_id) {
+    if (compressed_storage) {
+        return insert_compressed_state(data, hash, parent_id);
+    }
+    state_data_pool.push_back(data);
+    return insert_id_or_pop_state(hash);
+}
+
+State StateRegistry::create_registered_state(StateID id) const {
+    if (compressed_storage) {
+        return task_proxy.create_state(
+            *this, id, compressed_storage->lookup(id.value));
+    }
+    return task_proxy.create_state(*this, id, state_data_pool[id.value]);
+}
+
+State StateRegistry::create_registered_state(StateID id, vector<int> &&values) const {
+    if (compressed_storage) {
+        return task_proxy.create_state(
+            *this, id, compressed_storage->lookup(id.value), move(values));
+    }
+    return task_proxy.create_state(
+        *this, id, state_data_pool[id.value], move(values));
+}
+
 State StateRegistry::lookup_state(StateID id) const {
-    const PackedStateBin *buffer = state_data_pool[id.value];
-    return task_proxy.create_state(*this, id, buffer);
+    return create_registered_state(id);
 }
 
 const State &StateRegistry::get_initial_state() {
@@ -52,8 +127,9 @@ const State &StateRegistry::get_initial_state() {
         for (size_t i = 0; i < initial_state.size(); ++i) {
             state_packer.set(buffer.get(), i, initial_state[i].get_value());
         }
-        state_data_pool.push_back(buffer.get());
-        StateID id = insert_id_or_pop_state();
+        int_hash_set::HashType hash =
+            get_state_hash(get_bins_hash(buffer.get(), num_bins));
+        StateID id = insert_state(buffer.get(), hash, StateID::no_state);
         cached_initial_state = utils::make_unique_ptr<State>(lookup_state(id));
     }
     return *cached_initial_state;
@@ -64,6 +140,9 @@ const State &StateRegistry::get_initial_state() {
 //     operating on state buffers (PackedStateBin *).
 State StateRegistry::get_successor_state(const State &predecessor, const OperatorProxy &op) {
     assert(!op.is_axiom());
+    if (compressed_storage) {
+        return get_compressed_successor_state(predecessor, op);
+    }
     state_data_pool.push_back(predecessor.get_buffer());
     PackedStateBin *buffer = state_data_pool[state_data_pool.size() - 1];
     /* Experiments for issue348 showed that for tasks with axioms it's faster
@@ -95,6 +174,129 @@ State StateRegistry::get_successor_state(const State &predecessor, const Operato
     }
 }
 
+State StateRegistry::get_compressed_successor_state(
+    const State &predecessor, const OperatorProxy &op) {
+    // Build the successor in scratch space, it is copied on insertion.
+    int num_bins = get_bins_per_state();
+    const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+    successor_buffers.assign(predecessor_buffer, predecessor_buffer + num_bins);
+    PackedStateBin *buffer = successor_buffers.data();
+    if (task_properties::has_axioms(task_proxy)) {
+        predecessor.unpack();
+        vector<int> new_values = predecessor.get_unpacked_values();
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                new_values[effect_pair.var] = effect_pair.value;
+            }
+        }
+        axiom_evaluator.evaluate(new_values);
+        for (size_t i = 0; i < new_values.size(); ++i) {
+            state_packer.set(buffer, i, new_values[i]);
+        }
+        int_hash_set::HashType hash = get_state_hash(get_bins_hash(buffer, num_bins));
+        StateID id = insert_compressed_state(buffer, hash, predecessor.get_id());
+        return create_registered_state(id, move(new_values));
+    } else {
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+            }
+        }
+        int_hash_set::HashType hash = get_state_hash(get_bins_hash(buffer, num_bins));
+        StateID id = insert_compressed_state(buffer, hash, predecessor.get_id());
+        return create_registered_state(id);
+    }
+}
+
+void StateRegistry::get_successor_states(
+    const State &predecessor, const vector<OperatorID> &op_ids,
+    vector<State> &successors) {
+    successors.clear();
+    successors.reserve(op_ids.size());
+    OperatorsProxy operators = task_proxy.get_operators();
+    if (task_properties::has_axioms(task_proxy)) {
+        /* Axioms can change arbitrary variables, so there is nothing to
+           gain from incremental hashing. */
+        for (OperatorID op_id : op_ids) {
+            successors.push_back(get_successor_state(predecessor, operators[op_id]));
+        }
+        return;
+    }
+
+    int num_bins = get_bins_per_state();
+    int num_successors = op_ids.size();
+    const PackedStateBin *predecessor_buffer = predecessor.get_buffer();
+    uint64_t predecessor_hash = get_bins_hash(predecessor_buffer, num_bins);
+    successor_buffers.resize(num_successors * num_bins);
+    successor_hashes.resize(num_successors);
+
+    // Compute all successors and their hashes outside of the state pool.
+    for (int i = 0; i < num_successors; ++i) {
+        OperatorProxy op = operators[op_ids[i]];
+        assert(!op.is_axiom());
+        PackedStateBin *buffer = &successor_buffers[i * num_bins];
+        copy(predecessor_buffer, predecessor_buffer + num_bins, buffer);
+        uint64_t hash = predecessor_hash;
+        for (EffectProxy effect : op.get_effects()) {
+            if (does_fire(effect, predecessor)) {
+                FactPair effect_pair = effect.get_fact().get_pair();
+                int bin_index = state_packer.get_bin_index(effect_pair.var);
+                hash ^= get_bin_hash(buffer[bin_index], bin_index);
+                state_packer.set(buffer, effect_pair.var, effect_pair.value);
+                hash ^= get_bin_hash(buffer[bin_index], bin_index);
+            }
+        }
+        successor_hashes[i] = get_state_hash(hash);
+        registered_states.prefetch(successor_hashes[i]);
+    }
+
+    for (int i = 0; i < num_successors; ++i) {
+        StateID id = insert_state(
+            &successor_buffers[i * num_bins], successor_hashes[i],
+            predecessor.get_id());
+        successors.push_back(create_registered_state(id));
+    }
+}
+
+State StateRegistry::register_state_data(const PackedStateBin *data) {
+    int_hash_set::HashType hash =
+        get_state_hash(get_bins_hash(data, get_bins_per_state()));
+    StateID id = insert_state(data, hash, StateID::no_state);
+    return create_registered_state(id);
+}
+
+State StateRegistry::register_state_values(const vector<int> &values) {
+    int num_bins = get_bins_per_state();
+    unique_ptr<PackedStateBin[]> buffer(new PackedStateBin[num_bins]);
+    // Avoid garbage values in half-full bins.
+    fill_n(buffer.get(), num_bins, 0);
+    for (size_t var = 0; var < values.size(); ++var) {
+        state_packer.set(buffer.get(), var, values[var]);
+    }
+    return register_state_data(buffer.get());
+}
+
+StateID StateRegistry::find_state(const State &state) const {
+    return find_state_data(state.get_buffer());
+}
+
+StateID StateRegistry::find_state_data(const PackedStateBin *data) const {
+    int num_bins = get_bins_per_state();
+    int_hash_set::HashType hash = get_state_hash(get_bins_hash(data, num_bins));
+    int_hash_set::KeyType key = registered_states.find(
+        hash, [&](int_hash_set::KeyType id) {
+            shared_ptr<const PackedStateBin> owner;
+            const PackedStateBin *registered_data = get_state_data(id, owner);
+            return equal(data, data + num_bins, registered_data);
+        });
+    if (key < 0) {
+        return StateID::no_state;
+    }
+    return StateID(key);
+}
+
 int StateRegistry::get_bins_per_state() const {
     return state_packer.get_num_bins();
 }
@@ -106,4 +308,13 @@ int StateRegistry::get_state_size_in_bytes() const {
 void StateRegistry::print_statistics(utils::LogProxy &log) const {
     log << "Number of registered states: " << size() << endl;
     registered_states.print_statistics(log);
+    if (compressed_storage) {
+        log << "Compressed state storage: "
+            << compressed_storage->get_memory_in_bytes() / 1024 << " KB for "
+            << size() * get_state_size_in_bytes() / 1024
+            << " KB of uncompressed state data" << endl;
+        log << "Decompression cache hits/misses: "
+            << compressed_storage->get_num_cache_hits() << "/"
+            << compressed_storage->get_num_cache_misses() << endl;
+    }
 }
@@ -3,6 +3,8 @@
 
 #include "abstract_task.h"
 #include "axioms.h"
+#include "compressed_state_storage.h"
+#include "operator_id.h"
 #include "state_id.h"
 
 #include "algorithms/int_hash_set.h"
@@ -11,6 +13,7 @@
 #include "algorithms/subscriber.h"
 #include "utils/hash.h"
 
+#include <cstdint>
 #include <set>
 
 /*
@@ -113,39 +116,64 @@ using PackedStateBin = int_packer::IntPacker::Bin;
 
 
 class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
+    /*
+      States are hashed by combining independent hashes of their bins with
+      XOR. This allows computing the hash of a successor state from the hash
+      of its predecessor by only looking at the bins that changed.
+    */
+    static uint64_t get_bin_hash(PackedStateBin bin, int bin_index) {
+        // Finalizer of the splitmix64 generator.
+        uint64_t x = (static_cast<uint64_t>(bin_index) << 32) | bin;
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    static uint64_t get_bins_hash(const PackedStateBin *data, int state_size) {
+        uint64_t hash = 0;
+        for (int i = 0; i < state_size; ++i) {
+            hash ^= get_bin_hash(data[i], i);
+        }
+        return hash;
+    }
+
+    static int_hash_set::HashType get_state_hash(uint64_t bins_hash) {
+#ifdef USE_WIDE_STATE_IDS
+        return bins_hash;
+#else
+        return static_cast<int_hash_set::HashType>(bins_hash ^ (bins_hash >> 32));
+#endif
+    }
+
     struct StateIDSemanticHash {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateRegistry &registry;
         int state_size;
-        StateIDSemanticHash(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool),
+        StateIDSemanticHash(const StateRegistry &registry, int state_size)
+            : registry(registry),
               state_size(state_size) {
         }
 
-        int_hash_set::HashType operator()(int id) const {
-            const PackedStateBin *data = state_data_pool[id];
-            utils::HashState hash_state;
-            for (int i = 0; i < state_size; ++i) {
-                hash_state.feed(data[i]);
-            }
-            return hash_state.get_hash32();
+        int_hash_set::HashType operator()(int_hash_set::KeyType id) const {
+            std::shared_ptr<const PackedStateBin> owner;
+            const PackedStateBin *data = registry.get_state_data(id, owner);
+            return get_state_hash(get_bins_hash(data, state_size));
         }
     };
 
     struct StateIDSemanticEqual {
-        const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool;
+        const StateRegistry &registry;
         int state_size;
-        StateIDSemanticEqual(
-            const segmented_vector::SegmentedArrayVector<PackedStateBin> &state_data_pool,
-            int state_size)
-            : state_data_pool(state_data_pool),
+        StateIDSemanticEqual(const StateRegistry &registry, int state_size)
+            : registry(registry),
               state_size(state_size) {
         }
 
-        bool operator()(int lhs, int rhs) const {
-            const PackedStateBin *lhs_data = state_data_pool[lhs];
-            const PackedStateBin *rhs_data = state_data_pool[rhs];
+        bool operator()(int_hash_set::KeyType lhs, int_hash_set::KeyType rhs) const {
+            std::shared_ptr<const PackedStateBin> lhs_owner;
+            std::shared_ptr<const PackedStateBin> rhs_owner;
+            const PackedStateBin *lhs_data = registry.get_state_data(lhs, lhs_owner);
+            const PackedStateBin *rhs_data = registry.get_state_data(rhs, rhs_owner);
             return std::equal(lhs_data, lhs_data + state_size, rhs_data);
         }
     };
@@ -156,6 +184,8 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
       i.e. the actual state data is compared, not the memory location.
     */
     using StateIDSet = int_hash_set::IntHashSet<StateIDSemanticHash, StateIDSemanticEqual>;
+    static_assert(sizeof(int_hash_set::KeyType) == sizeof(StateIDValue),
+                  "hash set keys must be able to hold all state IDs");
 
     TaskProxy task_proxy;
     const int_packer::IntPacker &state_packer;
@@ -163,14 +193,40 @@ class StateRegistry : public subscriber::SubscriberService<StateRegistry> {
     const int num_variables;
 
     segmented_vector::SegmentedArrayVector<PackedStateBin> state_data_pool;
+    /*
+      If set, state data is stored here instead of in state_data_pool. To
+      check for duplicates, a new state is then inserted into
+      registered_states with the ID pending_state_id before it is stored.
+    */
+    std::unique_ptr<CompressedStateStorage> compressed_storage;
+    const PackedStateBin *pending_state_data;
     StateIDSet registered_states;
 
     std::unique_ptr<State> cached_initial_state;
 
+    // Scratch space for computing successor states.
+    std::vector<PackedStateBin> successor_buffers;
+    std::vector<int_hash_set::HashType> successor_hashes;
+
     StateID insert_id_or_pop_state();
+    StateID insert_id_or_pop_state(int_hash_set::HashType hash);
+    StateID insert_compressed_state(
+        const PackedStateBin *data, int_hash_set::HashType hash, StateID parent_id);
+    StateID insert_state(
+        const PackedStateBin *data, int_hash_set::HashType hash, StateID parent_id);
+    State get_compressed_successor_state(
+        const State &predecessor, const OperatorProxy &op);
+    State create_registered_state(StateID id) const;
+    State create_registered_state(StateID id, std::vector<int> &&values) const;
+    /*
+      Return the packed data of the state with the given ID. The data is
+      valid at least as long as owner is alive.
+    */
+    const PackedStateBin *get_state_data(
+        StateIDValue id, std::shared_ptr<const PackedStateBin> &owner) const;
     int get_bins_per_state() const;
 public:
-    explicit StateRegistry(const TaskProxy &task_proxy);
+    explicit StateRegistry(const TaskProxy &task_proxy, bool compress_states = false);
 
     const TaskProxy &get_task_proxy() const {
         return task_proxy;
@@ -207,6 +263,43 @@ public:
     */
     State get_successor_state(const State &predecessor, const OperatorProxy &op);
 
+    /*
+      Register the successors of predecessor for all given operators (in
+      this order) and store them in successors. This is equivalent to
+      calling get_successor_state for each operator but cheaper: successor
+      hashes are derived from the predecessor's hash and the hash buckets
+      are prefetched before the states are inserted.
+    */
+    void get_successor_states(
+        const State &predecessor, const std::vector<OperatorID> &op_ids,
+        std::vector<State> &successors);
+
+    /*
+      Registers the state with the given packed data if this was not done
+      before and returns it. The data must use the layout of this registry's
+      state packer, e.g., come from another registry for the same task.
+    */
+    State register_state_data(const PackedStateBin *data);
+
+    /*
+      Registers the state with the given values if this was not done before
+      and returns it.
+    */
+    State register_state_values(const std::vector<int> &values);
+
+    /*
+      Returns the ID of the registered state with the same values as the given
+      state, or StateID::no_state if there is none. The given state may belong
+      to another registry for the same task. Does not register the state.
+    */
+    StateID find_state(const State &state) const;
+
+    /*
+      Like find_state(), but for the given packed data, which must use the
+      layout of this registry's state packer.
+    */
+    StateID find_state_data(const PackedStateBin *data) const;
+
     /*
       Returns the number of states registered so far.
     */
@@ -268,4 +361,15 @@ public:
     }
 };
 
+inline const PackedStateBin *StateRegistry::get_state_data(
+    StateIDValue id, std::shared_ptr<const PackedStateBin> &owner) const {
+    if (!compressed_storage) {
+        return state_data_pool[id];
+    } else if (id == static_cast<StateIDValue>(compressed_storage->size())) {
+        return pending_state_data;
+    }
+    owner = compressed_storage->lookup(id);
+    return owner.get();
+}
+
 #endif
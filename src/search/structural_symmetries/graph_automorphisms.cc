@@ -0,0 +1,395 @@
+#include "graph_automorphisms.h"
+
+#include "../utils/countdown_timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <numeric>
+
+using namespace std;
+
+namespace structural_symmetries {
+int ColoredGraph::add_vertex(int color) {
+    colors.push_back(color);
+    neighbors.emplace_back();
+    return colors.size() - 1;
+}
+
+void ColoredGraph::add_edge(int vertex1, int vertex2) {
+    assert(vertex1 != vertex2);
+    neighbors[vertex1].push_back(vertex2);
+    neighbors[vertex2].push_back(vertex1);
+}
+
+void ColoredGraph::finalize() {
+    for (vector<int> &vertex_neighbors : neighbors) {
+        sort(vertex_neighbors.begin(), vertex_neighbors.end());
+        vertex_neighbors.erase(
+            unique(vertex_neighbors.begin(), vertex_neighbors.end()),
+            vertex_neighbors.end());
+        vertex_neighbors.shrink_to_fit();
+    }
+}
+
+bool ColoredGraph::has_edge(int vertex1, int vertex2) const {
+    return binary_search(neighbors[vertex1].begin(), neighbors[vertex1].end(),
+                         vertex2);
+}
+
+bool ColoredGraph::is_automorphism(const vector<int> &permutation) const {
+    int num_vertices = get_num_vertices();
+    for (int vertex = 0; vertex < num_vertices; ++vertex) {
+        int image = permutation[vertex];
+        if (colors[image] != colors[vertex] ||
+            neighbors[image].size() != neighbors[vertex].size()) {
+            return false;
+        }
+    }
+    /*
+      Since the permutation is a bijection, it is an automorphism if it maps
+      every edge to an edge.
+    */
+    for (int vertex = 0; vertex < num_vertices; ++vertex) {
+        for (int neighbor : neighbors[vertex]) {
+            if (neighbor > vertex &&
+                !has_edge(permutation[vertex], permutation[neighbor])) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+
+AutomorphismFinder::AutomorphismFinder(const ColoredGraph &graph)
+    : graph(graph),
+      num_vertices(graph.get_num_vertices()),
+      timer(nullptr),
+      num_search_nodes(0),
+      complete(true),
+      in_queue(num_vertices, false),
+      counts(num_vertices, 0) {
+}
+
+void AutomorphismFinder::create_initial_partition(Partition &partition) {
+    partition.elements.resize(num_vertices);
+    iota(partition.elements.begin(), partition.elements.end(), 0);
+    stable_sort(partition.elements.begin(), partition.elements.end(),
+                [&](int vertex1, int vertex2) {
+                    return graph.get_color(vertex1) < graph.get_color(vertex2);
+                });
+    partition.position.resize(num_vertices);
+    partition.cell_of.resize(num_vertices);
+    partition.cell_end.resize(num_vertices);
+    partition.num_cells = 0;
+    int cell = 0;
+    for (int pos = 0; pos < num_vertices; ++pos) {
+        int vertex = partition.elements[pos];
+        if (graph.get_color(vertex) !=
+            graph.get_color(partition.elements[cell])) {
+            partition.cell_end[cell] = pos;
+            enqueue_splitter(cell);
+            ++partition.num_cells;
+            cell = pos;
+        }
+        partition.position[vertex] = pos;
+        partition.cell_of[vertex] = cell;
+    }
+    if (num_vertices > 0) {
+        partition.cell_end[cell] = num_vertices;
+        enqueue_splitter(cell);
+        ++partition.num_cells;
+    }
+}
+
+void AutomorphismFinder::enqueue_splitter(int cell) {
+    if (!in_queue[cell]) {
+        in_queue[cell] = true;
+        splitter_queue.push_back(cell);
+    }
+}
+
+void AutomorphismFinder::refine(Partition &partition) {
+    while (!splitter_queue.empty()) {
+        int splitter = splitter_queue.front();
+        splitter_queue.pop_front();
+        in_queue[splitter] = false;
+
+        // Count the neighbors in the splitter cell.
+        for (int pos = splitter; pos < partition.cell_end[splitter]; ++pos) {
+            for (int neighbor : graph.get_neighbors(partition.elements[pos])) {
+                if (counts[neighbor]++ == 0) {
+                    touched_vertices.push_back(neighbor);
+                }
+            }
+        }
+
+        /*
+          Order the touched vertices by cell and count. The order of the
+          cells only depends on positions, which keeps the refinement
+          invariant under automorphisms.
+        */
+        sort(touched_vertices.begin(), touched_vertices.end(),
+             [&](int vertex1, int vertex2) {
+                 int cell1 = partition.cell_of[vertex1];
+                 int cell2 = partition.cell_of[vertex2];
+                 if (cell1 != cell2)
+                     return cell1 < cell2;
+                 if (counts[vertex1] != counts[vertex2])
+                     return counts[vertex1] < counts[vertex2];
+                 return vertex1 < vertex2;
+             });
+
+        auto group_begin = touched_vertices.cbegin();
+        while (group_begin != touched_vertices.cend()) {
+            int cell = partition.cell_of[*group_begin];
+            auto group_end = group_begin;
+            while (group_end != touched_vertices.cend() &&
+                   partition.cell_of[*group_end] == cell) {
+                ++group_end;
+            }
+            split_cell(partition, cell, group_begin, group_end);
+            group_begin = group_end;
+        }
+
+        for (int vertex : touched_vertices) {
+            counts[vertex] = 0;
+        }
+        touched_vertices.clear();
+    }
+}
+
+void AutomorphismFinder::split_cell(
+    Partition &partition, int cell,
+    vector<int>::const_iterator touched_begin,
+    vector<int>::const_iterator touched_end) {
+    int end = partition.cell_end[cell];
+    int num_touched = touched_end - touched_begin;
+    int tail_start = end - num_touched;
+    if (end - cell == 1 ||
+        (tail_start == cell &&
+         counts[*touched_begin] == counts[*(touched_end - 1)])) {
+        // All vertices of the cell have the same count.
+        return;
+    }
+
+    /*
+      Move the untouched vertices (count 0) to the front of the cell and
+      the touched vertices to the tail in order of increasing count.
+    */
+    for (auto it = touched_begin; it != touched_end; ++it) {
+        int pos = tail_start + (it - touched_begin);
+        int vertex = *it;
+        int old_pos = partition.position[vertex];
+        int displaced = partition.elements[pos];
+        partition.elements[old_pos] = displaced;
+        partition.position[displaced] = old_pos;
+        partition.elements[pos] = vertex;
+        partition.position[vertex] = pos;
+    }
+
+    // Split the cell into groups of vertices with the same count.
+    vector<int> &group_starts = group_starts_buffer;
+    group_starts.clear();
+    if (tail_start > cell) {
+        group_starts.push_back(cell);
+    }
+    for (int pos = tail_start; pos < end; ++pos) {
+        int vertex = partition.elements[pos];
+        if (pos == tail_start ||
+            counts[vertex] != counts[partition.elements[pos - 1]]) {
+            group_starts.push_back(pos);
+        }
+    }
+    group_starts.push_back(end);
+    assert(group_starts.size() > 2);
+
+    int num_groups = group_starts.size() - 1;
+    int largest_group = 0;
+    for (int i = 0; i < num_groups; ++i) {
+        int start = group_starts[i];
+        int group_end = group_starts[i + 1];
+        partition.cell_end[start] = group_end;
+        if (start >= tail_start) {
+            for (int pos = start; pos < group_end; ++pos) {
+                partition.cell_of[partition.elements[pos]] = start;
+            }
+        }
+        if (group_end - start >
+            group_starts[largest_group + 1] - group_starts[largest_group]) {
+            largest_group = i;
+        }
+    }
+    partition.num_cells += num_groups - 1;
+
+    /*
+      If the cell still has to be used as a splitter, all groups have to be
+      used. Otherwise, all groups but the largest suffice (Hopcroft).
+    */
+    bool cell_in_queue = in_queue[cell];
+    for (int i = 0; i < num_groups; ++i) {
+        if (cell_in_queue || i != largest_group) {
+            enqueue_splitter(group_starts[i]);
+        }
+    }
+}
+
+void AutomorphismFinder::individualize(Partition &partition, int vertex) {
+    int cell = partition.cell_of[vertex];
+    int end = partition.cell_end[cell];
+    assert(end - cell > 1);
+    int last_pos = end - 1;
+    int displaced = partition.elements[last_pos];
+    int old_pos = partition.position[vertex];
+    partition.elements[old_pos] = displaced;
+    partition.position[displaced] = old_pos;
+    partition.elements[last_pos] = vertex;
+    partition.position[vertex] = last_pos;
+
+    partition.cell_end[cell] = last_pos;
+    partition.cell_of[vertex] = last_pos;
+    partition.cell_end[last_pos] = end;
+    ++partition.num_cells;
+    enqueue_splitter(last_pos);
+    refine(partition);
+}
+
+int AutomorphismFinder::choose_target_cell(const Partition &partition) const {
+    int target = -1;
+    int target_size = num_vertices + 1;
+    for (int cell = 0; cell < num_vertices; cell = partition.cell_end[cell]) {
+        int size = partition.cell_end[cell] - cell;
+        if (size > 1 && size < target_size) {
+            target = cell;
+            target_size = size;
+        }
+    }
+    assert(target != -1);
+    return target;
+}
+
+bool AutomorphismFinder::have_same_shape(
+    const Partition &partition1, const Partition &partition2) const {
+    if (partition1.num_cells != partition2.num_cells) {
+        return false;
+    }
+    for (int cell = 0; cell < num_vertices; cell = partition2.cell_end[cell]) {
+        if (partition1.cell_of[partition1.elements[cell]] != cell ||
+            partition1.cell_end[cell] != partition2.cell_end[cell] ||
+            graph.get_color(partition1.elements[cell]) !=
+            graph.get_color(partition2.elements[cell])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int AutomorphismFinder::find_orbit(int vertex) {
+    while (orbit_parent[vertex] != vertex) {
+        orbit_parent[vertex] = orbit_parent[orbit_parent[vertex]];
+        vertex = orbit_parent[vertex];
+    }
+    return vertex;
+}
+
+void AutomorphismFinder::add_generator(vector<int> &&permutation) {
+    for (int vertex = 0; vertex < num_vertices; ++vertex) {
+        int orbit1 = find_orbit(vertex);
+        int orbit2 = find_orbit(permutation[vertex]);
+        if (orbit1 != orbit2) {
+            orbit_parent[max(orbit1, orbit2)] = min(orbit1, orbit2);
+        }
+    }
+    generators.push_back(move(permutation));
+}
+
+bool AutomorphismFinder::search_subtree(const Partition &partition, int level) {
+    if (partition.is_discrete()) {
+        const vector<int> &first_leaf = first_path.back().elements;
+        vector<int> permutation(num_vertices);
+        for (int pos = 0; pos < num_vertices; ++pos) {
+            permutation[first_leaf[pos]] = partition.elements[pos];
+        }
+        if (graph.is_automorphism(permutation)) {
+            add_generator(move(permutation));
+            return true;
+        }
+        return false;
+    }
+
+    int target = first_path_targets[level];
+    for (int pos = target; pos < partition.cell_end[target]; ++pos) {
+        if (timer->is_expired()) {
+            complete = false;
+            return false;
+        }
+        Partition child = partition;
+        individualize(child, partition.elements[pos]);
+        ++num_search_nodes;
+        if (have_same_shape(child, first_path[level + 1]) &&
+            search_subtree(child, level + 1)) {
+            return true;
+        }
+        if (!complete) {
+            return false;
+        }
+    }
+    return false;
+}
+
+vector<vector<int>> AutomorphismFinder::find_generators(double max_time) {
+    utils::CountdownTimer countdown_timer(max_time);
+    timer = &countdown_timer;
+
+    Partition root;
+    create_initial_partition(root);
+    refine(root);
+    first_path.push_back(move(root));
+    ++num_search_nodes;
+    while (!first_path.back().is_discrete()) {
+        Partition child = first_path.back();
+        int target = choose_target_cell(child);
+        int vertex = child.elements[target];
+        first_path_targets.push_back(target);
+        first_path_choices.push_back(vertex);
+        individualize(child, vertex);
+        first_path.push_back(move(child));
+        ++num_search_nodes;
+    }
+
+    orbit_parent.resize(num_vertices);
+    iota(orbit_parent.begin(), orbit_parent.end(), 0);
+
+    /*
+      Going up the first path ensures that all generators found so far fix
+      the vertices individualized above the current level, so their orbits
+      are orbits of the stabilizer of these vertices.
+    */
+    int depth = first_path_choices.size();
+    for (int level = depth - 1; level >= 0 && complete; --level) {
+        const Partition &partition = first_path[level];
+        int target = first_path_targets[level];
+        int first_choice = first_path_choices[level];
+        for (int pos = target; pos < partition.cell_end[target]; ++pos) {
+            if (timer->is_expired()) {
+                complete = false;
+                break;
+            }
+            int vertex = partition.elements[pos];
+            if (find_orbit(vertex) == find_orbit(first_choice)) {
+                continue;
+            }
+            Partition child = partition;
+            individualize(child, vertex);
+            ++num_search_nodes;
+            if (have_same_shape(child, first_path[level + 1])) {
+                search_subtree(child, level + 1);
+            }
+        }
+    }
+
+    first_path.clear();
+    timer = nullptr;
+    return move(generators);
+}
+}
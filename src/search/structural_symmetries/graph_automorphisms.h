@@ -0,0 +1,130 @@
+#ifndef STRUCTURAL_SYMMETRIES_GRAPH_AUTOMORPHISMS_H
+#define STRUCTURAL_SYMMETRIES_GRAPH_AUTOMORPHISMS_H
+
+#include <deque>
+#include <vector>
+
+namespace utils {
+class CountdownTimer;
+}
+
+namespace structural_symmetries {
+// Undirected graph with colored vertices.
+class ColoredGraph {
+    std::vector<int> colors;
+    std::vector<std::vector<int>> neighbors;
+public:
+    int add_vertex(int color);
+    void add_edge(int vertex1, int vertex2);
+    // Sort the adjacency lists and remove parallel edges.
+    void finalize();
+
+    int get_num_vertices() const {
+        return colors.size();
+    }
+
+    int get_color(int vertex) const {
+        return colors[vertex];
+    }
+
+    const std::vector<int> &get_neighbors(int vertex) const {
+        return neighbors[vertex];
+    }
+
+    // Requires finalize().
+    bool has_edge(int vertex1, int vertex2) const;
+    // Requires finalize().
+    bool is_automorphism(const std::vector<int> &permutation) const;
+};
+
+/*
+  Computes generators of the automorphism group of a colored graph with
+  individualization and refinement (as in nauty or bliss).
+
+  We refine the coloring of the vertices to an equitable partition,
+  individualize a vertex of the first smallest non-singleton cell and
+  repeat until the partition is discrete ("first path"). Then we go back up
+  the first path, individualize other vertices of the target cells and
+  search the subtree below for a leaf that induces an automorphism together
+  with the first leaf. Subtrees whose partitions differ in shape from the
+  first path are pruned, and candidates in the same orbit as the vertex on
+  the first path are skipped.
+
+  Every generator is verified, so the result only contains automorphisms.
+  Unlike nauty, we do not search the full tree for other leaves than the
+  first one, and the search stops when the time limit is reached, so the
+  generators may only generate a subgroup of the automorphism group.
+*/
+class AutomorphismFinder {
+    /*
+      Ordered partition of the vertices. The cells are ranges of positions
+      in elements and identified by their first position.
+    */
+    struct Partition {
+        std::vector<int> elements;
+        std::vector<int> position;
+        // Start position of the cell containing the vertex.
+        std::vector<int> cell_of;
+        // End position (exclusive) of the cell starting at the position.
+        std::vector<int> cell_end;
+        int num_cells;
+
+        bool is_discrete() const {
+            return num_cells == static_cast<int>(elements.size());
+        }
+    };
+
+    const ColoredGraph &graph;
+    const int num_vertices;
+    utils::CountdownTimer *timer;
+
+    // Partitions, target cells and individualized vertices of the first path.
+    std::vector<Partition> first_path;
+    std::vector<int> first_path_targets;
+    std::vector<int> first_path_choices;
+
+    std::vector<std::vector<int>> generators;
+    // Union-find structure over the orbits of the generators.
+    std::vector<int> orbit_parent;
+    int num_search_nodes;
+    bool complete;
+
+    // Data of the current refinement.
+    std::deque<int> splitter_queue;
+    std::vector<bool> in_queue;
+    std::vector<int> counts;
+    std::vector<int> touched_vertices;
+    std::vector<int> group_starts_buffer;
+
+    void create_initial_partition(Partition &partition);
+    void enqueue_splitter(int cell);
+    void refine(Partition &partition);
+    void split_cell(Partition &partition, int cell,
+                    std::vector<int>::const_iterator touched_begin,
+                    std::vector<int>::const_iterator touched_end);
+    void individualize(Partition &partition, int vertex);
+    int choose_target_cell(const Partition &partition) const;
+    bool have_same_shape(const Partition &partition1,
+                         const Partition &partition2) const;
+
+    int find_orbit(int vertex);
+    void add_generator(std::vector<int> &&permutation);
+    bool search_subtree(const Partition &partition, int level);
+public:
+    explicit AutomorphismFinder(const ColoredGraph &graph);
+
+    // Return the generators found within the time limit (in seconds).
+    std::vector<std::vector<int>> find_generators(double max_time);
+
+    int get_num_search_nodes() const {
+        return num_search_nodes;
+    }
+
+    // Return false if the search was stopped by the time limit.
+    bool is_complete() const {
+        return complete;
+    }
+};
+}
+
+#endif
@@ -0,0 +1,283 @@
+#include "group.h"
+
+#include "graph_automorphisms.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../task_utils/task_properties.h"
+#include "../utils/markup.h"
+#include "../utils/timer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+
+using namespace std;
+
+namespace structural_symmetries {
+enum VertexColor {
+    VARIABLE,
+    FACT,
+    HARD_GOAL,
+    SOFT_GOAL,
+    INITIAL_FACT,
+    INITIAL_HARD_GOAL,
+    INITIAL_SOFT_GOAL,
+    PRECONDITION,
+    EFFECT,
+    FIRST_FREE_COLOR
+};
+
+Group::Group(const Options &opts)
+    : permute_soft_goals(opts.get<bool>("permute_soft_goals")),
+      max_time(opts.get<double>("max_time")),
+      log(utils::get_log_from_options(opts)),
+      initialized(false) {
+}
+
+void Group::compute_symmetries(const TaskProxy &task_proxy) {
+    if (initialized) {
+        return;
+    }
+    initialized = true;
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+    utils::Timer timer;
+
+    VariablesProxy variables = task_proxy.get_variables();
+    int num_variables = variables.size();
+    for (VariableProxy var : variables) {
+        fact_offsets.push_back(facts.size());
+        for (int value = 0; value < var.get_domain_size(); ++value) {
+            facts.emplace_back(var.get_id(), value);
+        }
+    }
+    int num_facts = facts.size();
+
+    // Without hard goals, all goals are soft goals (see MSGSCollection).
+    vector<int> fact_colors(num_facts, FACT);
+    int next_color = FIRST_FREE_COLOR;
+    auto color_goals = [&](const ConditionsProxy &goals, bool soft) {
+            for (FactProxy goal : goals) {
+                FactPair fact = goal.get_pair();
+                int color = soft ? SOFT_GOAL : HARD_GOAL;
+                if (soft && !permute_soft_goals) {
+                    color = next_color++;
+                }
+                fact_colors[fact_offsets[fact.var] + fact.value] = color;
+            }
+        };
+    if (task_proxy.get_hard_goals().empty()) {
+        color_goals(task_proxy.get_goals(), true);
+    } else {
+        color_goals(task_proxy.get_hard_goals(), false);
+        color_goals(task_proxy.get_soft_goals(), true);
+    }
+    /*
+      Closing the goal subsets under symmetries that permute soft goals is
+      only sound if the symmetries also fix the initial state, i.e., we use
+      the stabilizer of the initial state.
+    */
+    if (permute_soft_goals) {
+        for (FactProxy fact : task_proxy.get_initial_state()) {
+            FactPair pair = fact.get_pair();
+            int &color = fact_colors[fact_offsets[pair.var] + pair.value];
+            if (color == FACT) {
+                color = INITIAL_FACT;
+            } else if (color == HARD_GOAL) {
+                color = INITIAL_HARD_GOAL;
+            } else if (color == SOFT_GOAL) {
+                color = INITIAL_SOFT_GOAL;
+            }
+        }
+    }
+
+    map<int, int> cost_colors;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (!cost_colors.count(op.get_cost())) {
+            cost_colors[op.get_cost()] = 0;
+        }
+    }
+    for (auto &entry : cost_colors) {
+        entry.second = next_color++;
+    }
+
+    ColoredGraph graph;
+    for (int var = 0; var < num_variables; ++var) {
+        graph.add_vertex(VARIABLE);
+    }
+    for (int fact_id = 0; fact_id < num_facts; ++fact_id) {
+        int vertex = graph.add_vertex(fact_colors[fact_id]);
+        graph.add_edge(facts[fact_id].var, vertex);
+    }
+    auto get_fact_vertex = [&](const FactPair &fact) {
+            return num_variables + fact_offsets[fact.var] + fact.value;
+        };
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        int op_vertex = graph.add_vertex(cost_colors[op.get_cost()]);
+        for (FactProxy pre : op.get_preconditions()) {
+            int pre_vertex = graph.add_vertex(PRECONDITION);
+            graph.add_edge(op_vertex, pre_vertex);
+            graph.add_edge(pre_vertex, get_fact_vertex(pre.get_pair()));
+        }
+        for (EffectProxy eff : op.get_effects()) {
+            int eff_vertex = graph.add_vertex(EFFECT);
+            graph.add_edge(op_vertex, eff_vertex);
+            graph.add_edge(eff_vertex, get_fact_vertex(eff.get_fact().get_pair()));
+        }
+    }
+    graph.finalize();
+
+    AutomorphismFinder finder(graph);
+    vector<vector<int>> generators = finder.find_generators(max_time);
+
+    for (const vector<int> &generator : generators) {
+        vector<int> var_image(num_variables);
+        vector<int> fact_image(num_facts);
+        bool is_identity = true;
+        for (int var = 0; var < num_variables; ++var) {
+            var_image[var] = generator[var];
+            assert(var_image[var] < num_variables);
+        }
+        for (int fact_id = 0; fact_id < num_facts; ++fact_id) {
+            fact_image[fact_id] = generator[num_variables + fact_id] - num_variables;
+            assert(facts[fact_image[fact_id]].var == var_image[facts[fact_id].var]);
+            if (fact_image[fact_id] != fact_id) {
+                is_identity = false;
+            }
+        }
+        // Skip generators that only permute (duplicate) operators.
+        if (!is_identity) {
+            variable_images.push_back(move(var_image));
+            fact_images.push_back(move(fact_image));
+        }
+    }
+
+    if (log.is_at_least_normal()) {
+        log << "Problem description graph: " << graph.get_num_vertices()
+            << " vertices" << endl;
+        log << "Symmetry generators: " << fact_images.size() << endl;
+        log << "Automorphism search nodes: " << finder.get_num_search_nodes()
+            << endl;
+        if (!finder.is_complete()) {
+            log << "Automorphism search reached the time limit, "
+                << "some symmetries may be missing." << endl;
+        }
+        log << "Time for computing symmetries: " << timer << endl;
+    }
+}
+
+void Group::apply_generator(int generator, const vector<int> &values,
+                            vector<int> &result) const {
+    const vector<int> &var_image = variable_images[generator];
+    const vector<int> &fact_image = fact_images[generator];
+    for (size_t var = 0; var < values.size(); ++var) {
+        int image = fact_image[fact_offsets[var] + values[var]];
+        result[var_image[var]] = facts[image].value;
+    }
+}
+
+vector<int> Group::get_canonical_values(
+    const vector<int> &values, vector<int> *applied_generators) const {
+    vector<int> best = values;
+    vector<int> candidate(values.size());
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (size_t generator = 0; generator < fact_images.size(); ++generator) {
+            apply_generator(generator, best, candidate);
+            if (candidate < best) {
+                best.swap(candidate);
+                improved = true;
+                if (applied_generators) {
+                    applied_generators->push_back(generator);
+                }
+            }
+        }
+    }
+    return best;
+}
+
+vector<int> Group::apply_generators(
+    const vector<int> &values, const vector<int> &generators) const {
+    vector<int> result = values;
+    vector<int> buffer(values.size());
+    for (int generator : generators) {
+        apply_generator(generator, result, buffer);
+        result.swap(buffer);
+    }
+    return result;
+}
+
+vector<vector<int>> Group::get_goal_permutations(
+    const vector<FactPair> &goals) const {
+    vector<int> goal_index(facts.size(), -1);
+    for (size_t i = 0; i < goals.size(); ++i) {
+        goal_index[fact_offsets[goals[i].var] + goals[i].value] = i;
+    }
+    vector<vector<int>> permutations;
+    for (const vector<int> &fact_image : fact_images) {
+        vector<int> permutation(goals.size());
+        bool is_identity = true;
+        for (size_t i = 0; i < goals.size(); ++i) {
+            int image = fact_image[fact_offsets[goals[i].var] + goals[i].value];
+            permutation[i] = goal_index[image];
+            assert(permutation[i] != -1);
+            if (permutation[i] != static_cast<int>(i)) {
+                is_identity = false;
+            }
+        }
+        if (!is_identity) {
+            permutations.push_back(move(permutation));
+        }
+    }
+    return permutations;
+}
+
+static shared_ptr<Group> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Structural symmetries",
+        "Computes generators of the automorphism group of the problem "
+        "description graph of the task. Search engines that support "
+        "symmetries expand only one state of each set of symmetric states "
+        "they find. For details on structural symmetries, see "
+        + utils::format_conference_reference(
+            {"Alexander Shleyfman", "Michael Katz", "Malte Helmert",
+             "Silvan Sievers", "Martin Wehrle"},
+            "Heuristics and Symmetries in Classical Planning",
+            "https://ai.dmi.unibas.ch/papers/shleyfman-et-al-aaai2015.pdf",
+            "Proceedings of the Twenty-Ninth AAAI Conference on "
+            "Artificial Intelligence (AAAI 2015)",
+            "3371-3377",
+            "AAAI Press",
+            "2015"));
+    parser.add_option<bool>(
+        "permute_soft_goals",
+        "allow symmetries that permute soft goals. The goal subsets found "
+        "by the search are then mapped through the symmetries, which is "
+        "only sound for symmetries that fix the initial state, so only "
+        "those are used. If false, every soft goal is fixed by all "
+        "symmetries, but the initial state need not be.",
+        "false");
+    parser.add_option<double>(
+        "max_time",
+        "maximum time in seconds for the automorphism search. If it is "
+        "reached, only the symmetries found so far are used.",
+        "infinity",
+        Bounds("0.0", "infinity"));
+    utils::add_log_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run()) {
+        return nullptr;
+    }
+    return make_shared<Group>(opts);
+}
+
+static Plugin<Group> _plugin("structural_symmetries", _parse);
+
+static PluginTypePlugin<Group> _type_plugin(
+    "Group",
+    "Structural symmetries of the planning task.");
+}
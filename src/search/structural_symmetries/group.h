@@ -0,0 +1,84 @@
+#ifndef STRUCTURAL_SYMMETRIES_GROUP_H
+#define STRUCTURAL_SYMMETRIES_GROUP_H
+
+#include "../task_proxy.h"
+
+#include "../utils/logging.h"
+
+#include <vector>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace structural_symmetries {
+/*
+  Structural symmetries of a planning task (Shleyfman et al., AAAI 2015).
+
+  We compute automorphisms of the problem description graph (PDG) of the
+  task. It has a vertex per variable, fact and operator and, for each
+  precondition and effect, a vertex connected to the operator and the fact.
+  Operators are colored by their cost and goal facts by their kind, so
+  the automorphisms induce permutations of the facts and operators that
+  preserve costs and map hard goals to hard goals and soft goals to soft
+  goals. If soft goals must not be permuted, every soft goal has its own
+  color and the initial state is not colored, so symmetric states can be
+  identified in the whole state space. If soft goals may be permuted, the
+  facts of the initial state have their own colors, so that only the
+  stabilizer of the initial state is used: otherwise goal subsets mapped
+  through a symmetry may only be reachable from a different initial state.
+
+  Axioms and conditional effects are not supported.
+*/
+class Group {
+    const bool permute_soft_goals;
+    const double max_time;
+    mutable utils::LogProxy log;
+
+    bool initialized;
+    std::vector<int> fact_offsets;
+    std::vector<FactPair> facts;
+    /*
+      For each generator, the images of the variables and of the facts
+      (indexed by fact_offsets[var] + value).
+    */
+    std::vector<std::vector<int>> variable_images;
+    std::vector<std::vector<int>> fact_images;
+
+    void apply_generator(int generator, const std::vector<int> &values,
+                         std::vector<int> &result) const;
+public:
+    explicit Group(const options::Options &opts);
+
+    void compute_symmetries(const TaskProxy &task_proxy);
+
+    bool has_symmetries() const {
+        return !fact_images.empty();
+    }
+
+    /*
+      Return the values of a state that is symmetric to the given one. The
+      result is the lexicographically smallest state that is found by
+      greedily applying generators, so it is the same for many but not
+      necessarily for all symmetric states. If applied_generators is given,
+      the indices of the applied generators are appended to it.
+    */
+    std::vector<int> get_canonical_values(
+        const std::vector<int> &values,
+        std::vector<int> *applied_generators = nullptr) const;
+
+    // Apply the given generators in the given order to the state values.
+    std::vector<int> apply_generators(
+        const std::vector<int> &values, const std::vector<int> &generators) const;
+
+    /*
+      Return the permutations of the indices of the given goal facts that
+      the generators induce. Identity permutations are omitted.
+    */
+    std::vector<std::vector<int>> get_goal_permutations(
+        const std::vector<FactPair> &goals) const;
+};
+}
+
+#endif
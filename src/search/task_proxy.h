@@ -627,6 +627,11 @@ class State {
       semantics of the state".
     */
     mutable std::shared_ptr<std::vector<int>> values;
+    /*
+      Keeps the packed data alive if it is not owned by the registry, e.g.,
+      for registries with compressed state storage. Otherwise, it is empty.
+    */
+    std::shared_ptr<const PackedStateBin> owned_buffer;
     const int_packer::IntPacker *state_packer;
     int num_variables;
 public:
@@ -638,6 +643,13 @@ public:
     // Construct a registered state with packed and unpacked data.
     State(const AbstractTask &task, const StateRegistry &registry, StateID id,
           const PackedStateBin *buffer, std::vector<int> &&values);
+    // Construct a registered state with packed data owned by the state.
+    State(const AbstractTask &task, const StateRegistry &registry, StateID id,
+          std::shared_ptr<const PackedStateBin> &&owned_buffer);
+    // Construct a registered state with owned packed and unpacked data.
+    State(const AbstractTask &task, const StateRegistry &registry, StateID id,
+          std::shared_ptr<const PackedStateBin> &&owned_buffer,
+          std::vector<int> &&values);
     // Construct a state with only unpacked data.
     State(const AbstractTask &task, std::vector<int> &&values);
 
@@ -755,6 +767,22 @@ public:
         return State(*task, registry, id, buffer, std::move(state_values));
     }
 
+    // This method is meant to be called only by the state registry.
+    State create_state(
+        const StateRegistry &registry, StateID id,
+        std::shared_ptr<const PackedStateBin> &&owned_buffer) const {
+        return State(*task, registry, id, std::move(owned_buffer));
+    }
+
+    // This method is meant to be called only by the state registry.
+    State create_state(
+        const StateRegistry &registry, StateID id,
+        std::shared_ptr<const PackedStateBin> &&owned_buffer,
+        std::vector<int> &&state_values) const {
+        return State(*task, registry, id, std::move(owned_buffer),
+                     std::move(state_values));
+    }
+
     RelaxedTasksProxy get_relaxed_task() const {
         return RelaxedTasksProxy(*task);
     }
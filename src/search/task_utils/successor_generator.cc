@@ -5,20 +5,40 @@
 
 #include "../abstract_task.h"
 
+#include "../utils/memory.h"
+
 using namespace std;
 
 namespace successor_generator {
-SuccessorGenerator::SuccessorGenerator(const TaskProxy &task_proxy)
-    : root(SuccessorGeneratorFactory(task_proxy).create()) {
+SuccessorGenerator::SuccessorGenerator(
+    const TaskProxy &task_proxy, SuccessorGeneratorType type)
+    : telemetry("successor_generation") {
+    SuccessorGeneratorFactory factory(task_proxy);
+    if (type == SuccessorGeneratorType::FLAT) {
+        flat_generator = factory.create_flat();
+    } else {
+        root = factory.create();
+    }
 }
 
 SuccessorGenerator::~SuccessorGenerator() = default;
 
 void SuccessorGenerator::generate_applicable_ops(
     const State &state, vector<OperatorID> &applicable_ops) const {
+    utils::TelemetryTimer timer(telemetry);
+    if (flat_generator) {
+        flat_generator->generate_applicable_ops(state, applicable_ops);
+        return;
+    }
     state.unpack();
     root->generate_applicable_ops(state.get_unpacked_values(), applicable_ops);
 }
 
 PerTaskInformation<SuccessorGenerator> g_successor_generators;
+
+PerTaskInformation<SuccessorGenerator> g_flat_successor_generators(
+    [](const TaskProxy &task_proxy) {
+        return utils::make_unique_ptr<SuccessorGenerator>(
+            task_proxy, SuccessorGeneratorType::FLAT);
+    });
 }
@@ -3,6 +3,8 @@
 
 #include "../per_task_information.h"
 
+#include "../utils/telemetry.h"
+
 #include <memory>
 #include <vector>
 
@@ -11,13 +13,26 @@ class State;
 class TaskProxy;
 
 namespace successor_generator {
+class FlatGenerator;
 class GeneratorBase;
 
+enum class SuccessorGeneratorType {
+    // Tree of polymorphic generator nodes working on unpacked states.
+    TREE,
+    // Compiled, flat node array working on packed states.
+    FLAT
+};
+
 class SuccessorGenerator {
+    // Exactly one of root and flat_generator is set.
     std::unique_ptr<GeneratorBase> root;
+    std::unique_ptr<FlatGenerator> flat_generator;
+    mutable utils::TelemetryHandle telemetry;
 
 public:
-    explicit SuccessorGenerator(const TaskProxy &task_proxy);
+    explicit SuccessorGenerator(
+        const TaskProxy &task_proxy,
+        SuccessorGeneratorType type = SuccessorGeneratorType::TREE);
     /*
       We cannot use the default destructor (implicitly or explicitly)
       here because GeneratorBase is a forward declaration and the
@@ -30,6 +45,7 @@ public:
 };
 
 extern PerTaskInformation<SuccessorGenerator> g_successor_generators;
+extern PerTaskInformation<SuccessorGenerator> g_flat_successor_generators;
 }
 
 #endif
@@ -270,6 +270,109 @@ GeneratorPtr SuccessorGeneratorFactory::construct_recursive(
     return construct_fork(move(nodes));
 }
 
+int SuccessorGeneratorFactory::compile_fork(
+    const vector<int> &children, vector<int> &code) const {
+    int size = children.size();
+    if (size == 0) {
+        // This can (only) happen for the root for tasks with no operators.
+        return NO_NODE;
+    } else if (size == 1) {
+        return children[0];
+    }
+    int pos = code.size();
+    code.push_back(FlatGenerator::FORK);
+    code.push_back(size);
+    code.insert(code.end(), children.begin(), children.end());
+    return pos;
+}
+
+int SuccessorGeneratorFactory::compile_leaf(
+    OperatorRange range, vector<int> &code, vector<OperatorID> &operators) const {
+    assert(!range.empty());
+    int pos = code.size();
+    code.push_back(FlatGenerator::LEAF);
+    code.push_back(operators.size());
+    while (range.begin != range.end) {
+        operators.push_back(operator_infos[range.begin].get_op());
+        ++range.begin;
+    }
+    code.push_back(operators.size());
+    return pos;
+}
+
+int SuccessorGeneratorFactory::compile_switch(
+    int switch_var_id, const vector<pair<int, int>> &values_and_children,
+    vector<int> &code) const {
+    VariablesProxy variables = task_proxy.get_variables();
+    int var_domain = variables[switch_var_id].get_domain_size();
+    int num_children = values_and_children.size();
+
+    assert(num_children > 0);
+
+    int pos = code.size();
+    if (num_children == 1) {
+        code.push_back(FlatGenerator::SINGLE_SWITCH);
+        code.push_back(switch_var_id);
+        code.push_back(values_and_children[0].first);
+        code.push_back(values_and_children[0].second);
+        return pos;
+    }
+
+    /* Prefer the constant-time vector switch unless it needs much more
+       space than the sorted switch. */
+    int sorted_size = 1 + 2 * num_children;
+    if (var_domain <= 2 * sorted_size) {
+        code.push_back(FlatGenerator::VECTOR_SWITCH);
+        code.push_back(switch_var_id);
+        int children_begin = code.size();
+        code.resize(children_begin + var_domain, NO_NODE);
+        for (const auto &item : values_and_children)
+            code[children_begin + item.first] = item.second;
+    } else {
+        // Values are increasing because the operators are sorted.
+        code.push_back(FlatGenerator::SORTED_SWITCH);
+        code.push_back(switch_var_id);
+        code.push_back(num_children);
+        for (const auto &item : values_and_children) {
+            code.push_back(item.first);
+            code.push_back(item.second);
+        }
+    }
+    return pos;
+}
+
+int SuccessorGeneratorFactory::compile_recursive(
+    int depth, OperatorRange range, vector<int> &code,
+    vector<OperatorID> &operators) const {
+    vector<int> children;
+    OperatorGrouper grouper_by_var(
+        operator_infos, depth, GroupOperatorsBy::VAR, range);
+    while (!grouper_by_var.done()) {
+        auto var_group = grouper_by_var.next();
+        int var = var_group.first;
+        OperatorRange var_range = var_group.second;
+
+        if (var == -1) {
+            children.push_back(compile_leaf(var_range, code, operators));
+        } else {
+            vector<pair<int, int>> values_and_children;
+            OperatorGrouper grouper_by_value(
+                operator_infos, depth, GroupOperatorsBy::VALUE, var_range);
+            while (!grouper_by_value.done()) {
+                auto value_group = grouper_by_value.next();
+                int value = value_group.first;
+                OperatorRange value_range = value_group.second;
+
+                values_and_children.emplace_back(
+                    value, compile_recursive(depth + 1, value_range, code, operators));
+            }
+
+            children.push_back(compile_switch(var, values_and_children, code));
+        }
+    }
+    return compile_fork(children, code);
+}
+
 static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
     vector<FactPair> precond;
     precond.reserve(op.get_preconditions().size());
@@ -280,7 +383,7 @@ static vector<FactPair> build_sorted_precondition(const OperatorProxy &op) {
     return precond;
 }
 
-GeneratorPtr SuccessorGeneratorFactory::create() {
+void SuccessorGeneratorFactory::init_operator_infos() {
     OperatorsProxy operators = task_proxy.get_operators();
     operator_infos.reserve(operators.size());
     for (OperatorProxy op : operators) {
@@ -290,10 +393,26 @@ GeneratorPtr SuccessorGeneratorFactory::create() {
     /* Use stable_sort rather than sort for reproducibility.
        This amounts to breaking ties by operator ID. */
     stable_sort(operator_infos.begin(), operator_infos.end());
+}
 
+GeneratorPtr SuccessorGeneratorFactory::create() {
+    init_operator_infos();
     OperatorRange full_range(0, operator_infos.size());
     GeneratorPtr root = construct_recursive(0, full_range);
     operator_infos.clear();
     return root;
 }
+
+unique_ptr<FlatGenerator> SuccessorGeneratorFactory::create_flat() {
+    init_operator_infos();
+    OperatorRange full_range(0, operator_infos.size());
+    vector<int> code;
+    vector<OperatorID> operators;
+    operators.reserve(operator_infos.size());
+    int root = compile_recursive(0, full_range, code, operators);
+    operator_infos.clear();
+    code.shrink_to_fit();
+    return utils::make_unique_ptr<FlatGenerator>(
+        move(code), move(operators), root);
+}
 }
@@ -4,9 +4,11 @@
 #include <memory>
 #include <vector>
 
+class OperatorID;
 class TaskProxy;
 
 namespace successor_generator {
+class FlatGenerator;
 class GeneratorBase;
 
 using GeneratorPtr = std::unique_ptr<GeneratorBase>;
@@ -26,11 +28,28 @@ class SuccessorGeneratorFactory {
     GeneratorPtr construct_switch(
         int switch_var_id, ValuesAndGenerators values_and_generators) const;
     GeneratorPtr construct_recursive(int depth, OperatorRange range) const;
+
+    /*
+      The compile_* methods mirror the construct_* methods but append
+      the nodes to the code of a FlatGenerator and return their position.
+    */
+    int compile_fork(const std::vector<int> &children,
+                     std::vector<int> &code) const;
+    int compile_leaf(OperatorRange range, std::vector<int> &code,
+                     std::vector<OperatorID> &operators) const;
+    int compile_switch(int switch_var_id,
+                       const std::vector<std::pair<int, int>> &values_and_children,
+                       std::vector<int> &code) const;
+    int compile_recursive(int depth, OperatorRange range, std::vector<int> &code,
+                          std::vector<OperatorID> &operators) const;
+
+    void init_operator_infos();
 public:
     explicit SuccessorGeneratorFactory(const TaskProxy &task_proxy);
     // Destructor cannot be implicit because OperatorInfo is forward-declared.
     ~SuccessorGeneratorFactory();
     GeneratorPtr create();
+    std::unique_ptr<FlatGenerator> create_flat();
 };
 }
 
@@ -1,7 +1,9 @@
 #include "successor_generator_internals.h"
 
+#include "../state_registry.h"
 #include "../task_proxy.h"
 
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -173,4 +175,119 @@ void GeneratorLeafSingle::generate_applicable_ops(
     const vector<int> &, vector<OperatorID> &applicable_ops) const {
     applicable_ops.push_back(applicable_operator);
 }
+
+namespace {
+class PackedStateValues {
+    const int_packer::IntPacker &state_packer;
+    const PackedStateBin *buffer;
+public:
+    PackedStateValues(const int_packer::IntPacker &state_packer,
+                      const PackedStateBin *buffer)
+        : state_packer(state_packer),
+          buffer(buffer) {
+    }
+
+    int operator()(int var) const {
+        return state_packer.get(buffer, var);
+    }
+};
+
+class UnpackedStateValues {
+    const vector<int> &values;
+public:
+    explicit UnpackedStateValues(const vector<int> &values)
+        : values(values) {
+    }
+
+    int operator()(int var) const {
+        return values[var];
+    }
+};
+}
+
+FlatGenerator::FlatGenerator(
+    vector<int> &&code, vector<OperatorID> &&operators, int root)
+    : code(move(code)),
+      operators(move(operators)),
+      root(root) {
+}
+
+template<typename StateValues>
+void FlatGenerator::generate(
+    const StateValues &values, vector<OperatorID> &applicable_ops) const {
+    /* Children of forks that remain to be visited. The buffer is reused
+       across calls to avoid an allocation per expansion. It is thread-local
+       so that the generator can be shared between threads. The buffer is
+       empty after each call because all open nodes are visited. */
+    static thread_local vector<int> open_nodes;
+    assert(open_nodes.empty());
+    int pos = root;
+    while (true) {
+        /* Follow a single path through the switches and continue with the
+           first child of forks, remembering the other children. */
+        while (pos != NO_NODE) {
+            const int *node = &code[pos];
+            switch (node[0]) {
+            case FORK: {
+                int num_children = node[1];
+                for (int i = num_children - 1; i > 0; --i) {
+                    open_nodes.push_back(node[2 + i]);
+                }
+                pos = node[2];
+                break;
+            }
+            case VECTOR_SWITCH:
+                pos = node[2 + values(node[1])];
+                break;
+            case SORTED_SWITCH: {
+                int value = values(node[1]);
+                int num_children = node[2];
+                const int *begin = node + 3;
+                int low = 0;
+                int high = num_children;
+                while (low < high) {
+                    int mid = (low + high) / 2;
+                    if (begin[2 * mid] < value)
+                        low = mid + 1;
+                    else
+                        high = mid;
+                }
+                if (low < num_children && begin[2 * low] == value)
+                    pos = begin[2 * low + 1];
+                else
+                    pos = NO_NODE;
+                break;
+            }
+            case SINGLE_SWITCH:
+                pos = (values(node[1]) == node[2]) ? node[3] : NO_NODE;
+                break;
+            case LEAF:
+                for (int i = node[1]; i < node[2]; ++i) {
+                    applicable_ops.push_back(operators[i]);
+                }
+                pos = NO_NODE;
+                break;
+            default:
+                assert(false);
+                pos = NO_NODE;
+            }
+        }
+        if (open_nodes.empty())
+            break;
+        pos = open_nodes.back();
+        open_nodes.pop_back();
+    }
+}
+
+void FlatGenerator::generate_applicable_ops(
+    const State &state, vector<OperatorID> &applicable_ops) const {
+    const StateRegistry *registry = state.get_registry();
+    if (registry) {
+        generate(PackedStateValues(registry->get_state_packer(), state.get_buffer()),
+                 applicable_ops);
+    } else {
+        state.unpack();
+        generate(UnpackedStateValues(state.get_unpacked_values()), applicable_ops);
+    }
+}
 }
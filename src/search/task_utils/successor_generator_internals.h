@@ -86,6 +86,52 @@ public:
     virtual void generate_applicable_ops(
         const std::vector<int> &state, std::vector<OperatorID> &applicable_ops) const override;
 };
+
+// Marks missing children in a FlatGenerator.
+const int NO_NODE = -1;
+
+/*
+  Successor generator compiled into a single "byte-code" vector of ints
+  as sketched in the notes in successor_generator_internals.cc. Nodes are
+  identified by their position in the vector and have the forms
+
+  - fork:          [FORK, n, child_1, ..., child_n]
+  - vector switch: [VECTOR_SWITCH, var_id, child_0, ..., child_{k-1}]
+  - sorted switch: [SORTED_SWITCH, var_id, n, value_1, child_1, ...,
+                    value_n, child_n] with increasing values
+  - single switch: [SINGLE_SWITCH, var_id, value, child]
+  - leaf:          [LEAF, begin, end]
+
+  where missing children are NO_NODE and leaves refer to a range of the
+  shared operator vector. The generator is evaluated iteratively and
+  reads registered states directly from their packed buffer, so states
+  do not have to be unpacked.
+*/
+class FlatGenerator {
+public:
+    enum NodeType {
+        FORK,
+        VECTOR_SWITCH,
+        SORTED_SWITCH,
+        SINGLE_SWITCH,
+        LEAF
+    };
+private:
+    std::vector<int> code;
+    std::vector<OperatorID> operators;
+    int root;
+
+    template<typename StateValues>
+    void generate(const StateValues &values,
+                  std::vector<OperatorID> &applicable_ops) const;
+public:
+    FlatGenerator(std::vector<int> &&code,
+                  std::vector<OperatorID> &&operators,
+                  int root);
+
+    void generate_applicable_ops(
+        const State &state, std::vector<OperatorID> &applicable_ops) const;
+};
 }
 
 #endif
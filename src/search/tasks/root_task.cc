@@ -5,31 +5,80 @@
 #include "../state_registry.h"
 
 #include "../utils/collections.h"
+#include "../utils/memory.h"
+#include "../utils/system.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <fstream>
+#include <iterator>
 #include <memory>
 #include <set>
 #include <unordered_set>
 #include <vector>
 
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 using namespace std;
 using utils::ExitCode;
 
 namespace tasks {
 static const int PRE_FILE_VERSION = 3;
+/*
+  The binary task format starts with a magic string whose first character
+  can never start a translator output file. This allows us to detect the
+  format by peeking at the first character of the input.
+*/
+static const char BINARY_MAGIC[8] = {'\x7f', 'F', 'D', 'T', 'A', 'S', 'K', '\0'};
+static const int BINARY_FILE_VERSION = 2;
+static const int BINARY_BYTE_ORDER_MARK = 0x01020304;
 shared_ptr<AbstractTask> g_root_task = nullptr;
 
+class BinaryTaskReader;
+
+/*
+  Names of variables, facts and operators are only needed for output.
+  When the task is loaded from a binary task file, we only remember where
+  a name is stored in the file and construct the string on demand.
+*/
+class LazyName {
+    string name;
+    const char *data;
+    int length;
+public:
+    LazyName()
+        : data(nullptr), length(0) {
+    }
+
+    explicit LazyName(string &&name)
+        : name(move(name)), data(nullptr), length(0) {
+    }
+
+    LazyName(const char *data, int length)
+        : data(data), length(length) {
+    }
+
+    string str() const {
+        return data ? string(data, length) : name;
+    }
+};
+
 struct ExplicitVariable {
     int domain_size;
-    string name;
-    vector<std::string> fact_names;
+    LazyName name;
+    vector<LazyName> fact_names;
     int axiom_layer;
     int axiom_default_value;
 
     explicit ExplicitVariable(istream &in);
+    explicit ExplicitVariable(BinaryTaskReader &in);
 };
 
 
@@ -45,11 +94,68 @@ struct ExplicitOperator {
     vector<FactPair> preconditions;
     vector<ExplicitEffect> effects;
     int cost;
-    string name;
+    LazyName name;
     bool is_an_axiom;
 
     void read_pre_post(istream &in);
     ExplicitOperator(istream &in, bool is_an_axiom, bool use_metric);
+    ExplicitOperator(BinaryTaskReader &in, bool is_an_axiom);
+};
+
+
+/*
+  Memory holding the contents of a binary task file. If possible, the file
+  is memory-mapped, otherwise its contents are copied into a buffer. The
+  task keeps this object alive because names are read from it lazily.
+*/
+class BinaryTaskFile {
+    string buffer;
+    void *mapped_data;
+    size_t mapped_size;
+public:
+    explicit BinaryTaskFile(istream &in);
+    ~BinaryTaskFile();
+    BinaryTaskFile(const BinaryTaskFile &) = delete;
+    BinaryTaskFile &operator=(const BinaryTaskFile &) = delete;
+
+    const char *get_data() const;
+    size_t get_size() const;
+};
+
+
+class BinaryTaskReader {
+    const char *begin;
+    const char *pos;
+    const char *end;
+
+    void check_available(size_t num_bytes) const;
+    void read_bytes(void *target, size_t num_bytes);
+public:
+    explicit BinaryTaskReader(const BinaryTaskFile &file);
+
+    void read_header();
+    int read_int();
+    int read_count();
+    LazyName read_name();
+    string read_string();
+    vector<FactPair> read_facts();
+    vector<int> read_numbers();
+    vector<string> read_strings();
+};
+
+
+class BinaryTaskWriter {
+    ostream &out;
+public:
+    explicit BinaryTaskWriter(ostream &out);
+
+    void write_header();
+    void write_int(int value);
+    void write_string(const string &str);
+    void write_facts(const vector<FactPair> &facts);
+    void write_numbers(const vector<int> &numbers);
+    void write_strings(const vector<string> &strings);
+    void write_operator(const ExplicitOperator &op);
 };
 
 
@@ -64,6 +170,7 @@ class RootTask : public AbstractTask {
     vector<FactPair> hard_goals;
     vector<FactPair> soft_goals;
     vector<RelaxedTaskDefinition> relaxed_tasks;
+    unique_ptr<BinaryTaskFile> binary_file;
 
     const ExplicitVariable &get_variable(int var) const;
     const ExplicitEffect &get_effect(int op_id, int effect_id, bool is_axiom) const;
@@ -71,6 +178,9 @@ class RootTask : public AbstractTask {
 
 public:
     explicit RootTask(istream &in);
+    explicit RootTask(unique_ptr<BinaryTaskFile> binary_file);
+
+    void write_binary(ostream &out) const;
 
     virtual int get_num_variables() const override;
     virtual string get_variable_name(int var) const override;
@@ -201,13 +311,18 @@ vector<std::string> read_strings(istream &in) {
 
 ExplicitVariable::ExplicitVariable(istream &in) {
     check_magic(in, "begin_variable");
-    in >> name;
+    string variable_name;
+    in >> variable_name;
+    name = LazyName(move(variable_name));
     in >> axiom_layer;
     in >> domain_size;
     in >> ws;
-    fact_names.resize(domain_size);
-    for (int i = 0; i < domain_size; ++i)
-        getline(in, fact_names[i]);
+    fact_names.reserve(domain_size);
+    for (int i = 0; i < domain_size; ++i) {
+        string fact_name;
+        getline(in, fact_name);
+        fact_names.emplace_back(move(fact_name));
+    }
     check_magic(in, "end_variable");
 }
 
@@ -233,7 +348,9 @@ ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metri
     if (!is_an_axiom) {
         check_magic(in, "begin_operator");
         in >> ws;
-        getline(in, name);
+        string op_name;
+        getline(in, op_name);
+        name = LazyName(move(op_name));
         preconditions = read_facts(in);
         int count;
         in >> count;
@@ -247,7 +364,7 @@ ExplicitOperator::ExplicitOperator(istream &in, bool is_an_axiom, bool use_metri
         cost = use_metric ? op_cost : 1;
         check_magic(in, "end_operator");
     } else {
-        name = "<axiom>";
+        name = LazyName("<axiom>");
         cost = 0;
         check_magic(in, "begin_rule");
         read_pre_post(in);
@@ -459,6 +576,389 @@ RootTask::RootTask(istream &in) {
     axiom_evaluator.evaluate(initial_state_values);
 }
 
+BinaryTaskFile::BinaryTaskFile(istream &in)
+    : mapped_data(nullptr), mapped_size(0) {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    /*
+      The driver redirects the task file to stdin. If stdin is a regular
+      file, we map the complete file instead of copying its contents.
+    */
+    if (&in == &cin) {
+        struct stat file_status;
+        if (fstat(STDIN_FILENO, &file_status) == 0 &&
+            S_ISREG(file_status.st_mode) && file_status.st_size > 0) {
+            void *data = mmap(nullptr, file_status.st_size, PROT_READ,
+                              MAP_PRIVATE, STDIN_FILENO, 0);
+            if (data != MAP_FAILED) {
+                mapped_data = data;
+                mapped_size = file_status.st_size;
+                return;
+            }
+        }
+    }
+#endif
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+}
+
+BinaryTaskFile::~BinaryTaskFile() {
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+    if (mapped_data) {
+        munmap(mapped_data, mapped_size);
+    }
+#endif
+}
+
+const char *BinaryTaskFile::get_data() const {
+    return mapped_data ? static_cast<const char *>(mapped_data) : buffer.data();
+}
+
+size_t BinaryTaskFile::get_size() const {
+    return mapped_data ? mapped_size : buffer.size();
+}
+
+
+static size_t get_padded_length(int length) {
+    // Strings are padded to keep all integers in the file aligned.
+    return (static_cast<size_t>(length) + sizeof(int) - 1) / sizeof(int) * sizeof(int);
+}
+
+BinaryTaskReader::BinaryTaskReader(const BinaryTaskFile &file)
+    : begin(file.get_data()),
+      pos(begin),
+      end(begin + file.get_size()) {
+}
+
+void BinaryTaskReader::check_available(size_t num_bytes) const {
+    if (static_cast<size_t>(end - pos) < num_bytes) {
+        cerr << "Unexpected end of binary task file at byte "
+             << pos - begin << "." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+void BinaryTaskReader::read_bytes(void *target, size_t num_bytes) {
+    check_available(num_bytes);
+    memcpy(target, pos, num_bytes);
+    pos += num_bytes;
+}
+
+void BinaryTaskReader::read_header() {
+    check_available(sizeof(BINARY_MAGIC));
+    if (memcmp(pos, BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0) {
+        cerr << "Failed to match magic string of binary task file." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    pos += sizeof(BINARY_MAGIC);
+    if (read_int() != BINARY_BYTE_ORDER_MARK) {
+        cerr << "Binary task file was written on a machine with "
+             << "different byte order." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    int version = read_int();
+    if (version != BINARY_FILE_VERSION) {
+        cerr << "Expected binary task file version " << BINARY_FILE_VERSION
+             << ", got " << version << "." << endl
+             << "Exiting." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+int BinaryTaskReader::read_int() {
+    int value;
+    read_bytes(&value, sizeof(int));
+    return value;
+}
+
+int BinaryTaskReader::read_count() {
+    int count = read_int();
+    if (count < 0) {
+        cerr << "Invalid count in binary task file: " << count << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    return count;
+}
+
+LazyName BinaryTaskReader::read_name() {
+    int length = read_count();
+    size_t padded_length = get_padded_length(length);
+    check_available(padded_length);
+    LazyName name(pos, length);
+    pos += padded_length;
+    return name;
+}
+
+string BinaryTaskReader::read_string() {
+    return read_name().str();
+}
+
+vector<FactPair> BinaryTaskReader::read_facts() {
+    static_assert(sizeof(FactPair) == 2 * sizeof(int),
+                  "FactPair must consist of exactly two ints.");
+    int count = read_count();
+    // Check the size before allocating memory for a corrupted count.
+    check_available(count * sizeof(FactPair));
+    vector<FactPair> facts(count, FactPair::no_fact);
+    read_bytes(facts.data(), count * sizeof(FactPair));
+    return facts;
+}
+
+vector<int> BinaryTaskReader::read_numbers() {
+    int count = read_count();
+    check_available(count * sizeof(int));
+    vector<int> numbers(count);
+    read_bytes(numbers.data(), count * sizeof(int));
+    return numbers;
+}
+
+vector<string> BinaryTaskReader::read_strings() {
+    int count = read_count();
+    vector<string> strings;
+    strings.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        strings.push_back(read_string());
+    }
+    return strings;
+}
+
+
+BinaryTaskWriter::BinaryTaskWriter(ostream &out)
+    : out(out) {
+}
+
+void BinaryTaskWriter::write_header() {
+    out.write(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    write_int(BINARY_BYTE_ORDER_MARK);
+    write_int(BINARY_FILE_VERSION);
+}
+
+void BinaryTaskWriter::write_int(int value) {
+    out.write(reinterpret_cast<const char *>(&value), sizeof(int));
+}
+
+void BinaryTaskWriter::write_string(const string &str) {
+    int length = str.size();
+    write_int(length);
+    out.write(str.data(), length);
+    static const char padding[sizeof(int)] = {};
+    out.write(padding, get_padded_length(length) - length);
+}
+
+void BinaryTaskWriter::write_facts(const vector<FactPair> &facts) {
+    write_int(facts.size());
+    out.write(reinterpret_cast<const char *>(facts.data()),
+              facts.size() * sizeof(FactPair));
+}
+
+void BinaryTaskWriter::write_numbers(const vector<int> &numbers) {
+    write_int(numbers.size());
+    out.write(reinterpret_cast<const char *>(numbers.data()),
+              numbers.size() * sizeof(int));
+}
+
+void BinaryTaskWriter::write_strings(const vector<string> &strings) {
+    write_int(strings.size());
+    for (const string &str : strings) {
+        write_string(str);
+    }
+}
+
+void BinaryTaskWriter::write_operator(const ExplicitOperator &op) {
+    write_string(op.name.str());
+    write_int(op.cost);
+    write_facts(op.preconditions);
+    write_int(op.effects.size());
+    for (const ExplicitEffect &effect : op.effects) {
+        write_int(effect.fact.var);
+        write_int(effect.fact.value);
+        write_facts(effect.conditions);
+    }
+}
+
+
+ExplicitVariable::ExplicitVariable(BinaryTaskReader &in) {
+    name = in.read_name();
+    axiom_layer = in.read_int();
+    domain_size = in.read_count();
+    fact_names.reserve(domain_size);
+    for (int i = 0; i < domain_size; ++i) {
+        fact_names.push_back(in.read_name());
+    }
+}
+
+ExplicitOperator::ExplicitOperator(BinaryTaskReader &in, bool is_an_axiom)
+    : is_an_axiom(is_an_axiom) {
+    name = in.read_name();
+    cost = in.read_int();
+    preconditions = in.read_facts();
+    int count = in.read_count();
+    effects.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        int var = in.read_int();
+        int value = in.read_int();
+        effects.emplace_back(var, value, in.read_facts());
+    }
+    if (cost < 0) {
+        cerr << "Invalid operator cost in binary task file: " << cost << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+}
+
+RelaxedTaskDefinition read_relaxed_task(BinaryTaskReader &in) {
+    int id = in.read_int();
+    string name = in.read_string();
+    vector<FactPair> init = in.read_facts();
+
+    int count = in.read_count();
+    vector<ApplicableActionDefinition> appls;
+    appls.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        string appl_name = in.read_string();
+        vector<string> params = in.read_strings();
+        int param_id = in.read_int();
+        int lower_bound = in.read_int();
+        int upper_bound = in.read_int();
+        appls.emplace_back(appl_name, params, param_id, lower_bound, upper_bound);
+    }
+
+    vector<int> lower_cover = in.read_numbers();
+    vector<int> upper_cover = in.read_numbers();
+
+    RelaxedTaskDefinition def(id, name, init, lower_cover, upper_cover);
+    def.applicable_actions = move(appls);
+    return def;
+}
+
+vector<ExplicitOperator> read_actions(
+    BinaryTaskReader &in, bool is_axiom,
+    const vector<ExplicitVariable> &variables) {
+    int count = in.read_count();
+    vector<ExplicitOperator> actions;
+    actions.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        actions.emplace_back(in, is_axiom);
+        check_facts(actions.back(), variables);
+    }
+    return actions;
+}
+
+RootTask::RootTask(unique_ptr<BinaryTaskFile> file)
+    : binary_file(move(file)) {
+    BinaryTaskReader in(*binary_file);
+    in.read_header();
+
+    int num_variables = in.read_count();
+    variables.reserve(num_variables);
+    for (int i = 0; i < num_variables; ++i) {
+        variables.emplace_back(in);
+    }
+
+    /*
+      The mutexes of each fact are stored in sorted order, so inserting
+      them into the sets takes amortized constant time per fact.
+    */
+    mutexes.resize(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        int domain_size = variables[var].domain_size;
+        mutexes[var].resize(domain_size);
+        for (int value = 0; value < domain_size; ++value) {
+            vector<FactPair> mutex_facts = in.read_facts();
+            check_facts(mutex_facts, variables);
+            mutexes[var][value].insert(mutex_facts.begin(), mutex_facts.end());
+        }
+    }
+
+    initial_state_values = in.read_numbers();
+    if (static_cast<int>(initial_state_values.size()) != num_variables) {
+        cerr << "Initial state in binary task file has "
+             << initial_state_values.size() << " values, expected "
+             << num_variables << "." << endl;
+        utils::exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    for (int i = 0; i < num_variables; ++i) {
+        variables[i].axiom_default_value = initial_state_values[i];
+    }
+
+    goals = in.read_facts();
+    hard_goals = in.read_facts();
+    soft_goals = in.read_facts();
+    int num_relaxed_tasks = in.read_count();
+    relaxed_tasks.reserve(num_relaxed_tasks);
+    for (int i = 0; i < num_relaxed_tasks; ++i) {
+        relaxed_tasks.push_back(read_relaxed_task(in));
+    }
+
+    check_facts(goals, variables);
+    operators = read_actions(in, false, variables);
+    axioms = read_actions(in, true, variables);
+
+    // See the HACK note in the constructor for the translator output.
+    AxiomEvaluator &axiom_evaluator = g_axiom_evaluators[TaskProxy(*this)];
+    axiom_evaluator.evaluate(initial_state_values);
+}
+
+void RootTask::write_binary(ostream &out) const {
+    BinaryTaskWriter writer(out);
+    writer.write_header();
+
+    writer.write_int(variables.size());
+    for (const ExplicitVariable &var : variables) {
+        writer.write_string(var.name.str());
+        writer.write_int(var.axiom_layer);
+        writer.write_int(var.domain_size);
+        for (const LazyName &fact_name : var.fact_names) {
+            writer.write_string(fact_name.str());
+        }
+    }
+
+    for (const vector<set<FactPair>> &var_mutexes : mutexes) {
+        for (const set<FactPair> &fact_mutexes : var_mutexes) {
+            writer.write_facts(
+                vector<FactPair>(fact_mutexes.begin(), fact_mutexes.end()));
+        }
+    }
+
+    /*
+      Like the translator output, we store the initial state before
+      evaluating the axioms: its values of derived variables are their
+      default values, which the reader restores from it.
+    */
+    vector<int> initial_state_before_axioms;
+    initial_state_before_axioms.reserve(variables.size());
+    for (const ExplicitVariable &var : variables) {
+        initial_state_before_axioms.push_back(var.axiom_default_value);
+    }
+    writer.write_numbers(initial_state_before_axioms);
+    writer.write_facts(goals);
+    writer.write_facts(hard_goals);
+    writer.write_facts(soft_goals);
+
+    writer.write_int(relaxed_tasks.size());
+    for (const RelaxedTaskDefinition &def : relaxed_tasks) {
+        writer.write_int(def.id);
+        writer.write_string(def.name);
+        writer.write_facts(def.init);
+        writer.write_int(def.applicable_actions.size());
+        for (const ApplicableActionDefinition &appl : def.applicable_actions) {
+            writer.write_string(appl.name);
+            writer.write_strings(appl.params);
+            writer.write_int(appl.param_id);
+            writer.write_int(appl.lower_bound);
+            writer.write_int(appl.upper_bound);
+        }
+        writer.write_numbers(def.lower_cover);
+        writer.write_numbers(def.upper_cover);
+    }
+
+    writer.write_int(operators.size());
+    for (const ExplicitOperator &op : operators) {
+        writer.write_operator(op);
+    }
+    writer.write_int(axioms.size());
+    for (const ExplicitOperator &axiom : axioms) {
+        writer.write_operator(axiom);
+    }
+}
+
 const ExplicitVariable &RootTask::get_variable(int var) const {
     assert(utils::in_bounds(var, variables));
     return variables[var];
@@ -487,7 +987,7 @@ int RootTask::get_num_variables() const {
 }
 
 string RootTask::get_variable_name(int var) const {
-    return get_variable(var).name;
+    return get_variable(var).name.str();
 }
 
 int RootTask::get_variable_domain_size(int var) const {
@@ -504,7 +1004,7 @@ int RootTask::get_variable_default_axiom_value(int var) const {
 
 string RootTask::get_fact_name(const FactPair &fact) const {
     assert(utils::in_bounds(fact.value, get_variable(fact.var).fact_names));
-    return get_variable(fact.var).fact_names[fact.value];
+    return get_variable(fact.var).fact_names[fact.value].str();
 }
 
 bool RootTask::are_facts_mutex(const FactPair &fact1, const FactPair &fact2) const {
@@ -522,7 +1022,7 @@ int RootTask::get_operator_cost(int index, bool is_axiom) const {
 }
 
 string RootTask::get_operator_name(int index, bool is_axiom) const {
-    return get_operator_or_axiom(index, is_axiom).name;
+    return get_operator_or_axiom(index, is_axiom).name.str();
 }
 
 int RootTask::get_num_operators() const {
@@ -616,7 +1116,22 @@ void RootTask::convert_ancestor_state_values(
 
 void read_root_task(istream &in) {
     assert(!g_root_task);
-    g_root_task = make_shared<RootTask>(in);
+    if (in.peek() == BINARY_MAGIC[0]) {
+        g_root_task = make_shared<RootTask>(
+            utils::make_unique_ptr<BinaryTaskFile>(in));
+    } else {
+        g_root_task = make_shared<RootTask>(in);
+    }
+}
+
+void write_binary_root_task(const string &filename) {
+    assert(g_root_task);
+    ofstream out(filename, ios::binary);
+    if (!out) {
+        cerr << "Could not open binary task file " << filename << endl;
+        utils::exit_with(ExitCode::SEARCH_CRITICAL_ERROR);
+    }
+    static_cast<const RootTask &>(*g_root_task).write_binary(out);
 }
 
 static shared_ptr<AbstractTask> _parse(OptionParser &parser) {
@@ -5,6 +5,11 @@
 
 namespace tasks {
 extern std::shared_ptr<AbstractTask> g_root_task;
+/*
+  Read the root task from the translator output or from a binary task file
+  written by write_binary_root_task. The format is detected automatically.
+*/
 extern void read_root_task(std::istream &in);
+extern void write_binary_root_task(const std::string &filename);
 }
 #endif
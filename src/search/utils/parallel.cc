@@ -0,0 +1,38 @@
+#include "parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace utils {
+void run_in_parallel(
+    int num_jobs, int num_threads, const function<void(int)> &job) {
+    num_threads = min(num_threads, num_jobs);
+    if (num_threads <= 1) {
+        for (int i = 0; i < num_jobs; ++i) {
+            job(i);
+        }
+        return;
+    }
+
+    atomic<int> next_job(0);
+    auto run_jobs = [&]() {
+            for (int i = next_job++; i < num_jobs; i = next_job++) {
+                job(i);
+            }
+        };
+    vector<thread> threads;
+    threads.reserve(num_threads - 1);
+    for (int i = 0; i < num_threads - 1; ++i) {
+        threads.emplace_back(run_jobs);
+    }
+    // The calling thread works as well.
+    run_jobs();
+    for (thread &worker_thread : threads) {
+        worker_thread.join();
+    }
+}
+}
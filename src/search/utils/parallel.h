@@ -0,0 +1,19 @@
+#ifndef UTILS_PARALLEL_H
+#define UTILS_PARALLEL_H
+
+#include <functional>
+
+namespace utils {
+/*
+  Call job(i) for all i in [0, num_jobs) on up to num_threads threads. The
+  jobs are handed out in increasing order, but may finish in any order.
+  With one thread (or at most one job), all jobs run in the calling thread.
+
+  Jobs must not throw exceptions and may only share data that is not
+  modified while the jobs run.
+*/
+extern void run_in_parallel(
+    int num_jobs, int num_threads, const std::function<void(int)> &job);
+}
+
+#endif
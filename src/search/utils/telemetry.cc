@@ -0,0 +1,90 @@
+#include "telemetry.h"
+
+#include "system.h"
+
+#include <cassert>
+#include <iostream>
+
+using namespace std;
+
+namespace utils {
+Telemetry g_telemetry;
+
+static void write_json_string(ostream &out, const string &value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << ' ';
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+static double to_seconds(chrono::steady_clock::duration duration) {
+    return chrono::duration<double>(duration).count();
+}
+
+Telemetry::Telemetry()
+    : enabled(false),
+      interval(0),
+      num_calls_until_clock_check(1) {
+}
+
+void Telemetry::enable(const string &filename, double interval_in_seconds) {
+    if (enabled) {
+        // Nested search engines keep writing to the first file.
+        return;
+    }
+    file.open(filename);
+    if (!file) {
+        cerr << "error: could not open telemetry file " << filename << endl;
+        exit_with(ExitCode::SEARCH_INPUT_ERROR);
+    }
+    enabled = true;
+    start_time = Clock::now();
+    interval = chrono::duration_cast<Clock::duration>(
+        chrono::duration<double>(interval_in_seconds));
+    next_sample_time = start_time;
+    num_calls_until_clock_check = 1;
+}
+
+TelemetryComponent &Telemetry::get_component(const string &name) {
+    for (TelemetryComponent &component : components) {
+        if (component.name == name) {
+            return component;
+        }
+    }
+    components.emplace_back(name);
+    return components.back();
+}
+
+void Telemetry::write_sample(const vector<pair<string, int64_t>> &counters) {
+    assert(enabled);
+    Clock::time_point now = Clock::now();
+    next_sample_time = now + interval;
+
+    file << "{\"time\": " << to_seconds(now - start_time)
+         << ", \"peak_memory_kb\": " << get_peak_memory_in_kb();
+    for (const pair<string, int64_t> &counter : counters) {
+        file << ", ";
+        write_json_string(file, counter.first);
+        file << ": " << counter.second;
+    }
+    file << ", \"components\": {";
+    bool first = true;
+    for (const TelemetryComponent &component : components) {
+        if (!first) {
+            file << ", ";
+        }
+        first = false;
+        write_json_string(file, component.name);
+        file << ": {\"calls\": " << component.num_calls
+             << ", \"time\": " << to_seconds(component.time) << "}";
+    }
+    file << "}}" << endl;
+}
+}
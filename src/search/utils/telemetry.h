@@ -0,0 +1,124 @@
+#ifndef UTILS_TELEMETRY_H
+#define UTILS_TELEMETRY_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils {
+/*
+  Accumulated number of calls and time of a component (e.g., successor
+  generation or an evaluator).
+*/
+struct TelemetryComponent {
+    const std::string name;
+    int64_t num_calls;
+    std::chrono::steady_clock::duration time;
+
+    explicit TelemetryComponent(const std::string &name)
+        : name(name), num_calls(0), time(0) {
+    }
+};
+
+/*
+  Writes machine-readable samples of search counters, component timers and
+  the peak memory usage to a file with one JSON object per line.
+
+  Telemetry is disabled by default. Instrumented code holds a
+  TelemetryHandle for its component and measures its time with
+  TelemetryTimer, which does nothing while telemetry is disabled. Samples are written by calling
+  is_sample_due() at a frequently reached point (e.g., after each search
+  step) and write_sample() if it returns true. Telemetry is not thread-safe.
+*/
+class Telemetry {
+    using Clock = std::chrono::steady_clock;
+
+    bool enabled;
+    // Components are never removed, so references to them stay valid.
+    std::deque<TelemetryComponent> components;
+    std::ofstream file;
+    Clock::time_point start_time;
+    Clock::duration interval;
+    Clock::time_point next_sample_time;
+    int num_calls_until_clock_check;
+public:
+    Telemetry();
+
+    bool is_enabled() const {
+        return enabled;
+    }
+
+    // Start writing samples at the given interval (in seconds).
+    void enable(const std::string &filename, double interval_in_seconds);
+
+    // Return the component with the given name and create it if necessary.
+    TelemetryComponent &get_component(const std::string &name);
+
+    /*
+      Return true if the sampling interval has passed since the last sample.
+      To keep the overhead low, only every 128th call looks at the clock.
+    */
+    bool is_sample_due() {
+        if (--num_calls_until_clock_check > 0) {
+            return false;
+        }
+        num_calls_until_clock_check = 128;
+        return Clock::now() >= next_sample_time;
+    }
+
+    void write_sample(const std::vector<std::pair<std::string, int64_t>> &counters);
+};
+
+extern Telemetry g_telemetry;
+
+/*
+  Refers to the component with the given name. The component is only
+  registered on first use, so components of objects that are created
+  before telemetry is enabled (e.g., evaluators) are not missed and
+  nothing is registered while telemetry is disabled.
+*/
+class TelemetryHandle {
+    std::string name;
+    TelemetryComponent *component;
+public:
+    explicit TelemetryHandle(const std::string &name)
+        : name(name), component(nullptr) {
+    }
+
+    TelemetryComponent &get() {
+        if (!component) {
+            component = &g_telemetry.get_component(name);
+        }
+        return *component;
+    }
+};
+
+// Add the time until destruction to the given component if telemetry is enabled.
+class TelemetryTimer {
+    TelemetryComponent *component;
+    std::chrono::steady_clock::time_point start;
+public:
+    explicit TelemetryTimer(TelemetryHandle &handle)
+        : component(g_telemetry.is_enabled() ? &handle.get() : nullptr) {
+        if (component) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~TelemetryTimer() {
+        if (component) {
+            component->time += std::chrono::steady_clock::now() - start;
+            ++component->num_calls;
+        }
+    }
+
+    TelemetryTimer(const TelemetryTimer &) = delete;
+    TelemetryTimer &operator=(const TelemetryTimer &) = delete;
+};
+}
+
+#endif
@@ -0,0 +1,354 @@
+#include "cost_partitioning_goal_subset_heuristic.h"
+
+#include "msgs_evaluation_context.h"
+
+#include "../../option_parser.h"
+#include "../../plugin.h"
+
+#include "../../cegar/abstract_search.h"
+#include "../../cegar/abstraction.h"
+#include "../../cegar/cegar.h"
+#include "../../cegar/refinement_hierarchy.h"
+#include "../../cegar/transition.h"
+#include "../../cegar/transition_system.h"
+#include "../../task_utils/task_properties.h"
+#include "../../tasks/modified_goals_task.h"
+#include "../../utils/countdown_timer.h"
+#include "../../utils/logging.h"
+#include "../../utils/memory.h"
+#include "../../utils/rng.h"
+#include "../../utils/rng_options.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+using namespace goalsubset;
+using cegar::INF;
+
+namespace cost_partitioning_goal_subset_heuristic {
+static vector<int> compute_saturated_costs(
+    const GoalAbstraction &abstraction, const vector<int> &h_values,
+    int num_operators) {
+    vector<int> saturated_costs(num_operators, 0);
+    int num_states = h_values.size();
+    for (int state_id = 0; state_id < num_states; ++state_id) {
+        int h = h_values[state_id];
+        if (h == INF)
+            continue;
+        for (const cegar::Transition &transition :
+             abstraction.incoming_transitions[state_id]) {
+            // For incoming transitions, target_id is the source state.
+            int src_h = h_values[transition.target_id];
+            if (src_h == INF)
+                continue;
+            int needed = src_h - h;
+            saturated_costs[transition.op_id] =
+                max(saturated_costs[transition.op_id], needed);
+        }
+    }
+    return saturated_costs;
+}
+
+CostPartitioningGoalSubsetHeuristic::CostPartitioningGoalSubsetHeuristic(
+    const options::Options &opts)
+    : Heuristic(opts),
+      max_cached_partitionings(opts.get<int>("max_cached_partitionings")),
+      candidates_msgs(nullptr),
+      candidates_msgs_version(-1),
+      num_pruned_by_partitioning(0),
+      num_uncached_candidates(0) {
+    log << "--> cost partitioning goal subset heuristic" << endl;
+
+    task_properties::verify_no_axioms(task_proxy);
+    task_properties::verify_no_conditional_effects(task_proxy);
+
+    // Use the same goal order as MSGSCollection.
+    if (task_proxy.get_hard_goals().size() == 0) {
+        soft_goal_list = task_properties::get_fact_pairs(task_proxy.get_goals());
+    } else {
+        hard_goal_list = task_properties::get_fact_pairs(task_proxy.get_hard_goals());
+        soft_goal_list = task_properties::get_fact_pairs(task_proxy.get_soft_goals());
+    }
+    sort(hard_goal_list.begin(), hard_goal_list.end());
+    sort(soft_goal_list.begin(), soft_goal_list.end());
+
+    operator_costs = task_properties::get_operator_costs(task_proxy);
+    build_abstractions(opts);
+}
+
+CostPartitioningGoalSubsetHeuristic::~CostPartitioningGoalSubsetHeuristic() {
+}
+
+void CostPartitioningGoalSubsetHeuristic::build_abstractions(
+    const options::Options &opts) {
+    shared_ptr<utils::RandomNumberGenerator> rng =
+        utils::parse_rng_from_options(opts);
+    int max_states = opts.get<int>("max_states");
+    int max_transitions = opts.get<int>("max_transitions");
+    utils::CountdownTimer timer(opts.get<double>("max_time"));
+
+    vector<FactPair> goal_facts = hard_goal_list;
+    goal_facts.insert(goal_facts.end(), soft_goal_list.begin(), soft_goal_list.end());
+
+    int num_states = 0;
+    int num_transitions = 0;
+    int rem_goals = goal_facts.size();
+    for (const FactPair &goal : goal_facts) {
+        shared_ptr<AbstractTask> subtask =
+            make_shared<extra_tasks::ModifiedGoalsTask>(
+                task, vector<FactPair> {goal});
+        cegar::CEGAR cegar(
+            subtask,
+            max(1, (max_states - num_states) / rem_goals),
+            max(1, (max_transitions - num_transitions) / rem_goals),
+            timer.get_remaining_time() / rem_goals,
+            opts.get<cegar::PickSplit>("pick"),
+            *rng,
+            log);
+        unique_ptr<cegar::Abstraction> abstraction = cegar.extract_abstraction();
+        const cegar::TransitionSystem &ts = abstraction->get_transition_system();
+        num_states += abstraction->get_num_states();
+        num_transitions += ts.get_num_non_loops();
+
+        GoalAbstraction goal_abstraction;
+        goal_abstraction.incoming_transitions = ts.get_incoming_transitions();
+        goal_abstraction.goals = abstraction->get_goals();
+        goal_abstraction.h_values = cegar::compute_distances(
+            goal_abstraction.incoming_transitions, operator_costs,
+            goal_abstraction.goals);
+        goal_abstraction.refinement_hierarchy =
+            abstraction->extract_refinement_hierarchy();
+        abstractions.push_back(move(goal_abstraction));
+        --rem_goals;
+    }
+
+    log << "Goal abstractions built: " << abstractions.size() << endl;
+    log << "Abstract states: " << num_states << endl;
+    log << "Non-looping transitions: " << num_transitions << endl;
+}
+
+unique_ptr<CostPartitioning>
+CostPartitioningGoalSubsetHeuristic::compute_cost_partitioning(
+    const vector<int> &abstraction_ids) const {
+    unique_ptr<CostPartitioning> partitioning =
+        utils::make_unique_ptr<CostPartitioning>();
+    partitioning->abstraction_ids = abstraction_ids;
+    vector<int> remaining_costs = operator_costs;
+    int num_operators = remaining_costs.size();
+    for (int id : abstraction_ids) {
+        const GoalAbstraction &abstraction = abstractions[id];
+        vector<int> h_values = cegar::compute_distances(
+            abstraction.incoming_transitions, remaining_costs,
+            abstraction.goals);
+        vector<int> saturated_costs = compute_saturated_costs(
+            abstraction, h_values, num_operators);
+        for (int op_id = 0; op_id < num_operators; ++op_id) {
+            assert(saturated_costs[op_id] <= remaining_costs[op_id]);
+            remaining_costs[op_id] -= saturated_costs[op_id];
+        }
+        partitioning->h_values.push_back(move(h_values));
+    }
+    return partitioning;
+}
+
+const CostPartitioning *CostPartitioningGoalSubsetHeuristic::get_cost_partitioning(
+    const GoalSubset &candidate) {
+    vector<int> abstraction_ids;
+    int num_hard_goals = hard_goal_list.size();
+    for (int i = 0; i < num_hard_goals; ++i) {
+        abstraction_ids.push_back(i);
+    }
+    for (size_t i = 0; i < candidate.size(); ++i) {
+        if (candidate.contains(i)) {
+            abstraction_ids.push_back(num_hard_goals + i);
+        }
+    }
+
+    auto it = partitionings.find(abstraction_ids);
+    if (it != partitionings.end()) {
+        return it->second.get();
+    }
+    if (static_cast<int>(partitionings.size()) >= max_cached_partitionings) {
+        return nullptr;
+    }
+    const CostPartitioning *partitioning =
+        (partitionings[abstraction_ids] =
+             compute_cost_partitioning(abstraction_ids)).get();
+    return partitioning;
+}
+
+void CostPartitioningGoalSubsetHeuristic::update_candidates(
+    MSGSCollection &current_msgs) {
+    if (&current_msgs == candidates_msgs &&
+        current_msgs.get_num_updates() == candidates_msgs_version) {
+        return;
+    }
+    candidates.clear();
+    GoalSubsets mugs = current_msgs.get_mugs();
+    for (const GoalSubset &candidate : mugs) {
+        candidates.push_back(candidate);
+    }
+    candidates_msgs = &current_msgs;
+    candidates_msgs_version = current_msgs.get_num_updates();
+}
+
+EvaluationResult CostPartitioningGoalSubsetHeuristic::compute_result(
+    EvaluationContext &eval_context) {
+    MSGSEvaluationContext *msgs_eval_context =
+        dynamic_cast<MSGSEvaluationContext *>(&eval_context);
+    if (!msgs_eval_context) {
+        cerr << "ngscp can only be used by searches that track MSGS." << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+
+    const State &state = msgs_eval_context->get_state();
+    int remaining_cost =
+        msgs_eval_context->get_cost_bound() - msgs_eval_context->get_g_value();
+    int heuristic = compute_heuristic(
+        state, *msgs_eval_context->get_msgs_collection(), remaining_cost);
+    assert(heuristic == DEAD_END || heuristic >= 0);
+
+    EvaluationResult result;
+    result.set_count_evaluation(true);
+    result.set_evaluator_value(
+        heuristic == DEAD_END ? EvaluationResult::INFTY : heuristic);
+    return result;
+}
+
+int CostPartitioningGoalSubsetHeuristic::compute_heuristic(
+    const State &ancestor_state, MSGSCollection &current_msgs,
+    int remaining_cost) {
+    State state = convert_ancestor_state(ancestor_state);
+    int num_abstractions = abstractions.size();
+    vector<int> abstract_state_ids(num_abstractions);
+    vector<int> costs(num_abstractions);
+    for (int i = 0; i < num_abstractions; ++i) {
+        const GoalAbstraction &abstraction = abstractions[i];
+        abstract_state_ids[i] =
+            abstraction.refinement_hierarchy->get_abstract_state_id(state);
+        costs[i] = abstraction.h_values[abstract_state_ids[i]];
+    }
+
+    // Prune with the per-goal estimates first.
+    int res = current_msgs.prune(state, costs, remaining_cost);
+    if (res == DEAD_END) {
+        return DEAD_END;
+    }
+
+    update_candidates(current_msgs);
+    int num_hard_goals = hard_goal_list.size();
+    for (const GoalSubset &candidate : candidates) {
+        bool reachable_per_goal = true;
+        for (size_t i = 0; i < candidate.size(); ++i) {
+            if (candidate.contains(i) &&
+                costs[num_hard_goals + i] >= remaining_cost) {
+                reachable_per_goal = false;
+                break;
+            }
+        }
+        if (!reachable_per_goal) {
+            continue;
+        }
+
+        const CostPartitioning *partitioning = get_cost_partitioning(candidate);
+        if (!partitioning) {
+            ++num_uncached_candidates;
+            return res;
+        }
+        int sum_h = 0;
+        for (size_t i = 0; i < partitioning->abstraction_ids.size(); ++i) {
+            int id = partitioning->abstraction_ids[i];
+            int h = partitioning->h_values[i][abstract_state_ids[id]];
+            if (h == INF) {
+                sum_h = INF;
+                break;
+            }
+            sum_h += h;
+        }
+        if (sum_h < remaining_cost) {
+            return res;
+        }
+    }
+    ++num_pruned_by_partitioning;
+    return DEAD_END;
+}
+
+int CostPartitioningGoalSubsetHeuristic::compute_heuristic(
+    const State &ancestor_state) {
+    State state = convert_ancestor_state(ancestor_state);
+    int max_h = 0;
+    for (const GoalAbstraction &abstraction : abstractions) {
+        int h = abstraction.h_values[
+            abstraction.refinement_hierarchy->get_abstract_state_id(state)];
+        if (h == INF) {
+            return DEAD_END;
+        }
+        max_h = max(max_h, h);
+    }
+    return max_h;
+}
+
+void CostPartitioningGoalSubsetHeuristic::print_statistics() const {
+    log << "Cached cost partitionings: " << partitionings.size() << endl;
+    log << "States pruned by cost partitioning: "
+        << num_pruned_by_partitioning << endl;
+    log << "Evaluations with uncached candidates: "
+        << num_uncached_candidates << endl;
+}
+
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "cost partitioning goal subset heuristic",
+        "States are pruned if no goal subset that is not a subset of an "
+        "MSGS found so far is reachable. Reachability of a goal subset is "
+        "estimated with a saturated cost partitioning over Cartesian "
+        "abstractions for the individual goals, which dominates the maximum "
+        "over the individual goals.");
+
+    parser.add_option<int>(
+        "max_states",
+        "maximum sum of abstract states over all goal abstractions",
+        "infinity",
+        Bounds("1", "infinity"));
+    parser.add_option<int>(
+        "max_transitions",
+        "maximum sum of real transitions (excluding self-loops) over "
+        " all goal abstractions",
+        "1M",
+        Bounds("0", "infinity"));
+    parser.add_option<double>(
+        "max_time",
+        "maximum time in seconds for building abstractions",
+        "infinity",
+        Bounds("0.0", "infinity"));
+    vector<string> pick_strategies;
+    pick_strategies.push_back("RANDOM");
+    pick_strategies.push_back("MIN_UNWANTED");
+    pick_strategies.push_back("MAX_UNWANTED");
+    pick_strategies.push_back("MIN_REFINED");
+    pick_strategies.push_back("MAX_REFINED");
+    pick_strategies.push_back("MIN_HADD");
+    pick_strategies.push_back("MAX_HADD");
+    parser.add_enum_option<cegar::PickSplit>(
+        "pick", pick_strategies, "split-selection strategy", "MAX_REFINED");
+    parser.add_option<int>(
+        "max_cached_partitionings",
+        "maximum number of goal subsets for which cost partitionings are "
+        "computed; further candidates are not used for pruning",
+        "1000",
+        Bounds("0", "infinity"));
+    Heuristic::add_options_to_parser(parser);
+    utils::add_rng_options(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run()) {
+        return nullptr;
+    }
+
+    return make_shared<CostPartitioningGoalSubsetHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("ngscp", _parse);
+}
@@ -0,0 +1,94 @@
+#ifndef COST_PARTITIONING_GOAL_SUBSET_HEURISTIC_H
+#define COST_PARTITIONING_GOAL_SUBSET_HEURISTIC_H
+
+#include "msgs_collection.h"
+#include "../goal_subsets/goal_subset.h"
+#include "../../heuristic.h"
+#include "../../cegar/types.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace cegar {
+class RefinementHierarchy;
+}
+
+namespace cost_partitioning_goal_subset_heuristic {
+
+/*
+  Cartesian abstraction for a single goal fact. In contrast to
+  CartesianHeuristicFunction we keep the transitions to be able to
+  compute goal distances for other cost functions.
+*/
+struct GoalAbstraction {
+    std::unique_ptr<cegar::RefinementHierarchy> refinement_hierarchy;
+    std::vector<cegar::Transitions> incoming_transitions;
+    cegar::Goals goals;
+    // Goal distances under the original operator costs.
+    std::vector<int> h_values;
+};
+
+/*
+  Goal distances of the abstractions of a goal set under a saturated cost
+  partitioning. The sum of the values is an admissible estimate for
+  reaching all goals of the set.
+*/
+struct CostPartitioning {
+    std::vector<int> abstraction_ids;
+    std::vector<std::vector<int>> h_values;
+};
+
+/*
+  Prune states from which no goal subset that is not yet covered by the
+  current MSGS can be reached within the remaining cost bound.
+
+  Every uncovered goal subset includes a minimal uncovered subset, i.e., one
+  of the MUGS candidates of the current MSGS. Instead of bounding the cost of
+  reaching such a candidate by the maximum of its per-goal estimates, we sum
+  the estimates of a saturated cost partitioning over the per-goal
+  abstractions of the candidate (plus hard goals). The partitionings are
+  computed when a candidate is first needed and cached.
+*/
+class CostPartitioningGoalSubsetHeuristic : public Heuristic {
+    std::vector<FactPair> hard_goal_list;
+    std::vector<FactPair> soft_goal_list;
+
+    // Abstractions for hard goals first, then for soft goals.
+    std::vector<GoalAbstraction> abstractions;
+    std::vector<int> operator_costs;
+
+    const int max_cached_partitionings;
+    std::map<std::vector<int>, std::unique_ptr<CostPartitioning>> partitionings;
+
+    // Candidates are recomputed whenever the MSGS change.
+    std::vector<goalsubset::GoalSubset> candidates;
+    const MSGSCollection *candidates_msgs;
+    int candidates_msgs_version;
+
+    int num_pruned_by_partitioning;
+    int num_uncached_candidates;
+
+    void build_abstractions(const options::Options &opts);
+    std::unique_ptr<CostPartitioning> compute_cost_partitioning(
+        const std::vector<int> &abstraction_ids) const;
+    const CostPartitioning *get_cost_partitioning(
+        const goalsubset::GoalSubset &candidate);
+    void update_candidates(MSGSCollection &current_msgs);
+
+protected:
+    virtual int compute_heuristic(const State &ancestor_state) override;
+    int compute_heuristic(
+        const State &ancestor_state, MSGSCollection &current_msgs,
+        int remaining_cost);
+
+public:
+    explicit CostPartitioningGoalSubsetHeuristic(const options::Options &opts);
+    virtual ~CostPartitioningGoalSubsetHeuristic() override;
+
+    virtual EvaluationResult compute_result(EvaluationContext &eval_context) override;
+    virtual void print_statistics() const override;
+};
+}
+
+#endif
@@ -11,6 +11,9 @@
 #include "../utils/logging.h"
 
 #include "../../search_engines/search_common.h"
+#include "../../structural_symmetries/group.h"
+#include "../../utils/memory.h"
+#include "../../utils/system.h"
 
 #include "../../option_parser.h"
 #include "../../plugin.h"
@@ -30,7 +33,24 @@ GoalSubsetAStar::GoalSubsetAStar(const Options &opts)
       open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
                 create_state_open_list()),
       eval(opts.get<shared_ptr<Evaluator>>("eval", nullptr)),
-      filename((opts.get<string>("f", "conflicts.json"))) {
+      pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      symmetries(opts.get<shared_ptr<structural_symmetries::Group>>(
+                     "symmetries", nullptr)),
+      filename((opts.get<string>("f", "conflicts.json"))),
+      evaluation_pipeline(opts, log),
+      msgs_pruning_stage(evaluation_pipeline.add_stage("msgs_pruning")),
+      dead_end_stage(evaluation_pipeline.add_stage("dead_end")),
+      frontier_search(opts.get<bool>("frontier_search")),
+      current_layer_g(0),
+      max_operator_cost(0),
+      num_stored_states(0),
+      max_num_stored_states(0),
+      num_freed_layers(0) {
+    if (frontier_search && osp) {
+        cerr << "error: frontier_search does not store plans and cannot "
+             << "be combined with osp" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
 }
 
 void GoalSubsetAStar::initialize() {
@@ -44,6 +64,26 @@ void GoalSubsetAStar::initialize() {
         current_msgs.initialize(task);
     }
 
+    /*
+      Only the operator pruning of the pruning method is used, the states
+      are pruned by the evaluator eval.
+    */
+    pruning_method->initialize(task);
+
+    if (symmetries) {
+        symmetries->compute_symmetries(task_proxy);
+        current_msgs.set_soft_goal_permutations(
+            symmetries->get_goal_permutations(current_msgs.get_soft_goal_facts()));
+        if (!symmetries->has_symmetries()) {
+            symmetries = nullptr;
+        }
+    }
+
+    if (frontier_search) {
+        initialize_frontier_search();
+        return;
+    }
+
     State initial_state = state_registry.get_initial_state();
 
     current_msgs.track(initial_state);
@@ -73,11 +113,257 @@ void GoalSubsetAStar::initialize() {
 
 void GoalSubsetAStar::print_statistics() const {
     statistics.print_detailed_statistics();
-    search_space.print_statistics();
+    if (frontier_search) {
+        log << "Peak number of stored states: " << max_num_stored_states << endl;
+        log << "Freed layers: " << num_freed_layers << endl;
+    } else {
+        search_space.print_statistics();
+    }
+    evaluation_pipeline.print_statistics(log);
+    pruning_method->print_statistics();
     current_msgs.print(this->filename);
 }
 
+int GoalSubsetAStar::evaluate_new_state(MSGSEvaluationContext &eval_context) {
+    int rejecting_stage = evaluation_pipeline.run([&](int stage) -> bool {
+            if (stage == msgs_pruning_stage)
+                return eval_context.is_evaluator_value_infinite(eval.get());
+            return open_list->is_dead_end(eval_context);
+        });
+    if (rejecting_stage == dead_end_stage) {
+        statistics.inc_dead_ends();
+    }
+    return rejecting_stage;
+}
+
+State GoalSubsetAStar::get_successor_state(
+    StateRegistry &registry, const State &state, const OperatorProxy &op) {
+    if (!symmetries) {
+        return registry.get_successor_state(state, op);
+    }
+    state.unpack();
+    State succ_state = state.get_unregistered_successor(op);
+    return registry.register_state_values(
+        symmetries->get_canonical_values(succ_state.get_unpacked_values()));
+}
+
+Plan GoalSubsetAStar::trace_plan(const State &state) const {
+    Plan plan;
+    search_space.trace_path(state, plan);
+    if (!symmetries) {
+        return plan;
+    }
+
+    /*
+      The path consists of canonical states. We follow it in the original
+      task and keep the generators that map the current original state to
+      the current canonical state. In each step, we look for an operator
+      whose successor these generators map to the successor of the
+      canonical state. Such an operator exists since the generators map
+      operators to operators with the same cost.
+    */
+    OperatorsProxy operators = task_proxy.get_operators();
+    State canonical_state = task_proxy.get_initial_state();
+    State original_state = task_proxy.get_initial_state();
+    vector<int> applied_generators;
+    Plan original_plan;
+    for (OperatorID op_id : plan) {
+        OperatorProxy op = operators[op_id];
+        State succ_state = canonical_state.get_unregistered_successor(op);
+        vector<OperatorID> applicable_ops;
+        successor_generator.generate_applicable_ops(original_state, applicable_ops);
+        bool found = false;
+        for (OperatorID original_op_id : applicable_ops) {
+            OperatorProxy original_op = operators[original_op_id];
+            if (original_op.get_cost() != op.get_cost()) {
+                continue;
+            }
+            State original_succ_state =
+                original_state.get_unregistered_successor(original_op);
+            if (symmetries->apply_generators(
+                    original_succ_state.get_unpacked_values(), applied_generators)
+                == succ_state.get_unpacked_values()) {
+                original_plan.push_back(original_op_id);
+                original_state = move(original_succ_state);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            cerr << "error: could not map the plan through the symmetries" << endl;
+            utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+        }
+        canonical_state = State(
+            *task, symmetries->get_canonical_values(
+                succ_state.get_unpacked_values(), &applied_generators));
+    }
+    return original_plan;
+}
+
+GoalSubsetAStar::FrontierLayer &GoalSubsetAStar::get_frontier_layer(int g) {
+    FrontierLayer &layer = frontier_layers[g];
+    if (!layer.registry) {
+        layer.registry = utils::make_unique_ptr<StateRegistry>(task_proxy);
+    }
+    return layer;
+}
+
+void GoalSubsetAStar::pack_successor(
+    const State &state, const OperatorProxy &op, vector<PackedStateBin> &buffer) {
+    state.unpack();
+    State succ_state = state.get_unregistered_successor(op);
+    vector<int> values = symmetries
+        ? symmetries->get_canonical_values(succ_state.get_unpacked_values())
+        : succ_state.get_unpacked_values();
+    const int_packer::IntPacker &state_packer = state_registry.get_state_packer();
+    // Avoid garbage values in half-full bins.
+    buffer.assign(state_packer.get_num_bins(), 0);
+    for (size_t var = 0; var < values.size(); ++var) {
+        state_packer.set(buffer.data(), var, values[var]);
+    }
+}
+
+bool GoalSubsetAStar::is_in_earlier_layer(
+    const PackedStateBin *data, int g) const {
+    for (const auto &entry : frontier_layers) {
+        if (entry.first >= g) {
+            break;
+        }
+        if (entry.second.registry->find_state_data(data) != StateID::no_state) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GoalSubsetAStar::free_closed_layers() {
+    /*
+      Successors of the current and later layers can only be duplicates of
+      states in layers at most max_operator_cost below the current layer
+      if the state space is undirected. Frontier search is therefore only
+      sound for undirected state spaces: in directed ones, states of freed
+      layers may be expanded again with a higher g value, and without a
+      finite bound the search may not terminate on cycles.
+    */
+    auto it = frontier_layers.begin();
+    while (it != frontier_layers.end() &&
+           it->first < current_layer_g - max_operator_cost) {
+        num_stored_states -= it->second.registry->size();
+        it = frontier_layers.erase(it);
+        ++num_freed_layers;
+    }
+}
+
+void GoalSubsetAStar::initialize_frontier_search() {
+    log << "Using frontier search: expanding states layer by layer" << endl;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        max_operator_cost = max(max_operator_cost, op.get_cost());
+    }
+
+    FrontierLayer &initial_layer = get_frontier_layer(0);
+    State initial_state = initial_layer.registry->get_initial_state();
+    num_stored_states = max_num_stored_states = 1;
+    current_msgs.track(initial_state);
+
+    MSGSEvaluationContext eval_context(initial_state, 0, true, &statistics, &current_msgs, bound);
+    statistics.inc_evaluated_states();
+
+    if (open_list->is_dead_end(eval_context)) {
+        log << "Initial state is a dead end." << endl;
+    } else {
+        if (search_progress.check_progress(eval_context))
+            statistics.print_checkpoint_line(0);
+        initial_layer.open_states.push_back(initial_state.get_id());
+    }
+
+    print_initial_evaluator_values(eval_context);
+}
+
+SearchStatus GoalSubsetAStar::frontier_step() {
+    auto layer_it = frontier_layers.lower_bound(current_layer_g);
+    while (layer_it != frontier_layers.end() &&
+           layer_it->second.next_open_state == layer_it->second.open_states.size()) {
+        ++layer_it;
+    }
+    if (layer_it == frontier_layers.end()) {
+        if (log.is_at_least_normal())
+            log << "Completely explored state space -- no solution!" << endl;
+        return FAILED;
+    }
+    if (layer_it->first != current_layer_g) {
+        current_layer_g = layer_it->first;
+        free_closed_layers();
+    }
+
+    FrontierLayer &layer = layer_it->second;
+    StateID id = layer.open_states[layer.next_open_state++];
+    State s = layer.registry->lookup_state(id);
+    // The state was reached with a lower g value after it was generated.
+    if (is_in_earlier_layer(s.get_buffer(), current_layer_g))
+        return IN_PROGRESS;
+
+    current_msgs.track(s);
+    statistics.inc_expanded();
+
+    if (check_goal(s)) {
+        /*
+          Without parent pointers we cannot extract a plan, so we report
+          that the search terminated without one, like other searches that
+          only compute MSGS.
+        */
+        if (log.is_at_least_normal())
+            log << "Goal state reached. No plan is stored in frontier mode."
+                << endl;
+        return FINISHED;
+    }
+
+    vector<OperatorID> applicable_ops;
+    successor_generator.generate_applicable_ops(s, applicable_ops);
+    pruning_method->prune_operators(s, applicable_ops);
+
+    for (OperatorID op_id : applicable_ops) {
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        int succ_g = current_layer_g + op.get_cost();
+        if (succ_g >= bound)
+            continue;
+        statistics.inc_generated();
+
+        /*
+          Only register successors that are not in earlier layers, so that
+          such duplicates are not stored.
+        */
+        pack_successor(s, op, successor_buffer);
+        if (is_in_earlier_layer(successor_buffer.data(), succ_g))
+            continue;
+        FrontierLayer &succ_layer = get_frontier_layer(succ_g);
+        size_t num_states_before = succ_layer.registry->size();
+        State succ_state =
+            succ_layer.registry->register_state_data(successor_buffer.data());
+        // Duplicates within a layer are open, expanded, pruned or dead ends.
+        if (succ_layer.registry->size() == num_states_before)
+            continue;
+        ++num_stored_states;
+        max_num_stored_states = max(max_num_stored_states, num_stored_states);
+
+        MSGSEvaluationContext succ_eval_context(
+            succ_state, succ_g, true, &statistics, &current_msgs, bound);
+        statistics.inc_evaluated_states();
+
+        if (evaluate_new_state(succ_eval_context) != -1)
+            continue;
+
+        succ_layer.open_states.push_back(succ_state.get_id());
+        if (search_progress.check_progress(succ_eval_context))
+            statistics.print_checkpoint_line(succ_g);
+    }
+
+    return IN_PROGRESS;
+}
+
 SearchStatus GoalSubsetAStar::step() {
+    if (frontier_search)
+        return frontier_step();
+
     // cout << "===================== STEP =====================" << endl;
     tl::optional<SearchNode> node;
     while (true) {
@@ -88,7 +374,7 @@ SearchStatus GoalSubsetAStar::step() {
                     cout << "OSP task plan found" << endl;
                     State best_state = state_registry.lookup_state(best_state_id);
                     cout << "Maximal number of solved soft goals: " << current_msgs.get_max_solved_soft_goals() << endl;
-                    set_osp_plan(best_state);
+                    set_plan(trace_plan(best_state));
                     return SOLVED;
                 }
             }
@@ -122,25 +408,46 @@ SearchStatus GoalSubsetAStar::step() {
     }
 
     const State &s = node->get_state();
-    if (check_goal_and_set_plan(s))
+    if (check_goal(s)) {
+        if (log.is_at_least_normal())
+            log << "Solution found!" << endl;
+        set_plan(trace_plan(s));
         return SOLVED;
+    }
 
     vector<OperatorID> applicable_ops;
     successor_generator.generate_applicable_ops(s, applicable_ops);
+    pruning_method->prune_operators(s, applicable_ops);
 
     // This evaluates the expanded state (again) to get preferred ops
     MSGSEvaluationContext eval_context(s, node->get_g(), false, &statistics, &current_msgs, bound, true);
 
     // int pre_estimate = eval_context.get_evaluator_value_or_infinity(eval.get());
 
+    vector<OperatorID> succ_ops;
+    succ_ops.reserve(applicable_ops.size());
     for (OperatorID op_id : applicable_ops) {
-        // cout << "****************** EXPAND *****************" << endl;
         OperatorProxy op = task_proxy.get_operators()[op_id];
         // cout << "g = " << (node->get_real_g() + op.get_cost()) << endl;
-        if ((node->get_real_g() + op.get_cost()) >= bound){
-            continue;
+        if ((node->get_real_g() + op.get_cost()) < bound){
+            succ_ops.push_back(op_id);
+        }
+    }
+    vector<State> succ_states;
+    if (symmetries) {
+        for (OperatorID op_id : succ_ops) {
+            succ_states.push_back(get_successor_state(
+                state_registry, s, task_proxy.get_operators()[op_id]));
         }
-        State succ_state = state_registry.get_successor_state(s, op);
+    } else {
+        state_registry.get_successor_states(s, succ_ops, succ_states);
+    }
+
+    for (size_t i = 0; i < succ_ops.size(); ++i) {
+        // cout << "****************** EXPAND *****************" << endl;
+        OperatorID op_id = succ_ops[i];
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        const State &succ_state = succ_states[i];
         // cout << "Succ State: " << succ_state.get_id() << endl;
         statistics.inc_generated();
 
@@ -164,16 +471,11 @@ SearchStatus GoalSubsetAStar::step() {
                 succ_state, succ_g, true, &statistics, &current_msgs, bound);
             statistics.inc_evaluated_states();
 
-            // cout << "new goals reachable?????" << endl;
-            if(succ_eval_context.is_evaluator_value_infinite(eval.get())){
-                // cout << "Prune Succ State: " << succ_state.get_id() << endl;
-                continue;
-            }
-
-            if (open_list->is_dead_end(succ_eval_context)) {
-                // cout << "DEADEND Succ State: " << succ_state.get_id() << endl;
+            int rejecting_stage = evaluate_new_state(succ_eval_context);
+            if (rejecting_stage == dead_end_stage) {
                 succ_node.mark_as_dead_end();
-                statistics.inc_dead_ends();
+                continue;
+            } else if (rejecting_stage != -1) {
                 continue;
             }
 
@@ -274,6 +576,7 @@ MSGSCollection  GoalSubsetAStar::get_msgs(){
 
 void add_options_to_parser(OptionParser &parser) {
     SearchEngine::add_pruning_option(parser);
+    add_evaluation_pipeline_options_to_parser(parser);
     SearchEngine::add_options_to_parser(parser);
 }
 
@@ -291,6 +594,24 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.add_option<string>(
     "f",
     "output file conflicts", "conflicts.json");
+    parser.add_option<bool>(
+        "frontier_search",
+        "expand states layer by layer in order of increasing g value and "
+        "store neither parent pointers nor creating operators. Closed layers "
+        "that are no longer needed for duplicate detection are freed. "
+        "The resulting MSGS are the same, but no plan is extracted, so "
+        "this cannot be combined with osp, and reaching a goal state ends "
+        "the search without a plan. The expansion order ignores evals. "
+        "Freeing layers is only sound for undirected state spaces; in "
+        "directed ones, states may be expanded repeatedly and the search "
+        "may not terminate without a finite bound.",
+        "false");
+    parser.add_option<shared_ptr<structural_symmetries::Group>>(
+        "symmetries",
+        "expand only one state of each set of symmetric states that is "
+        "found (orbit search). The MSGS of the other states are obtained by "
+        "mapping the MSGS through the symmetries.",
+        OptionParser::NONE);
 
     add_options_to_parser(parser);
     Options opts = parser.parse();
@@ -1,11 +1,13 @@
 #ifndef SEARCH_ENGINES_GOAL_SUBSET_ASTAR_SEARCH_H
 #define SEARCH_ENGINES_GOAL_SUBSET_ASTAR_SEARCH_H
 
+#include "../evaluation_pipeline.h"
 #include "../open_list.h"
 #include "../search_engine.h"
 #include "msgs_collection.h"
 #include "msgs_evaluation_context.h"
 
+#include <map>
 #include <memory>
 #include <vector>
 
@@ -17,6 +19,10 @@ class OptionParser;
 class Options;
 }
 
+namespace structural_symmetries {
+class Group;
+}
+
 namespace goal_subset_astar {
 class GoalSubsetAStar : public SearchEngine {
     const bool reopen_closed_nodes;
@@ -31,12 +37,67 @@ class GoalSubsetAStar : public SearchEngine {
 
     std::shared_ptr<PruningMethod> pruning_method;
 
+    /*
+      With symmetries, every generated state is replaced by its canonical
+      state (orbit search), and the goal subsets of the expanded states are
+      mapped through the symmetries.
+    */
+    std::shared_ptr<structural_symmetries::Group> symmetries;
+
     std::string filename;
     MSGSCollection current_msgs;
 
+    EvaluationPipeline evaluation_pipeline;
+    const int msgs_pruning_stage;
+    const int dead_end_stage;
+
+    /*
+      In frontier mode, states are expanded layer by layer in order of
+      increasing g value instead of using the open list. Each layer has its
+      own state registry and stores no search node information at all: the
+      g value of a state is the key of its layer and states are only stored
+      while they are open or needed for duplicate detection. Layers more
+      than the maximal operator cost below the current layer are freed.
+      Since there are no parent pointers, no plans are extracted. This is
+      only sound for undirected state spaces (see free_closed_layers).
+    */
+    struct FrontierLayer {
+        std::unique_ptr<StateRegistry> registry;
+        std::vector<StateID> open_states;
+        size_t next_open_state = 0;
+    };
+    const bool frontier_search;
+    std::map<int, FrontierLayer> frontier_layers;
+    int current_layer_g;
+    int max_operator_cost;
+    size_t num_stored_states;
+    size_t max_num_stored_states;
+    int num_freed_layers;
+    // Reused between expansions to avoid allocations.
+    std::vector<PackedStateBin> successor_buffer;
+
     void start_f_value_statistics(MSGSEvaluationContext &eval_context);
     void update_f_value_statistics(MSGSEvaluationContext &eval_context);
     void reward_progress();
+    /*
+      Run the MSGS pruning evaluator and the dead-end detection on a new
+      state. Return the rejecting stage or -1 if the state is not rejected.
+    */
+    int evaluate_new_state(MSGSEvaluationContext &eval_context);
+
+    State get_successor_state(
+        StateRegistry &registry, const State &state, const OperatorProxy &op);
+    // Return the plan to the state that is applicable in the original task.
+    Plan trace_plan(const State &state) const;
+
+    FrontierLayer &get_frontier_layer(int g);
+    // Store the packed (canonical) successor of the state in the buffer.
+    void pack_successor(const State &state, const OperatorProxy &op,
+                        std::vector<PackedStateBin> &buffer);
+    bool is_in_earlier_layer(const PackedStateBin *data, int g) const;
+    void free_closed_layers();
+    void initialize_frontier_search();
+    SearchStatus frontier_step();
 
 protected:
     virtual void initialize() override;
@@ -4,6 +4,7 @@
 
 #include <fstream>
 #include <bitset>
+#include <set>
 #include "../goal_subsets/output_handler.h"
 
 using namespace std;
@@ -76,6 +77,7 @@ void MSGSCollection::initialize(shared_ptr<AbstractTask> task_) {
 
 void MSGSCollection::add_and_mimize(GoalSubset subset){
     assert(soft_goal_list.size() == subset.size());
+    ++num_updates;
     this->add(subset);
     this->minimize_non_maximal_subsets();
 }
@@ -86,6 +88,36 @@ void MSGSCollection::add_and_mimize(GoalSubsets subsets) {
     }
 }
 
+void MSGSCollection::set_soft_goal_permutations(const vector<vector<int>> &permutations) {
+    soft_goal_permutations = permutations;
+}
+
+void MSGSCollection::add_symmetric_subsets(const GoalSubset &subset) {
+    if (soft_goal_permutations.empty()) {
+        return;
+    }
+    set<GoalSubset> orbit = {subset};
+    vector<GoalSubset> open = {subset};
+    while (!open.empty()) {
+        GoalSubset current = open.back();
+        open.pop_back();
+        for (const vector<int> &permutation : soft_goal_permutations) {
+            GoalSubset image = GoalSubset(current.size());
+            for (size_t i = 0; i < current.size(); ++i) {
+                if (current.contains(i)) {
+                    image.add(permutation[i]);
+                }
+            }
+            if (orbit.insert(image).second) {
+                open.push_back(image);
+                if (!contains_superset(image)) {
+                    this->add_and_mimize(image);
+                }
+            }
+        }
+    }
+}
+
 bool MSGSCollection::contains_superset(GoalSubset subset){
     for(GoalSubset s : subsets){
         if(s.is_superset_of(subset)){
@@ -229,7 +261,19 @@ int MSGSCollection::prune(const State &state, vector<int> costs, int remaining_c
     }
 }
 
+int MSGSCollection::get_num_reachable_soft_goals(const vector<int> &costs, int remaining_cost){
+    GoalSubset reachable_goals = GoalSubset(all_goal_list.size());
+    for(size_t i = 0; i < all_goal_list.size(); i++){
+        reachable_goals.set(i, costs[i] != -1 && costs[i] < remaining_cost);
+    }
+    if(hard_goal_list.size() == 0){
+        return reachable_goals.count();
+    }
+    return get_reachable_soft_goals(reachable_goals).count();
+}
+
 bool MSGSCollection::track(const State &state){
+    utils::TelemetryTimer timer(tracking_telemetry);
 
     // cout<< "-------------- CURRENT MSGS ------------------" << endl;
     // this->print_subsets();
@@ -242,6 +286,7 @@ bool MSGSCollection::track(const State &state){
         // satisfied_goals.print();
         if(!contains_superset(satisfied_goals)){
             this->add_and_mimize(satisfied_goals);
+            add_symmetric_subsets(satisfied_goals);
             // cout<< "add new goal subset" << endl;
             return true;
         }
@@ -254,6 +299,7 @@ bool MSGSCollection::track(const State &state){
         if(satisfied_hard_goals.all() && !contains_superset(satisfied_soft_goals)){
              update_best_state(state.get_id(), satisfied_soft_goals.count());
             this->add_and_mimize(satisfied_soft_goals);
+            add_symmetric_subsets(satisfied_soft_goals);
             return true;
         }
         return false;
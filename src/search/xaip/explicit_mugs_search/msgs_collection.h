@@ -4,6 +4,7 @@
 #include "../goal_subsets/goal_subsets.h"
 #include "../../task_proxy.h"
 #include "../../tasks/root_task.h"
+#include "../../utils/telemetry.h"
 #include "../../utils/timer.h"
 
 #include <iostream>
@@ -25,13 +26,19 @@ private:
     std::vector<std::string> soft_goal_fact_names;
 
     utils::Timer overall_timer;
+    utils::TelemetryHandle tracking_telemetry{"msgs_tracking"};
 
     int num_visited_states_since_last_added;
+    // Incremented whenever a goal subset is added.
+    int num_updates = 0;
     int num_pruned_states = 0;
 
     StateID best_state = StateID::no_state;
     int max_num_solved_soft_goals = 0;
 
+    // Permutations of the soft goal indices induced by symmetries of the task.
+    std::vector<std::vector<int>> soft_goal_permutations;
+
 protected:
 
     goalsubset::GoalSubset get_satisfied_soft_goals(const State &state);
@@ -45,20 +52,39 @@ protected:
     bool contains_superset(goalsubset::GoalSubset subset);
     bool contains_strict_superset(goalsubset::GoalSubset subset);
     void update_best_state(StateID id, int num_solved_soft_goals);
+    // Add the images of the subset under the soft goal permutations.
+    void add_symmetric_subsets(const goalsubset::GoalSubset &subset);
 
 public:
     explicit MSGSCollection();
     void initialize(std::shared_ptr<AbstractTask> task);
 
     std::vector<FactPair> get_goal_facts();
+    const std::vector<FactPair> &get_soft_goal_facts() const {return soft_goal_list;}
+    /*
+      If the search only expands one state of each set of symmetric states,
+      the goal subsets of the other states are obtained by applying the
+      permutations (of the indices of get_soft_goal_facts()) to the goal
+      subsets of the expanded states. This is only sound if the symmetries
+      inducing the permutations fix the initial state.
+    */
+    void set_soft_goal_permutations(const std::vector<std::vector<int>> &permutations);
     void add_and_mimize(GoalSubsets subsets);
 
     int prune(const State &state, std::vector<int> costs, int remaining_cost);
+    /*
+      Upper bound on the size of a soft goal subset that can still be
+      reached within remaining_cost given the per-goal estimates in costs
+      (same order as for prune).
+    */
+    int get_num_reachable_soft_goals(const std::vector<int> &costs, int remaining_cost);
+    int get_num_soft_goals() const {return soft_goal_list.size();}
     bool track(const State &state);
     StateID get_cardinally_best_state() {return best_state;}
     int get_max_solved_soft_goals() {return max_num_solved_soft_goals;}
 
     GoalSubsets get_mugs() const;
+    int get_num_updates() const {return num_updates;}
 
     int get_size() const {
         return subsets.size();
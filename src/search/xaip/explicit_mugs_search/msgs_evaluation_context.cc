@@ -5,6 +5,8 @@
 #include "../../evaluator.h"
 #include "../../search_statistics.h"
 
+#include "../../utils/telemetry.h"
+
 #include <cassert>
 
 using namespace std;
@@ -46,7 +48,10 @@ MSGSEvaluationContext::MSGSEvaluationContext(
 const EvaluationResult &MSGSEvaluationContext::get_result(Evaluator *evaluator) {
     EvaluationResult &result = cache[evaluator];
     if (result.is_uninitialized()) {
-        result = evaluator->compute_result(*this);
+        {
+            utils::TelemetryTimer timer(evaluator->get_telemetry_handle());
+            result = evaluator->compute_result(*this);
+        }
         if (statistics &&
             evaluator->is_used_for_counting_evaluations() &&
             result.get_count_evaluation()) {
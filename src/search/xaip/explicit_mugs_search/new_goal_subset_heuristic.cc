@@ -11,7 +11,8 @@ using namespace goalsubset;
 namespace new_goal_subset_heuristic {
 NewGoalSubsetHeuristic::NewGoalSubsetHeuristic(const Options &opts)
     : Heuristic(opts), heuristic_cache(HGEntry(NO_VALUE, 0, true)),
-    h(opts.get<shared_ptr<Evaluator>>("h", nullptr)){
+    h(opts.get<shared_ptr<Evaluator>>("h", nullptr)),
+    estimate(opts.get<Estimate>("estimate")){
 
     log << "--> new goal subset heuristic" << endl;
     if(initialized){
@@ -144,7 +145,11 @@ int NewGoalSubsetHeuristic::compute_heuristic(const State &state, MSGSCollection
     //check all hard goals reachable
     int res = current_msgs->prune(state, costs, remaining_cost);
     // cout << res << endl;
-    return res;
+    if(res == DEAD_END || estimate == Estimate::MIN_GOAL_COST){
+        return res;
+    }
+    return current_msgs->get_num_soft_goals() -
+           current_msgs->get_num_reachable_soft_goals(costs, remaining_cost);
 }
 
 
@@ -176,6 +181,21 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "h",
         "add max heuristic");
 
+    vector<string> estimates;
+    vector<string> estimates_doc;
+    estimates.push_back("MIN_GOAL_COST");
+    estimates_doc.push_back(
+        "minimal estimate of all goals reachable within the remaining bound");
+    estimates.push_back("MISSING_SOFT_GOALS");
+    estimates_doc.push_back(
+        "number of soft goals not reachable within the remaining bound; "
+        "use as open list evaluator (e.g. evals=[ngsh]) to find large "
+        "MSGS first, which strengthens the pruning early on");
+    parser.add_enum_option<Estimate>(
+        "estimate", estimates,
+        "value of states that are not pruned",
+        "MIN_GOAL_COST", estimates_doc);
+
     Heuristic::add_options_to_parser(parser);
     Options opts = parser.parse();
     if (parser.dry_run()) {
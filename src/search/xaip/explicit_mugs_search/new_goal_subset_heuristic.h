@@ -12,6 +12,17 @@
 
 namespace new_goal_subset_heuristic {
 
+enum class Estimate {
+    // Minimal estimate over all goals reachable within the bound.
+    MIN_GOAL_COST,
+    /*
+      Number of soft goals that cannot be reached within the bound. Used
+      as open list evaluator, this expands states from which large goal
+      subsets are reachable first, so that large MSGS are found early.
+    */
+    MISSING_SOFT_GOALS
+};
+
 class NewGoalSubsetHeuristic : public Heuristic {
 
 protected:
@@ -39,6 +50,8 @@ private:
 
     std::shared_ptr<Heuristic> goals_heuristic;
 
+    const Estimate estimate;
+
     bool initialized = false;
 
     int min(int x, int y);
@@ -26,13 +26,7 @@ OSPCartesianHeuristic::OSPCartesianHeuristic(
 }
 
 int OSPCartesianHeuristic::compute_heuristic(const State &ancestor_state) {
-    State state = convert_ancestor_state(ancestor_state);
-    int max_cost = 0;
-    for (const CartesianHeuristicFunction &function : heuristic_functions) {
-        int value = function.get_value(state);
-        assert(value >= 0);
-        max_cost = max(max_cost, value);
-    }
+    int max_cost = lookup.get_max(ancestor_state);
     assert(max_cost >= 0);
     return max_cost;
 }
@@ -84,36 +78,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "subtasks",
         "subtask generators",
         "[landmarks(),goals()]");
-    parser.add_option<int>(
-        "max_states",
-        "maximum sum of abstract states over all abstractions",
-        "infinity",
-        Bounds("1", "infinity"));
-    parser.add_option<int>(
-        "max_transitions",
-        "maximum sum of real transitions (excluding self-loops) over "
-        " all abstractions",
-        "1M",
-        Bounds("0", "infinity"));
-    parser.add_option<double>(
-        "max_time",
-        "maximum time in seconds for building abstractions",
-        "infinity",
-        Bounds("0.0", "infinity"));
-    vector<string> pick_strategies;
-    pick_strategies.push_back("RANDOM");
-    pick_strategies.push_back("MIN_UNWANTED");
-    pick_strategies.push_back("MAX_UNWANTED");
-    pick_strategies.push_back("MIN_REFINED");
-    pick_strategies.push_back("MAX_REFINED");
-    pick_strategies.push_back("MIN_HADD");
-    pick_strategies.push_back("MAX_HADD");
-    parser.add_enum_option<PickSplit>(
-        "pick", pick_strategies, "split-selection strategy", "MAX_REFINED");
-    parser.add_option<bool>(
-        "use_general_costs",
-        "allow negative costs in cost partitioning",
-        "true");
+    add_cost_saturation_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
     utils::add_rng_options(parser);
 
@@ -84,6 +84,10 @@ class GoalSubset {
         return goals == other.goals;
     }
 
+    bool operator<(const GoalSubset &other) const{
+        return goals < other.goals;
+    }
+
     std::size_t operator()(const GoalSubset& s) const{
         return (size_t) s.goals.to_ulong();
     };
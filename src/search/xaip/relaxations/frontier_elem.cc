@@ -4,11 +4,11 @@
 using namespace std;
 
 FrontierElem::FrontierElem():
-    parent(StateID::no_state), op(0){
+    op(0), parent_g(-1), parent_real_g(-1){
 
 }
 
-FrontierElem::FrontierElem(StateID parent, OperatorID op):
-    parent(parent), op(op){
+FrontierElem::FrontierElem(const vector<PackedStateBin> &parent, OperatorID op, int parent_g, int parent_real_g):
+    parent(parent), op(op), parent_g(parent_g), parent_real_g(parent_real_g){
 
 }
\ No newline at end of file
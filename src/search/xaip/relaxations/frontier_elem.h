@@ -2,9 +2,13 @@
 #define FAST_DOWNWARD_DRONTIER_ELEM_H
 
 #include "../../open_list.h"
+#include "../../state_registry.h"
+
+#include "../../utils/hash.h"
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 
 using namespace std;
@@ -12,12 +16,22 @@ using namespace std;
 class FrontierElem {
 
 public:
-    
-    StateID parent;
+    /*
+      Packed data of the parent state. Each relaxed task is explored with
+      its own state registry, so the parent is stored by value and
+      registered in the registry of the task that continues from it.
+    */
+    std::vector<PackedStateBin> parent;
     OperatorID op;
+    /*
+      The next relaxed task is explored in a new search space, so we
+      remember the g values of the parent at the time it was expanded.
+    */
+    int parent_g;
+    int parent_real_g;
 
     FrontierElem();
-    FrontierElem(StateID parent, OperatorID op);
+    FrontierElem(const std::vector<PackedStateBin> &parent, OperatorID op, int parent_g, int parent_real_g);
 
     bool operator==(const FrontierElem &other) const {
         return parent == other.parent && op == other.op;
@@ -31,7 +45,7 @@ public:
 
 struct HashFrontierElem {
   std::size_t operator()(const FrontierElem& o) const {
-      return o.parent.hash() ^ o.op.hash() ;
+      return utils::get_hash(o.parent) ^ o.op.hash();
   }
 };
 
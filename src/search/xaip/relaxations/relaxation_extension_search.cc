@@ -4,14 +4,18 @@
 #include "../../evaluator.h"
 #include "../../open_list_factory.h"
 #include "../../option_parser.h"
-#include "../../pruning_method.h"
 #include "../../plugin.h"
 #include "../../search_engines/search_common.h"
 
 #include "../../algorithms/ordered_set.h"
 #include "../../task_utils/successor_generator.h"
+#include "../../task_utils/task_properties.h"
 
 #include "../../utils/logging.h"
+#include "../../utils/memory.h"
+#include "../../utils/parallel.h"
+#include "../../utils/system.h"
+#include "../../utils/telemetry.h"
 
 #include "../goal_subsets/goal_subset.h"
 #include "../goal_subsets/goal_subsets.h"
@@ -29,100 +33,161 @@ using namespace std;
 using namespace goalsubset;
 
 namespace relaxation_extension_search {
-RelaxationExtensionSearch::RelaxationExtensionSearch(const Options &opts)
-    : SearchEngine(opts),
-      reopen_closed_nodes(opts.get<bool>("reopen_closed")),
-      open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
-                create_state_open_list()),
-        eval(opts.get<shared_ptr<Evaluator>>("eval", nullptr)){
-    
+RelaxedTaskExploration::RelaxedTaskExploration(
+    RelaxationExtensionSearch &engine, RelaxedTask *relaxed_task,
+    const utils::LogProxy &log)
+    : engine(engine),
+      relaxed_task(relaxed_task),
+      state_registry(engine.task_proxy),
+      log(log),
+      search_space(state_registry, this->log),
+      statistics(this->log),
+      open_list(nullptr),
+      eval(nullptr),
+      num_init_states(0),
+      solved(false),
+      timed_out(false) {
+    // init with MSGS from lower cover
+    for (RelaxedTask *t : relaxed_task->get_lower_cover()) {
+        relaxed_task->add_msgs(t->get_msgs());
+        lower_frontiers.push_back(&t->get_frontier());
+    }
+    current_msgs = relaxed_task->get_msgs();
+    if (!current_msgs.is_initialized()) {
+        current_msgs.initialize(engine.task);
+    }
 }
 
-void RelaxationExtensionSearch::initialize() {
-    log << "Conducting best first search"
-        << (reopen_closed_nodes ? " with" : " without")
-        << " reopening closed nodes, (real) bound = " << bound
-        << endl;
-    assert(open_list);
+void RelaxedTaskExploration::initialize() {
+    if (lower_frontiers.empty()) {
+        State initial_state = state_registry.get_initial_state();
+        current_msgs.track(initial_state);
 
-    if(! current_msgs.is_initialized()){
-        current_msgs.initialize(task);
-    }
+        /*
+          Note: we consider the initial state as reached by a preferred
+          operator.
+        */
+        MSGSEvaluationContext eval_context(
+            initial_state, 0, true, &statistics, &current_msgs, engine.bound);
+        statistics.inc_evaluated_states();
 
-    State initial_state = state_registry.get_initial_state();
+        if (open_list->is_dead_end(eval_context)) {
+            log << "Initial state is a dead end." << endl;
+        } else {
+            if (search_progress.check_progress(eval_context))
+                statistics.print_checkpoint_line(0);
+            SearchNode node = search_space.get_node(initial_state);
+            node.open_initial();
+            open_list->insert(eval_context, initial_state.get_id());
+        }
+        return;
+    }
 
-    current_msgs.track(initial_state);
-    
-    taskRelaxationTracker = new TaskRelaxationTracker(this->getTask());
-    relaxedTask = taskRelaxationTracker->next_relaxed_task();
-    cout << "##############################################################################" << endl;
-    cout << "initial relaxed task: " << relaxedTask->get_name() << endl;
+    // Continue with the frontier states of the lower covers.
+    OperatorsProxy operators = engine.task_proxy.get_operators();
+    for (const auto *frontier : lower_frontiers) {
+        for (const FrontierElem &f_elem : *frontier) {
+            if (relaxed_task->applicable(operators[f_elem.op])) {
+                State parent = state_registry.register_state_data(f_elem.parent.data());
+                SearchNode parent_node = search_space.get_node(parent);
+                // The parent was expanded in another search space, restore its g values.
+                parent_node.restore_closed(f_elem.parent_g, f_elem.parent_real_g);
+                decide_to_put_into_openlist(parent_node, parent, f_elem.op);
+                num_init_states++;
+            } else {
+                relaxed_task->add_to_frontier(f_elem);
+            }
+        }
+    }
+}
 
-    /*
-      Note: we consider the initial state as reached by a preferred
-      operator.
-    */
-    MSGSEvaluationContext eval_context(initial_state, 0, true, &statistics, &current_msgs, bound);
+void RelaxedTaskExploration::run(StateOpenList &open_list, Evaluator &eval) {
+    this->open_list = &open_list;
+    this->eval = &eval;
+    initialize();
 
-    statistics.inc_evaluated_states();
+    tl::optional<SearchNode> node;
+    while (!open_list.empty()) {
+        if (engine.timer->is_expired()) {
+            timed_out = true;
+            break;
+        }
+        StateID id = open_list.remove_min();
+        State s = state_registry.lookup_state(id);
+        node.emplace(search_space.get_node(s));
 
-    if (open_list->is_dead_end(eval_context)) {
-        log << "Initial state is a dead end." << endl;
-    } else {
-        if (search_progress.check_progress(eval_context))
-            statistics.print_checkpoint_line(0);
-        start_f_value_statistics(eval_context);
-        SearchNode node = search_space.get_node(initial_state);
-        node.open_initial();
+        if (node->is_closed())
+            continue;
 
-        open_list->insert(eval_context, initial_state.get_id());
-    }
+        current_msgs.track(s);
 
-    print_initial_evaluator_values(eval_context);
+        node->close();
+        assert(!node->is_dead_end());
+        statistics.inc_expanded();
 
-}
+        if (engine.check_goal(s)) {
+            solved = true;
+            break;
+        }
+        expand(s);
+    }
 
-void RelaxationExtensionSearch::print_statistics() const {
-    statistics.print_detailed_statistics();
-    search_space.print_statistics();
-    // pruning_method->print_statistics();
-    // taskRelaxationTracker->results_to_file();
+    open_list.clear();
+    this->open_list = nullptr;
+    this->eval = nullptr;
 }
 
-void RelaxationExtensionSearch::expand(const State &state){
-
-    tl::optional<SearchNode> node;
-    node.emplace(search_space.get_node(state));
+void RelaxedTaskExploration::expand(const State &state) {
+    SearchNode node = search_space.get_node(state);
 
     vector<OperatorID> applicable_ops;
-    successor_generator.generate_applicable_ops(state, applicable_ops);
-
-    // This evaluates the expanded state (again) to get preferred ops
-    MSGSEvaluationContext eval_context(state, node->get_g(), false, &statistics, &current_msgs, true);
+    engine.successor_generator.generate_applicable_ops(state, applicable_ops);
 
+    OperatorsProxy operators = engine.task_proxy.get_operators();
+    vector<OperatorID> succ_ops;
+    succ_ops.reserve(applicable_ops.size());
     for (OperatorID op_id : applicable_ops) {
-        if(! relaxedTask->applicable(task_proxy.get_operators()[op_id])){
-            relaxedTask->add_to_frontier(FrontierElem(state.get_id(), op_id));
+        OperatorProxy op = operators[op_id];
+        if (!relaxed_task->applicable(op)) {
+            const PackedStateBin *buffer = state.get_buffer();
+            int num_bins = state_registry.get_state_packer().get_num_bins();
+            relaxed_task->add_to_frontier(
+                FrontierElem(vector<PackedStateBin>(buffer, buffer + num_bins),
+                             op_id, node.get_g(), node.get_real_g()));
             continue;
         }
-        decide_to_put_into_openlist(*node, state, op_id);
-    }  
+        if ((node.get_real_g() + op.get_cost()) < engine.bound) {
+            succ_ops.push_back(op_id);
+        }
+    }
+    vector<State> succ_states;
+    state_registry.get_successor_states(state, succ_ops, succ_states);
+    for (size_t i = 0; i < succ_ops.size(); ++i) {
+        decide_to_put_into_openlist(node, succ_ops[i], succ_states[i]);
+    }
 }
 
-bool RelaxationExtensionSearch::decide_to_put_into_openlist(const SearchNode &node, const State &state, OperatorID op_id){
-
-    OperatorProxy op = task_proxy.get_operators()[op_id];
-    if ((node.get_real_g() + op.get_cost()) >= bound){
+bool RelaxedTaskExploration::decide_to_put_into_openlist(
+    const SearchNode &node, const State &state, OperatorID op_id) {
+    OperatorProxy op = engine.task_proxy.get_operators()[op_id];
+    if ((node.get_real_g() + op.get_cost()) >= engine.bound) {
         return false;
     }
 
     State succ_state = state_registry.get_successor_state(state, op);
+    return decide_to_put_into_openlist(node, op_id, succ_state);
+}
+
+bool RelaxedTaskExploration::decide_to_put_into_openlist(
+    const SearchNode &node, OperatorID op_id, const State &succ_state) {
+    OperatorProxy op = engine.task_proxy.get_operators()[op_id];
+    int adjusted_cost = engine.get_adjusted_cost(op);
     statistics.inc_generated();
 
     SearchNode succ_node = search_space.get_node(succ_state);
 
     // Previously encountered dead end. Don't re-evaluate.
-    if (succ_node.is_dead_end()){
+    if (succ_node.is_dead_end()) {
         return false;
     }
 
@@ -133,10 +198,10 @@ bool RelaxationExtensionSearch::decide_to_put_into_openlist(const SearchNode &no
         // Careful: succ_node.get_g() is not available here yet,
         // hence the stupid computation of succ_g.
         // TODO: Make this less fragile.
-        int succ_g = node.get_g() + get_adjusted_cost(op);
+        int succ_g = node.get_g() + adjusted_cost;
 
         MSGSEvaluationContext succ_eval_context(
-            succ_state, succ_g, true, &statistics, &current_msgs, bound);
+            succ_state, succ_g, true, &statistics, &current_msgs, engine.bound);
         statistics.inc_evaluated_states();
 
         if (open_list->is_dead_end(succ_eval_context)) {
@@ -145,219 +210,208 @@ bool RelaxationExtensionSearch::decide_to_put_into_openlist(const SearchNode &no
             return false;
         }
 
-        if(succ_eval_context.is_evaluator_value_infinite(eval.get())){
-            // cout << "Prune Succ State: " << succ_state.get_id() << endl;
+        if (succ_eval_context.is_evaluator_value_infinite(eval)) {
             return false;
         }
 
-        succ_node.open(node, op, get_adjusted_cost(op));
+        succ_node.open(node, op, adjusted_cost);
 
         open_list->insert(succ_eval_context, succ_state.get_id());
         if (search_progress.check_progress(succ_eval_context)) {
             statistics.print_checkpoint_line(succ_node.get_g());
-            reward_progress();
+            // Boost the "preferred operator" open lists somewhat whenever
+            // one of the heuristics finds a state with a new best h value.
+            open_list->boost_preferred();
         }
-    } else if (succ_node.get_g() > node.get_g() + get_adjusted_cost(op)) {
+    } else if (succ_node.get_g() > node.get_g() + adjusted_cost) {
         // We found a new cheapest path to an open or closed state.
-        if (reopen_closed_nodes) {
+        if (engine.reopen_closed_nodes) {
             if (succ_node.is_closed()) {
-                /*
-                    TODO: It would be nice if we had a way to test
-                    that reopening is expected behaviour, i.e., exit
-                    with an error when this is something where
-                    reopening should not occur (e.g. A* with a
-                    consistent heuristic).
-                */
                 statistics.inc_reopened();
             }
-            succ_node.reopen(node, op, get_adjusted_cost(op));
+            succ_node.reopen(node, op, adjusted_cost);
 
             MSGSEvaluationContext succ_eval_context(
-                succ_state, succ_node.get_g(), true, &statistics, &current_msgs, bound);
+                succ_state, succ_node.get_g(), true, &statistics, &current_msgs, engine.bound);
 
-            if(succ_eval_context.is_evaluator_value_infinite(eval.get())){
-                // cout << "Prune Succ State: " << succ_state.get_id() << endl;
+            if (succ_eval_context.is_evaluator_value_infinite(eval)) {
                 return false;
             }
 
             /*
-                Note: our old code used to retrieve the h value from
-                the search node here. Our new code recomputes it as
-                necessary, thus avoiding the incredible ugliness of
-                the old "set_evaluator_value" approach, which also
-                did not generalize properly to settings with more
-                than one evaluator.
-
                 Reopening should not happen all that frequently, so
-                the performance impact of this is hopefully not that
-                large. In the medium term, we want the evaluators to
-                remember evaluator values for states themselves if
-                desired by the user, so that such recomputations
-                will just involve a look-up by the Evaluator object
-                rather than a recomputation of the evaluator value
-                from scratch.
+                the performance impact of recomputing the evaluator
+                values is hopefully not that large.
             */
             open_list->insert(succ_eval_context, succ_state.get_id());
         } else {
             // If we do not reopen closed nodes, we just update the parent pointers.
             // Note that this could cause an incompatibility between
             // the g-value and the actual path that is traced back.
-            succ_node.update_parent(node, op, get_adjusted_cost(op));
+            succ_node.update_parent(node, op, adjusted_cost);
         }
     }
     return true;
 }
 
-SearchStatus RelaxationExtensionSearch::step() {
-    tl::optional<SearchNode> node;
-    while (true) {
-        if (open_list->empty()) {
-            // if (log.is_at_least_normal())
-            //     log << "Completely explored state space -- no solution!" << endl;
-            if (! next_relaxed_task()){
-                std::cout << "no more relaxed tasks" << std::endl;
-                return SearchStatus::FAILED;
-            }
-        }
-        StateID id = open_list->remove_min();
-        State s = state_registry.lookup_state(id);
-        node.emplace(search_space.get_node(s));
 
-        if (node->is_closed())
-            continue;
-
-        current_msgs.track(s);
-
-        /*
-          We can pass calculate_preferred=false here since preferred
-          operators are computed when the state is expanded.
-        */
-        MSGSEvaluationContext eval_context(s, node->get_g(), false, &statistics, &current_msgs, bound);
-
-        node->close();
-        assert(!node->is_dead_end());
-        update_f_value_statistics(eval_context);
-        statistics.inc_expanded();
-        break;
+RelaxationExtensionSearch::RelaxationExtensionSearch(
+    const Options &opts, options::Registry &registry,
+    const options::Predefinitions &predefinitions)
+    : SearchEngine(opts),
+      reopen_closed_nodes(opts.get<bool>("reopen_closed")),
+      num_threads(opts.get<int>("num_threads")),
+      taskRelaxationTracker(nullptr) {
+    if (num_threads > 1 && task_properties::has_axioms(task_proxy)) {
+        cerr << "error: astar_relaxations with num_threads > 1 does not support axioms" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
     }
-
-    const State &s = node->get_state();
-    if (check_goal(s)){
-        relaxedTask->set_solvable(true);;
-
-        if (! next_relaxed_task()) {
-            return SearchStatus::SOLVED;
-        }
-        else{
-            return SearchStatus::IN_PROGRESS;
-        }
+    if (num_threads > 1 && utils::g_telemetry.is_enabled()) {
+        cerr << "error: astar_relaxations with num_threads > 1 does not support telemetry" << endl;
+        utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
     }
+    /*
+      Parse the evaluators once per thread so that each thread uses its own
+      evaluator objects. The parser and the evaluator constructors are not
+      thread-safe, so this has to happen before the threads are started.
+    */
+    auto parse_evaluator = [&](const ParseTree &tree) {
+            OptionParser parser(tree, registry, predefinitions, false);
+            return parser.start_parsing<shared_ptr<Evaluator>>();
+        };
+    for (int i = 0; i < num_threads; ++i) {
+        Options open_list_opts;
+        vector<shared_ptr<Evaluator>> open_list_evals;
+        for (const ParseTree &tree : opts.get_list<ParseTree>("evals"))
+            open_list_evals.push_back(parse_evaluator(tree));
+        vector<shared_ptr<Evaluator>> preferred;
+        for (const ParseTree &tree : opts.get_list<ParseTree>("preferred"))
+            preferred.push_back(parse_evaluator(tree));
+        open_list_opts.set("evals", open_list_evals);
+        open_list_opts.set("preferred", preferred);
+        open_list_opts.set("boost", opts.get<int>("boost"));
+        open_lists.push_back(
+            search_common::create_greedy_open_list_factory(open_list_opts)->
+            create_state_open_list());
+        evals.push_back(parse_evaluator(opts.get<ParseTree>("eval")));
+        free_evaluator_slots.push_back(i);
+    }
+}
 
-    expand(s);
+void RelaxationExtensionSearch::initialize() {
+    log << "Conducting best first search over relaxed tasks"
+        << (reopen_closed_nodes ? " with" : " without")
+        << " reopening closed nodes, (real) bound = " << bound
+        << ", threads = " << num_threads
+        << endl;
 
-    return IN_PROGRESS;
+    taskRelaxationTracker = new TaskRelaxationTracker(this->getTask());
+    timer = utils::make_unique_ptr<utils::CountdownTimer>(max_time);
 }
 
-void RelaxationExtensionSearch::reward_progress() {
-    // Boost the "preferred operator" open lists somewhat whenever
-    // one of the heuristics finds a state with a new best h value.
-    open_list->boost_preferred();
+int RelaxationExtensionSearch::acquire_evaluator_slot() {
+    lock_guard<mutex> lock(evaluator_slots_mutex);
+    // utils::run_in_parallel runs at most num_threads jobs at the same time.
+    assert(!free_evaluator_slots.empty());
+    int slot = free_evaluator_slots.back();
+    free_evaluator_slots.pop_back();
+    return slot;
 }
 
-void RelaxationExtensionSearch::dump_search_space() const {
-    search_space.dump(task_proxy);
+void RelaxationExtensionSearch::release_evaluator_slot(int slot) {
+    lock_guard<mutex> lock(evaluator_slots_mutex);
+    free_evaluator_slots.push_back(slot);
 }
 
-void RelaxationExtensionSearch::start_f_value_statistics(EvaluationContext &eval_context) {
-    if (f_evaluator) {
-        int f_value = eval_context.get_evaluator_value(f_evaluator.get());
-        statistics.report_f_value_progress(f_value);
-    }
-}
+void RelaxationExtensionSearch::finish_exploration(
+    const RelaxedTaskExploration &exploration) {
+    RelaxedTask *relaxed_task = exploration.get_relaxed_task();
+    const SearchStatistics &task_statistics = exploration.get_statistics();
+    statistics.inc_expanded(task_statistics.get_expanded());
+    statistics.inc_evaluated_states(task_statistics.get_evaluated_states());
+    statistics.inc_evaluations(task_statistics.get_evaluations());
+    statistics.inc_generated(task_statistics.get_generated());
+    statistics.inc_reopened(task_statistics.get_reopened());
+    statistics.inc_dead_ends(task_statistics.get_dead_ends());
+
+    cout << "Task: " << relaxed_task->get_name() << endl;
+    cout << "init #MSGS: " << relaxed_task->get_msgs().size() << endl;
+    cout << "stay in frontier #states: " << relaxed_task->get_frontier_size() << endl;
+    cout << "Next Iteration init #states: " << exploration.get_num_init_states() << endl;
+
+    // update MSGS of finished iteration
+    relaxed_task->add_msgs(exploration.get_msgs());
+    relaxed_task->set_num_expanded_states(task_statistics.get_expanded());
+    relaxed_task->set_solvable(exploration.is_solved());
+    relaxed_task->set_finished(true);
+
+    relaxed_task->print();
+    statistics.print_detailed_statistics();
 
-/* TODO: HACK! This is very inefficient for simply looking up an h value.
-   Also, if h values are not saved it would recompute h for each and every state. */
-void RelaxationExtensionSearch::update_f_value_statistics(EvaluationContext &eval_context) {
-    if (f_evaluator) {
-        int f_value = eval_context.get_evaluator_value(f_evaluator.get());
-        statistics.report_f_value_progress(f_value);
+    relaxed_task->propagate_solvable();
+    for (RelaxedTask *t : relaxed_task->get_lower_cover()) {
+        t->clear();
     }
+    cout << "##############################################################################" << endl;
 }
 
+SearchStatus RelaxationExtensionSearch::step() {
+    vector<RelaxedTask *> ready_tasks = taskRelaxationTracker->get_ready_tasks();
+    if (ready_tasks.empty()) {
+        std::cout << "no more relaxed tasks" << std::endl;
+        return SearchStatus::FAILED;
+    }
+    if (log.is_at_least_verbose()) {
+        log << "Exploring " << ready_tasks.size()
+            << " incomparable relaxed tasks:";
+        for (RelaxedTask *relaxed_task : ready_tasks)
+            log << " " << relaxed_task->get_name();
+        log << endl;
+    }
 
-bool RelaxationExtensionSearch::next_relaxed_task() {
-
-    while(true){
-
-        // update MSGS of finished iteration
-        relaxedTask->add_msgs(current_msgs);
-
-        relaxedTask->set_num_expanded_states(statistics.get_expanded() - expanded_states_up_to_prev_task);
-        expanded_states_up_to_prev_task = statistics.get_expanded();
-
-        relaxedTask->print();
-        statistics.print_detailed_statistics();
-
-        relaxedTask->propagate_solvable();
-
-        cout << "##############################################################################" << endl;
-        cout << "##############################################################################" << endl;
-        if (! taskRelaxationTracker->has_next_relaxed_task()){
-            return false;
-        }
-
-        // clear call stack to start with a new set of initial states
-        cout << "clear openlist and search space" << endl;
-        open_list->clear();
-        search_space.clear();
-
-        relaxedTask = taskRelaxationTracker->next_relaxed_task();
-        cout << "Current task: " << relaxedTask->get_name() << endl;
-
-        // init with MSGS from lower cover
-        for (RelaxedTask* t : relaxedTask->get_lower_cover()){
-            relaxedTask->add_msgs(t->get_msgs());
-        }
+    // Each thread only logs if it is the calling thread.
+    utils::LogProxy exploration_log = (num_threads == 1) ? log : utils::get_silent_log();
+    vector<unique_ptr<RelaxedTaskExploration>> explorations;
+    for (RelaxedTask *relaxed_task : ready_tasks) {
+        explorations.push_back(utils::make_unique_ptr<RelaxedTaskExploration>(
+                                   *this, relaxed_task, exploration_log));
+    }
 
-        current_msgs = relaxedTask->get_msgs();
-        cout << "init #MSGS: " << relaxedTask->get_msgs().size() << endl;
-
-
-
-        std::cout << "ITERATIVE EXPANSION OF STATE SPACE: continue with frontier states" << std::endl;
-
-        //Get frontier states from lower cover
-        int num_init_states = 0;
-        bool something_to_explored = false;
-        vector<RelaxedTask*> lower_cover = relaxedTask->get_lower_cover();
-        for (int i = 0; i < (int) lower_cover.size(); i++){
-            RelaxedTask* t = lower_cover[i];
-            cout << "Task: " << t->get_name() << endl;
-            for(FrontierElem f_elem :  t->get_frontier()){
-                OperatorProxy op = task_proxy.get_operators()[f_elem.op];
-                if (relaxedTask->applicable(op)){
-                    State parent = state_registry.lookup_state(f_elem.parent);
-                    SearchNode parent_node = search_space.get_node(parent);
-                    something_to_explored |= decide_to_put_into_openlist(parent_node, parent, f_elem.op);
-                    // cout << "Something to explore: " << something_to_explored << endl;
-                    num_init_states++;
-                }
-                else{
-                    relaxedTask->add_to_frontier(f_elem);
-                } 
-            }
-            t->clear();
+    utils::run_in_parallel(
+        explorations.size(), num_threads,
+        [this, &explorations](int i) {
+            int slot = acquire_evaluator_slot();
+            explorations[i]->run(*open_lists[slot], *evals[slot]);
+            release_evaluator_slot(slot);
+        });
+
+    bool solved = false;
+    bool timed_out = false;
+    for (const unique_ptr<RelaxedTaskExploration> &exploration : explorations) {
+        if (exploration->is_timed_out()) {
+            timed_out = true;
+            continue;
         }
+        solved |= exploration->is_solved();
+        finish_exploration(*exploration);
+    }
+    if (timed_out) {
+        return SearchStatus::TIMEOUT;
+    }
 
-        std::cout << "stay in frontier #states: " << relaxedTask->get_frontier_size() << std::endl;
-        std::cout << "Next Iteration init #states: " << num_init_states << std::endl;
-
-
-        if (something_to_explored){
-            break;
+    if (!taskRelaxationTracker->has_next_relaxed_task()) {
+        if (solved) {
+            return SearchStatus::SOLVED;
         }
+        std::cout << "no more relaxed tasks" << std::endl;
+        return SearchStatus::FAILED;
     }
-    return true;
+    return SearchStatus::IN_PROGRESS;
+}
+
+void RelaxationExtensionSearch::print_statistics() const {
+    statistics.print_detailed_statistics();
+    // taskRelaxationTracker->results_to_file();
 }
 
 void add_options_to_parser(OptionParser &parser) {
@@ -369,26 +423,49 @@ static shared_ptr<SearchEngine> _parse(OptionParser &parser) {
     parser.document_synopsis(
         "Greedy branch and bound",
         "We break ties using the evaluator. Closed nodes are re-opened.");
-
-    parser.add_option<shared_ptr<Evaluator>>("eval", "evaluator for pruning");
-    parser.add_list_option<shared_ptr<Evaluator>>("evals", "evaluators");
-    parser.add_list_option<shared_ptr<Evaluator>>("preferred",
+    parser.document_note(
+        "Parallel exploration",
+        "Relaxed tasks whose lower covers are finished are incomparable in "
+        "the lattice and are explored concurrently on up to num_threads "
+        "threads, each with its own state registry. The evaluators are "
+        "parsed once per thread, so do not use predefined evaluators with "
+        "num_threads > 1 since they would be shared between threads. "
+        "Axioms and telemetry are only supported with one thread.");
+
+    parser.add_option<ParseTree>("eval", "evaluator for pruning (parsed once per thread)");
+    parser.add_list_option<ParseTree>("evals", "evaluators (parsed once per thread)");
+    parser.add_list_option<ParseTree>("preferred",
         "use preferred operators of these evaluators", "[]");
     parser.add_option<int>("boost",
         "boost value for preferred operator open lists", "0");
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads for exploring incomparable relaxed tasks",
+        "1", Bounds("1", "infinity"));
 
     relaxation_extension_search::add_options_to_parser(parser);
     Options opts = parser.parse();
-    opts.verify_list_non_empty<shared_ptr<Evaluator>>("evals");
-
-    shared_ptr<relaxation_extension_search::RelaxationExtensionSearch> engine;
-    if (!parser.dry_run()) {
-        opts.set("open", search_common::create_greedy_open_list_factory(opts));
+    opts.verify_list_non_empty<ParseTree>("evals");
+
+    if (parser.help_mode()) {
+        return nullptr;
+    } else if (parser.dry_run()) {
+        // Check that the evaluators can be parsed.
+        vector<ParseTree> trees = opts.get_list<ParseTree>("evals");
+        vector<ParseTree> preferred = opts.get_list<ParseTree>("preferred");
+        trees.insert(trees.end(), preferred.begin(), preferred.end());
+        trees.push_back(opts.get<ParseTree>("eval"));
+        for (const ParseTree &tree : trees) {
+            OptionParser test_parser(tree, parser.get_registry(),
+                                     parser.get_predefinitions(), true);
+            test_parser.start_parsing<shared_ptr<Evaluator>>();
+        }
+        return nullptr;
+    } else {
         opts.set("reopen_closed", true);
-        engine = make_shared<RelaxationExtensionSearch>(opts);
+        return make_shared<RelaxationExtensionSearch>(
+            opts, parser.get_registry(), parser.get_predefinitions());
     }
-
-    return engine;
 }
 
 static Plugin<SearchEngine> _plugin("astar_relaxations", _parse);
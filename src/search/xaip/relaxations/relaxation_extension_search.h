@@ -2,59 +2,147 @@
 #define SEARCH_ENGINES_RELAXATION_EXTENSION_SEARCH_H
 
 #include "../../open_list.h"
+#include "../../option_parser_util.h"
 #include "../../search_engine.h"
 
+#include "../../utils/countdown_timer.h"
+
 #include "relaxed_task.h"
 #include "task_relaxation_tracker.h"
 
 #include <memory>
+#include <mutex>
+#include <unordered_set>
 #include <vector>
 
 class Evaluator;
-class PruningMethod;
 
 namespace options {
 class OptionParser;
 class Options;
+class Predefinitions;
+class Registry;
 }
 
 namespace relaxation_extension_search {
-class RelaxationExtensionSearch : public SearchEngine {
-    const bool reopen_closed_nodes;
+class RelaxationExtensionSearch;
+
+/*
+  Exploration of a single relaxed task, starting from the initial state or
+  from the frontiers of its lower covers. Each exploration has its own state
+  registry, search space, MSGS and statistics, and only adds elements to the
+  frontier of its own relaxed task, so that incomparable relaxed tasks can
+  be explored on different threads.
+*/
+class RelaxedTaskExploration {
+    RelaxationExtensionSearch &engine;
+    RelaxedTask *relaxed_task;
+    // Frontiers of the lower covers (empty for tasks without lower covers).
+    std::vector<const std::unordered_set<FrontierElem, HashFrontierElem> *> lower_frontiers;
+    StateRegistry state_registry;
+    utils::LogProxy log;
+    SearchSpace search_space;
+    SearchProgress search_progress;
+    SearchStatistics statistics;
+    MSGSCollection current_msgs;
 
-    std::unique_ptr<StateOpenList> open_list;
-    std::shared_ptr<Evaluator> f_evaluator;
+    StateOpenList *open_list;
+    Evaluator *eval;
 
-    std::shared_ptr<Evaluator> eval;
+    int num_init_states;
+    bool solved;
+    bool timed_out;
 
-    std::shared_ptr<PruningMethod> pruning_method;
+    void initialize();
+    void expand(const State &state);
+    bool decide_to_put_into_openlist(const SearchNode &node, const State &state, OperatorID op);
+    // Same as above for an already generated successor state within the bound.
+    bool decide_to_put_into_openlist(const SearchNode &node, OperatorID op, const State &succ_state);
 
-    MSGSCollection current_msgs;
+public:
+    /*
+      Must be created in the main thread because the state registry looks up
+      the state packer and axiom evaluator of the task. The frontiers of the
+      lower covers are accessed here, too, so that the access counters used
+      by RelaxedTask::clear() are not modified concurrently.
+    */
+    RelaxedTaskExploration(
+        RelaxationExtensionSearch &engine, RelaxedTask *relaxed_task,
+        const utils::LogProxy &log);
+
+    /*
+      Explore the relaxed task with the given open list and pruning
+      evaluator until a goal state is expanded, the open list is empty or
+      the time limit is reached. The open list is empty afterwards.
+    */
+    void run(StateOpenList &open_list, Evaluator &eval);
+
+    RelaxedTask *get_relaxed_task() const {
+        return relaxed_task;
+    }
+    const MSGSCollection &get_msgs() const {
+        return current_msgs;
+    }
+    const SearchStatistics &get_statistics() const {
+        return statistics;
+    }
+    int get_num_init_states() const {
+        return num_init_states;
+    }
+    bool is_solved() const {
+        return solved;
+    }
+    bool is_timed_out() const {
+        return timed_out;
+    }
+};
+
+/*
+  Explores the relaxed tasks of the lattice in waves. Each wave consists of
+  all unsolved relaxed tasks whose lower covers are finished. These tasks
+  are incomparable in the lattice and are explored concurrently on up to
+  num_threads threads, each task seeded with the frontiers of its lower
+  covers (or with the initial state if it has none). After each wave, the
+  MSGS and solvability of the explored tasks are propagated up the cover
+  relation and the frontiers that were used by all upper covers are freed.
+
+  Instead of one shared state registry, each exploration uses its own
+  registry and search space (as in HDASearch), and frontier elements store
+  their parent states by value. The open lists and pruning evaluators are
+  parsed once per thread, so that no evaluator object is used by two
+  threads at the same time.
+*/
+class RelaxationExtensionSearch : public SearchEngine {
+    friend class RelaxedTaskExploration;
+
+    const bool reopen_closed_nodes;
+    const int num_threads;
 
-    TaskRelaxationTracker* taskRelaxationTracker;
-    RelaxedTask* relaxedTask;
-    std::vector<StateID> pending_initial_states;
+    // Open list and pruning evaluator for each thread.
+    std::vector<std::unique_ptr<StateOpenList>> open_lists;
+    std::vector<std::shared_ptr<Evaluator>> evals;
+    // Indices into open_lists and evals that are not used by a thread.
+    std::vector<int> free_evaluator_slots;
+    std::mutex evaluator_slots_mutex;
 
-    int expanded_states_up_to_prev_task = 0;
+    TaskRelaxationTracker *taskRelaxationTracker;
+    std::unique_ptr<utils::CountdownTimer> timer;
 
-    void start_f_value_statistics(EvaluationContext &eval_context);
-    void update_f_value_statistics(EvaluationContext &eval_context);
-    void reward_progress();
+    int acquire_evaluator_slot();
+    void release_evaluator_slot(int slot);
+    void finish_exploration(const RelaxedTaskExploration &exploration);
 
 protected:
     virtual void initialize() override;
     virtual SearchStatus step() override;
-    void expand(const State &state);
-    bool next_relaxed_task();
-    bool decide_to_put_into_openlist(const SearchNode &node, const State &state, OperatorID op);
 
 public:
-    explicit RelaxationExtensionSearch(const options::Options &opts);
+    RelaxationExtensionSearch(
+        const options::Options &opts, options::Registry &registry,
+        const options::Predefinitions &predefinitions);
     virtual ~RelaxationExtensionSearch() = default;
 
     virtual void print_statistics() const override;
-
-    void dump_search_space() const;
 };
 
 extern void add_options_to_parser(options::OptionParser &parser);
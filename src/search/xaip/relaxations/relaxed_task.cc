@@ -1,5 +1,7 @@
 #include "relaxed_task.h"
 
+#include <sstream>
+
 using namespace std;
 
 RelaxedTask::RelaxedTask(std::shared_ptr<AbstractTask> task, int id, string name, 
@@ -19,23 +21,38 @@ void RelaxedTask::clear(){
     }
 }
 
-bool RelaxedTask::applicable(const OperatorProxy &op){
-    for (ApplicableActionDefinition ap : this->applicable_actions){
-        string name = op.get_name();
-        char* char_array = new char[name.length() + 1]; 
-        strcpy(char_array, name.c_str()); 
-        char * p;
-        p = strtok(char_array, " "); 
+void RelaxedTask::add_to_frontier(const FrontierElem &elem){
+    auto it = frontier.find(elem);
+    if (it == frontier.end()){
+        frontier.insert(elem);
+    } else if (elem.parent_g < it->parent_g){
+        // The parent was reopened with a cheaper path.
+        frontier.erase(it);
+        frontier.insert(elem);
+    }
+}
+
+bool RelaxedTask::is_ready(){
+    for (RelaxedTask* rtc : lower_cover){
+        if (!rtc->get_finished() && !rtc->get_solvable()){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RelaxedTask::applicable(const OperatorProxy &op) const {
+    // Tasks are explored on several threads, so we cannot use strtok here.
+    string name = op.get_name();
+    for (const ApplicableActionDefinition &ap : this->applicable_actions){
+        istringstream tokens(name);
+        string p;
+        tokens >> p;
         if(p != ap.name){
             continue;
         }
         uint index = 0;
-        p = strtok(NULL, " ");
-        while (p != NULL) {
-            // cout << "Next " << p << endl;
-            // if(index < ap.params.size()){
-            //     cout << "Param: " + ap.params[index] << endl;
-            // }
+        while (tokens >> p) {
             if(index < ap.params.size() && ap.params[index] != "*"){
                 if(ap.params[index] != p){
                     return true;
@@ -43,27 +60,12 @@ bool RelaxedTask::applicable(const OperatorProxy &op){
             }
             if(index == ap.param_id){
                 uint x;
-                sscanf(p+5, "%u", &x);
-                // cout << op.get_name() << endl;
-                // cout << "Time: " << x << endl;
-                // cout << "lower: " << ap.lower_bound << "   upper: " << ap.upper_bound << endl;
+                sscanf(p.c_str() + 5, "%u", &x);
                 if (x < ap.lower_bound || x > ap.upper_bound){
-                    // cout << "-----------------------------------" << endl;
-                    // cout << op.get_name() << endl;
-                    // cout << "Time: " << x << endl;
-                    // cout << "lower: " << ap.lower_bound << "   upper: " << ap.upper_bound << endl;
-                    // cout << "---> not in bound " << endl;
                     return false;
                 }
-                else{
-                    // cout << "-----------------------------------" << endl;
-                    // cout << op.get_name() << endl;
-                    // cout << "Time: " << x << endl;
-                    // cout << "lower: " << ap.lower_bound << "   upper: " << ap.upper_bound << endl;
-                }
             }
             index++;
-            p = strtok(NULL, " ");
         }
         return true;
     }
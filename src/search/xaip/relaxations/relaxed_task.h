@@ -22,6 +22,7 @@ private:
     std::unordered_set<FrontierElem, HashFrontierElem> frontier;
     MSGSCollection msgs_collection;
     bool solvable = false;
+    bool finished = false;
     int expanded_states = 0;
     uint num_accessed_frontier = 0;
 public:
@@ -39,12 +40,12 @@ public:
     std::vector<RelaxedTask*> get_upper_cover(){return upper_cover;}
     void add_to_upper_cover(RelaxedTask* task){upper_cover.push_back(task);}
 
-    std::unordered_set<FrontierElem, HashFrontierElem> get_frontier(){
+    const std::unordered_set<FrontierElem, HashFrontierElem> &get_frontier(){
         num_accessed_frontier++; 
         return frontier;
     }
     uint get_frontier_size(){return frontier.size();}
-    void add_to_frontier(FrontierElem elem){frontier.insert(elem);}
+    void add_to_frontier(const FrontierElem &elem);
 
     void set_num_expanded_states(int num) {this->expanded_states = num;}
     int get_num_expanded_states() {return this->expanded_states;}
@@ -58,7 +59,12 @@ public:
     void set_solvable(bool s){solvable = s;}
     bool get_solvable(){return solvable;}
 
-    bool applicable(const OperatorProxy &op);
+    void set_finished(bool f){finished = f;}
+    bool get_finished(){return finished;}
+    // All lower covers are finished, so the frontier can be resumed.
+    bool is_ready();
+
+    bool applicable(const OperatorProxy &op) const;
     void propagate_solvable(MSGSCollection goal_subsets);
     void propagate_solvable();
     void clear();
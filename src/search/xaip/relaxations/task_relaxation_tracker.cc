@@ -30,8 +30,9 @@ TaskRelaxationTracker::TaskRelaxationTracker(const std::shared_ptr<AbstractTask>
 
 bool TaskRelaxationTracker::has_next_relaxed_task(){
     int num_not_solvable = 0;
-    for (int i = current_index + 1; i < (int) relaxed_tasks.size(); i++){
-        if (! relaxed_tasks[i]->get_solvable())
+    for (int i = 0; i < (int) relaxed_tasks.size(); i++){
+        if (i != current_index && ! relaxed_tasks[i]->get_finished() &&
+            ! relaxed_tasks[i]->get_solvable())
             num_not_solvable++;
     }
 //    cout << "Num unsolved tasks: " << num_not_solvable << endl;
@@ -39,14 +40,47 @@ bool TaskRelaxationTracker::has_next_relaxed_task(){
 }
 
 RelaxedTask* TaskRelaxationTracker::next_relaxed_task(){
-    current_index++;
-    for (;current_index < (int) relaxed_tasks.size(); current_index++){
-        if (! relaxed_tasks[current_index]->get_solvable())
-            return relaxed_tasks[current_index];
+    if (current_index >= 0 && current_index < (int) relaxed_tasks.size()){
+        relaxed_tasks[current_index]->set_finished(true);
     }
+    int fallback_index = -1;
+    for (int i = 0; i < (int) relaxed_tasks.size(); i++){
+        RelaxedTask* rt = relaxed_tasks[i];
+        if (rt->get_finished() || rt->get_solvable())
+            continue;
+        if (rt->is_ready()){
+            current_index = i;
+            return rt;
+        }
+        if (fallback_index == -1)
+            fallback_index = i;
+    }
+    // Only possible if the cover relation is cyclic.
+    if (fallback_index != -1){
+        current_index = fallback_index;
+        return relaxed_tasks[current_index];
+    }
+    current_index = relaxed_tasks.size();
     return NULL;
 }
 
+std::vector<RelaxedTask*> TaskRelaxationTracker::get_ready_tasks(){
+    vector<RelaxedTask*> ready_tasks;
+    RelaxedTask* fallback = NULL;
+    for (RelaxedTask* rt : relaxed_tasks){
+        if (rt->get_finished() || rt->get_solvable())
+            continue;
+        if (rt->is_ready())
+            ready_tasks.push_back(rt);
+        else if (!fallback)
+            fallback = rt;
+    }
+    // Only possible if the cover relation is cyclic.
+    if (ready_tasks.empty() && fallback)
+        ready_tasks.push_back(fallback);
+    return ready_tasks;
+}
+
 RelaxedTask* TaskRelaxationTracker::current_relaxed_task(){
     return relaxed_tasks[current_index];
 }
@@ -26,7 +26,19 @@ public:
 
     std::vector<RelaxedTask*> get_relaxed_tasks() const {return relaxed_tasks;}
     bool has_next_relaxed_task();
+    /*
+      Mark the current relaxed task as finished and return the next
+      unsolved task all of whose lower covers are finished. Tasks are
+      thus explored lattice layer by lattice layer, and a task is only
+      started once the frontiers and MSGS of all its lower covers exist.
+    */
     RelaxedTask* next_relaxed_task();
+    /*
+      Return all unfinished and unsolved tasks whose lower covers are
+      finished. They are incomparable in the lattice and can be explored
+      concurrently.
+    */
+    std::vector<RelaxedTask*> get_ready_tasks();
     RelaxedTask* current_relaxed_task();
     void results_to_file();
 };